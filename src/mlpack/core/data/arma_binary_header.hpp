@@ -0,0 +1,78 @@
+/**
+ * @file arma_binary_header.hpp
+ * @author Ryan Curtin
+ *
+ * Generate the header that Armadillo expects at the start of a file in its
+ * binary format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ARMA_BINARY_HEADER_HPP
+#define MLPACK_CORE_DATA_ARMA_BINARY_HEADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <complex>
+#include <iomanip>
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+
+//! The kind of element stored in an Armadillo binary file, for any type that
+//! is not complex.
+template<typename eT>
+struct ArmaBinaryElementKind
+{
+  static std::string Kind()
+  {
+    // Armadillo only supports integers of 8, 16, 32 and 64 bits; plain char
+    // and bool are not accepted.
+    if (std::is_integral<eT>::value && !std::is_same<eT, bool>::value &&
+        !std::is_same<eT, char>::value)
+      return std::is_signed<eT>::value ? "IS" : "IU";
+    else if (std::is_same<eT, float>::value || std::is_same<eT, double>::value)
+      return "FN";
+    else
+      return "";
+  }
+};
+
+//! The kind of element stored in an Armadillo binary file, for complex types.
+template<typename T>
+struct ArmaBinaryElementKind<std::complex<T>>
+{
+  static std::string Kind()
+  {
+    return (std::is_same<T, float>::value || std::is_same<T, double>::value) ?
+        "FC" : "";
+  }
+};
+
+/**
+ * Return the header that Armadillo writes at the start of a binary file
+ * holding a matrix with elements of type eT, such as "ARMA_MAT_BIN_FN008" for
+ * doubles.  The header is built in the same way that Armadillo builds it: the
+ * kind of element, followed by its size in bytes.  An empty string is returned
+ * for element types that Armadillo can't store.
+ */
+template<typename eT>
+std::string ArmaBinaryHeader()
+{
+  const std::string kind = ArmaBinaryElementKind<eT>::Kind();
+  if (kind.empty())
+    return "";
+
+  std::ostringstream header;
+  header << "ARMA_MAT_BIN_" << kind << std::setw(3) << std::setfill('0')
+      << sizeof(eT);
+  return header.str();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "mapped_matrix.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices and models. */ {
@@ -159,6 +160,41 @@ bool Load(const std::string& filename,
           arma::Row<eT>& rowvec,
           const bool fatal = false);
 
+/**
+ * Load a matrix from a binary file by mapping the file into memory, so that the
+ * matrix aliases the pages of the file instead of holding a copy of the data.
+ * This allows very large datasets to be loaded quickly and without requiring
+ * twice the memory; see MappedMatrix for more details.
+ *
+ * Only Armadillo binary (arma_binary) and raw binary (raw_binary) files, both
+ * denoted by .bin, can be mapped.  Because the data can't be transposed without
+ * copying it, the file must hold the matrix in column-major order with one
+ * point per column, like files saved with data::Save(filename, matrix, fatal,
+ * false).  Raw binary files don't store the size of the matrix, so the number
+ * of rows must be given with the rawRows parameter.
+ *
+ * If a file can't be mapped (for instance because its data is not aligned, or
+ * because memory-mapped files are not supported on this system), it is loaded
+ * into memory as usual, without transposing it.  Armadillo binary files
+ * written by data::Save() are always suitably aligned.
+ * Other file types are loaded with the regular Load() function, and are
+ * transposed.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix MappedMatrix to load the contents of the file into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param rawRows Number of rows of the matrix stored in a raw binary file.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal = false,
+          const size_t rawRows = 1);
+
 /**
  * Loads a matrix from a file, guessing the filetype from the extension and
  * mapping categorical features with a DatasetMapper object.  This will
@@ -272,5 +308,7 @@ bool Load(const std::string& filename,
 #include "load_model_impl.hpp"
 // Include implementation of Load() for vectors.
 #include "load_vec_impl.hpp"
+// Include implementation of Load() for memory-mapped matrices.
+#include "load_mapped_impl.hpp"
 
 #endif
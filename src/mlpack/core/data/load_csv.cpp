@@ -1,5 +1,7 @@
 #include "load_csv.hpp"
 
+#include <algorithm>
+
 using namespace boost::spirit;
 
 namespace mlpack {
@@ -58,5 +60,87 @@ void LoadCSV::CheckOpen()
   inFile.unsetf(std::ios::skipws);
 }
 
+void LoadCSV::ChunkFile(std::vector<size_t>& chunkStart,
+                        std::vector<size_t>& chunkLines)
+{
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  stream.seekg(0, std::ios::end);
+  const size_t fileSize = (size_t) stream.tellg();
+
+  // Use a few chunks per thread, so that the work stays balanced if the lines
+  // have different lengths; but don't bother splitting small files.
+  size_t numChunks = 1;
+#ifdef HAS_OPENMP
+  numChunks = 4 * omp_get_max_threads();
+#endif
+  const size_t minChunkSize = 1 << 20;
+  numChunks = std::max((size_t) 1, std::min(numChunks,
+      fileSize / minChunkSize));
+
+  // Each chunk starts at the beginning of the line that follows its
+  // approximate boundary.
+  chunkStart.clear();
+  chunkStart.push_back(0);
+  for (size_t i = 1; i < numChunks; ++i)
+  {
+    const size_t approximateStart = i * fileSize / numChunks;
+    if (approximateStart <= chunkStart.back())
+      continue;
+
+    // Look for the end of the line that contains the byte before the
+    // approximate start.
+    size_t pos = approximateStart - 1;
+    stream.clear();
+    stream.seekg(pos);
+    char c;
+    while (stream.get(c) && c != '\n')
+      ++pos;
+
+    if (!stream || pos + 1 >= fileSize)
+      break;
+
+    chunkStart.push_back(pos + 1);
+  }
+
+  // Now count the lines of each chunk.
+  numChunks = chunkStart.size();
+  chunkLines.assign(numChunks, 0);
+
+  // On the Visual Studio compiler, we have to use intmax_t because size_t is
+  // not yet supported by their OpenMP implementation.
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t i = 0; i < (intmax_t) numChunks; ++i)
+  #else
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < numChunks; ++i)
+  #endif
+  {
+    const size_t end = (i + 1 < numChunks) ? chunkStart[i + 1] : fileSize;
+    size_t remaining = end - chunkStart[i];
+
+    std::ifstream chunkStream(filename.c_str(), std::ios::in |
+        std::ios::binary);
+    chunkStream.seekg(chunkStart[i]);
+
+    std::vector<char> buffer(std::min(remaining, minChunkSize));
+    char last = '\n';
+    while (remaining > 0)
+    {
+      const size_t toRead = std::min(remaining, buffer.size());
+      chunkStream.read(buffer.data(), toRead);
+
+      chunkLines[i] += std::count(buffer.begin(), buffer.begin() + toRead,
+          '\n');
+      last = buffer[toRead - 1];
+      remaining -= toRead;
+    }
+
+    // The last line of the file may not end with a newline.
+    if (last != '\n')
+      ++chunkLines[i];
+  }
+}
+
 } // namespace data
 } // namespace mlpack
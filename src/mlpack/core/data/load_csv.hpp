@@ -58,10 +58,7 @@ class LoadCSV
   {
     CheckOpen();
 
-    if (transpose)
-      TransposeParse(inout, infoSet);
-    else
-      NonTransposeParse(inout, infoSet);
+    Parse(inout, infoSet, transpose);
   }
 
   /**
@@ -213,6 +210,260 @@ private:
    */
   void CheckOpen();
 
+  /**
+   * Split the file into chunks of whole lines that can be parsed
+   * independently, and count the lines in each chunk (in parallel).
+   *
+   * @param chunkStart Vector to be filled with the byte offset at which each
+   *     chunk starts.
+   * @param chunkLines Vector to be filled with the number of lines in each
+   *     chunk.
+   */
+  void ChunkFile(std::vector<size_t>& chunkStart,
+                 std::vector<size_t>& chunkLines);
+
+  /**
+   * Parse the given lines of the file, and call the given function on each
+   * token with the signature f(std::string&& token, const size_t line,
+   * const size_t index).  The chunk is read with its own stream, so that
+   * different chunks can be parsed in parallel.  This doesn't throw; instead,
+   * an error message is returned.
+   *
+   * @param start Byte offset of the first line to parse.
+   * @param numLines Number of lines to parse.
+   * @param firstLine Index of the first line to parse in the file.
+   * @param lineTokens Number of tokens that each line should hold.
+   * @param f Function to call on each token.
+   * @return An error message, or an empty string if the lines were parsed
+   *     successfully.
+   */
+  template<typename TokenFunction>
+  std::string ParseChunk(const size_t start,
+                         const size_t numLines,
+                         const size_t firstLine,
+                         const size_t lineTokens,
+                         TokenFunction& f)
+  {
+    using namespace boost::spirit;
+
+    std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+    stream.seekg(start);
+
+    std::string line;
+    for (size_t l = 0; l < numLines; ++l)
+    {
+      if (!std::getline(stream, line))
+      {
+        std::ostringstream oss;
+        oss << "LoadCSV::Parse(): error reading line " << (firstLine + l)
+            << " of '" << filename << "'!";
+        return oss.str();
+      }
+
+      // Remove whitespace from either side.
+      boost::trim(line);
+
+      // Extra tokens are only counted; the line is rejected below.
+      size_t index = 0;
+      auto parseToken = [&](iter_type const &iter)
+      {
+        if (index < lineTokens)
+        {
+          std::string str(iter.begin(), iter.end());
+          boost::trim(str);
+
+          f(std::move(str), firstLine + l, index);
+        }
+        ++index;
+      };
+
+      const bool canParse = qi::parse(line.begin(), line.end(),
+          stringRule[parseToken] % delimiterRule);
+
+      // Make sure we got the right number of values.
+      if (index != lineTokens)
+      {
+        std::ostringstream oss;
+        oss << "LoadCSV::Parse(): wrong number of values (" << index
+            << ") on line " << (firstLine + l) << "; should be " << lineTokens
+            << " values.";
+        return oss.str();
+      }
+
+      if (!canParse)
+      {
+        std::ostringstream oss;
+        oss << "LoadCSV::Parse(): parsing error on line " << (firstLine + l)
+            << "!";
+        return oss.str();
+      }
+    }
+
+    return std::string();
+  }
+
+  /**
+   * Parse the file with the given DatasetMapper.  For general policies, this
+   * uses the sequential parsers below.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper object to load with.
+   * @param transpose If true, the matrix should be transposed on loading.
+   */
+  template<typename T, typename PolicyType>
+  void Parse(arma::Mat<T>& inout,
+             DatasetMapper<PolicyType>& infoSet,
+             const bool transpose)
+  {
+    if (transpose)
+      TransposeParse(inout, infoSet);
+    else
+      NonTransposeParse(inout, infoSet);
+  }
+
+  /**
+   * Parse the file with IncrementPolicy, in parallel.  The file is split into
+   * chunks of whole lines, which are parsed by separate threads directly into
+   * the matrix.  IncrementPolicy only modifies its mappings for categorical
+   * dimensions, so numeric values can be converted in any order.  The values
+   * of categorical dimensions are collected, and mapped afterwards in the
+   * order in which they appear in the file; so, the result is the same as with
+   * the sequential parsers.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper object to load with.
+   * @param transpose If true, the matrix should be transposed on loading.
+   */
+  template<typename T>
+  void Parse(arma::Mat<T>& inout,
+             DatasetMapper<IncrementPolicy>& infoSet,
+             const bool transpose)
+  {
+    using namespace boost::spirit;
+
+    // Split the file, and find the index of the first line of each chunk.
+    std::vector<size_t> chunkStart, chunkLines;
+    ChunkFile(chunkStart, chunkLines);
+    const size_t numChunks = chunkStart.size();
+
+    std::vector<size_t> firstLine(numChunks + 1, 0);
+    for (size_t i = 0; i < numChunks; ++i)
+      firstLine[i + 1] = firstLine[i] + chunkLines[i];
+    const size_t numLines = firstLine[numChunks];
+
+    // The first line tells us how many values each line holds.
+    size_t lineTokens = 0;
+    std::string line;
+    inFile.clear();
+    inFile.seekg(0, std::ios::beg);
+    if (std::getline(inFile, line))
+    {
+      boost::trim(line);
+      auto countTokens = [&lineTokens](iter_type) { ++lineTokens; };
+      qi::parse(line.begin(), line.end(),
+          stringRule[countTokens] % delimiterRule);
+    }
+
+    const size_t rows = transpose ? lineTokens : numLines;
+    const size_t cols = transpose ? numLines : lineTokens;
+    infoSet = DatasetMapper<IncrementPolicy>(rows);
+
+    // Errors are collected per chunk, since exceptions can't leave an OpenMP
+    // region; the first error in the file is thrown.
+    std::vector<std::string> errors(numChunks);
+    auto checkErrors = [&errors]()
+    {
+      for (size_t i = 0; i < errors.size(); ++i)
+        if (!errors[i].empty())
+          throw std::runtime_error(errors[i]);
+    };
+
+    // First, find the categorical dimensions.  IncrementPolicy only ever marks
+    // dimensions as categorical, so each thread can work with its own copy of
+    // the types, and the copies are merged afterwards.
+    #pragma omp parallel
+    {
+      IncrementPolicy policy;
+      std::vector<Datatype> types(rows, Datatype::numeric);
+
+      auto firstPass = [&](std::string&& str,
+                           const size_t lineIndex,
+                           const size_t index)
+      {
+        policy.template MapFirstPass<T>(str, transpose ? index : lineIndex,
+            types);
+      };
+
+      // On the Visual Studio compiler, we have to use intmax_t because size_t
+      // is not yet supported by their OpenMP implementation.
+      #ifdef _WIN32
+      #pragma omp for schedule(dynamic)
+      for (intmax_t i = 0; i < (intmax_t) numChunks; ++i)
+      #else
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < numChunks; ++i)
+      #endif
+      {
+        errors[i] = ParseChunk(chunkStart[i], chunkLines[i], firstLine[i],
+            lineTokens, firstPass);
+      }
+
+      #pragma omp critical (LoadCSVFirstPass)
+      {
+        for (size_t d = 0; d < rows; ++d)
+          if (types[d] == Datatype::categorical)
+            infoSet.Type(d) = Datatype::categorical;
+      }
+    }
+    checkErrors();
+
+    // Now convert the values.  Mapping a value of a numeric dimension doesn't
+    // modify infoSet, so that can be done by any thread.  Values of
+    // categorical dimensions are stored (with their position in the matrix)
+    // until all chunks are parsed.
+    inout.set_size(rows, cols);
+    std::vector<std::vector<std::pair<size_t, std::string>>>
+        categorical(numChunks);
+
+    #ifdef _WIN32
+    #pragma omp parallel for schedule(dynamic)
+    for (intmax_t i = 0; i < (intmax_t) numChunks; ++i)
+    #else
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < numChunks; ++i)
+    #endif
+    {
+      auto convert = [&](std::string&& str,
+                         const size_t lineIndex,
+                         const size_t index)
+      {
+        const size_t row = transpose ? index : lineIndex;
+        const size_t col = transpose ? lineIndex : index;
+
+        if (infoSet.Type(row) == Datatype::numeric)
+          inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
+        else
+          categorical[i].push_back(std::make_pair(col * rows + row,
+              std::move(str)));
+      };
+
+      errors[i] = ParseChunk(chunkStart[i], chunkLines[i], firstLine[i],
+          lineTokens, convert);
+    }
+    checkErrors();
+
+    // Finally, map the categorical values in order.
+    for (size_t i = 0; i < numChunks; ++i)
+    {
+      for (size_t j = 0; j < categorical[i].size(); ++j)
+      {
+        const size_t elem = categorical[i][j].first;
+        inout[elem] = infoSet.template MapString<T>(
+            std::move(categorical[i][j].second), elem % rows);
+      }
+    }
+  }
+
   /**
    * Parse a non-transposed matrix.
    *
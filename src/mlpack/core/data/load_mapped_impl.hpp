@@ -0,0 +1,137 @@
+/**
+ * @file load_mapped_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the Load() overload defined in load.hpp that maps binary
+ * files into memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+#include "extension.hpp"
+#include "arma_binary_header.hpp"
+
+#include <mlpack/core/util/timers.hpp>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal,
+          const size_t rawRows)
+{
+  matrix.Clear();
+
+  // Only binary files can be mapped; everything else is loaded normally.
+  if (Extension(filename) != "bin")
+    return Load(filename, matrix.Matrix(), fatal, true);
+
+  Timer::Start("loading_data");
+
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "'; load failed."
+          << std::endl;
+
+    return false;
+  }
+
+  stream.seekg(0, std::ios::end);
+  const size_t fileSize = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  // Find where the data starts and how large the matrix is.  Armadillo binary
+  // files start with a header and the size of the matrix, like
+  // "ARMA_MAT_BIN_FN008\n10 1000\n", and raw binary files hold only the data.
+  const std::string ARMA_MAT_BIN = "ARMA_MAT_BIN";
+  std::string rawHeader(ARMA_MAT_BIN.length(), '\0');
+  stream.read(&rawHeader[0], std::streamsize(ARMA_MAT_BIN.length()));
+  stream.clear();
+  stream.seekg(0, std::ios::beg);
+
+  std::string stringType;
+  size_t offset, rows, cols;
+  bool valid;
+  if (rawHeader == ARMA_MAT_BIN)
+  {
+    stringType = "Armadillo binary formatted data";
+
+    std::string header;
+    stream >> header >> rows >> cols;
+    stream.get();
+    offset = (size_t) stream.tellg();
+
+    // The element type must match, and the file must hold the whole matrix.
+    valid = !stream.fail() &&
+        (header == ArmaBinaryHeader<eT>()) &&
+        (offset + rows * cols * sizeof(eT) <= fileSize);
+  }
+  else
+  {
+    stringType = "raw binary formatted data";
+
+    offset = 0;
+    rows = rawRows;
+    cols = (rawRows == 0) ? 0 : fileSize / (rawRows * sizeof(eT));
+    valid = (rawRows > 0) && (fileSize == rows * cols * sizeof(eT));
+  }
+  stream.close();
+
+  Log::Info << "Mapping '" << filename << "' as " << stringType << ".  "
+      << std::flush;
+
+  if (valid && matrix.Map(filename, offset, rows, cols))
+  {
+    Log::Info << "Size is " << rows << " x " << cols << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
+  Log::Info << std::endl;
+  Timer::Stop("loading_data");
+
+  // If the matrix couldn't be mapped, we load it into memory instead.  Raw
+  // binary files have to be reshaped to the requested number of rows.
+  Log::Warn << "Cannot map '" << filename << "' into memory; loading it "
+      << "instead." << std::endl;
+  if (rawHeader == ARMA_MAT_BIN)
+    return Load(filename, matrix.Matrix(), fatal, false);
+
+  if (!Load(filename, matrix.Matrix(), fatal, false))
+    return false;
+
+  if (rawRows == 0 || (matrix.Matrix().n_elem % rawRows) != 0)
+  {
+    matrix.Clear();
+    if (fatal)
+      Log::Fatal << "The size of '" << filename << "' is not a multiple of "
+          << rawRows << " elements; load failed." << std::endl;
+    else
+      Log::Warn << "The size of '" << filename << "' is not a multiple of "
+          << rawRows << " elements; load failed." << std::endl;
+
+    return false;
+  }
+
+  matrix.Matrix().reshape(rawRows, matrix.Matrix().n_elem / rawRows);
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
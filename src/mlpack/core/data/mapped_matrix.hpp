@@ -0,0 +1,113 @@
+/**
+ * @file mapped_matrix.hpp
+ * @author Ryan Curtin
+ *
+ * Definition of MappedMatrix, a matrix whose memory may be a memory-mapped
+ * file.  This is used by data::Load() to load large binary datasets without
+ * copying them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MappedMatrix holds an Armadillo matrix that may alias the pages of a
+ * memory-mapped file.  Mapping a file does not read it: pages are only read
+ * from disk when they are accessed, and they can be dropped again by the
+ * operating system since they are backed by the file.  This means that loading
+ * a large dataset neither takes a long time nor requires a second copy of the
+ * data in memory.
+ *
+ * The file is mapped privately: writes to the matrix are allowed, but they are
+ * not written back to the file.  The size of the matrix can't be changed.  If
+ * the file can't be mapped (for instance on Windows), the MappedMatrix simply
+ * holds a regular matrix; IsMapped() can be used to tell the two apart.
+ *
+ * A MappedMatrix can't be copied, since the matrix refers to memory that the
+ * MappedMatrix owns; use Matrix() to get a reference to the matrix, and keep
+ * the MappedMatrix alive for as long as that reference is used.  Use
+ * data::Load() to fill a MappedMatrix:
+ *
+ * @code
+ * data::MappedMatrix<double> reference;
+ * data::Load("reference.bin", reference, true);
+ * const arma::mat& dataset = reference.Matrix();
+ * @endcode
+ *
+ * @tparam eT Type of the elements of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  /**
+   * Create an empty MappedMatrix that does not map any file.
+   */
+  MappedMatrix();
+
+  /**
+   * Release the mapping, if any.
+   */
+  ~MappedMatrix();
+
+  /**
+   * Map the given file, and let the matrix alias a part of it.  The data of the
+   * matrix must be stored in column-major order starting at the given offset
+   * in the file, and the offset must be a multiple of sizeof(eT).  If the file
+   * can't be mapped, false is returned and the MappedMatrix is left unchanged.
+   *
+   * @param filename Name of the file to map.
+   * @param offset Offset of the first element of the matrix in the file, in
+   *     bytes.
+   * @param rows Number of rows of the matrix.
+   * @param cols Number of columns of the matrix.
+   * @return Whether or not the file was successfully mapped.
+   */
+  bool Map(const std::string& filename,
+           const size_t offset,
+           const size_t rows,
+           const size_t cols);
+
+  /**
+   * Release the mapping (if any), and reset the matrix to an empty matrix.
+   */
+  void Clear();
+
+  //! Get the matrix.
+  const arma::Mat<eT>& Matrix() const { return *matrix; }
+  //! Modify the matrix.  Its size can't be changed if the file is mapped.
+  arma::Mat<eT>& Matrix() { return *matrix; }
+
+  //! Return whether or not the matrix aliases a memory-mapped file.
+  bool IsMapped() const { return (mapping != NULL); }
+
+ private:
+  //! The matrix; it aliases the mapped memory if a file is mapped.
+  arma::Mat<eT>* matrix;
+  //! The beginning of the mapped memory (NULL if no file is mapped).
+  void* mapping;
+  //! The size of the mapped memory, in bytes.
+  size_t mappingSize;
+
+  //! A MappedMatrix can't be copied, because it owns the mapped memory.
+  MappedMatrix(const MappedMatrix& other);
+  //! A MappedMatrix can't be copied, because it owns the mapped memory.
+  MappedMatrix& operator=(const MappedMatrix& other);
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
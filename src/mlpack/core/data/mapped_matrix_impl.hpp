@@ -0,0 +1,109 @@
+/**
+ * @file mapped_matrix_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of MappedMatrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "mapped_matrix.hpp"
+
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix() :
+    matrix(new arma::Mat<eT>()),
+    mapping(NULL),
+    mappingSize(0)
+{
+  // Nothing to do.
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+  Clear();
+  delete matrix;
+}
+
+template<typename eT>
+bool MappedMatrix<eT>::Map(const std::string& filename,
+                           const size_t offset,
+                           const size_t rows,
+                           const size_t cols)
+{
+#ifndef _WIN32
+  // Empty matrices can't be mapped, and neither can misaligned data.
+  if (rows * cols == 0 || (offset % sizeof(eT)) != 0)
+    return false;
+
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  // The mapping is private, so the matrix may be modified without changing the
+  // file.  Only the pages that are written to are copied.
+  const size_t size = offset + rows * cols * sizeof(eT);
+  void* newMapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+      0);
+
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  if (newMapping == MAP_FAILED)
+    return false;
+
+  Clear();
+  mapping = newMapping;
+  mappingSize = size;
+
+  // Let the matrix use the mapped memory.  The memory is strictly bound to the
+  // matrix, so that it can't be resized.
+  delete matrix;
+  matrix = new arma::Mat<eT>((eT*) ((char*) mapping + offset), rows, cols,
+      false, true);
+
+  return true;
+#else
+  // Memory-mapped files aren't supported on Windows.
+  (void) filename;
+  (void) offset;
+  (void) rows;
+  (void) cols;
+  return false;
+#endif
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Clear()
+{
+  // The matrix must not outlive the memory it uses.
+  delete matrix;
+  matrix = new arma::Mat<eT>();
+
+#ifndef _WIN32
+  if (mapping)
+    munmap(mapping, mappingSize);
+#endif
+
+  mapping = NULL;
+  mappingSize = 0;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -22,10 +22,49 @@
 #include <boost/archive/binary_oarchive.hpp>
 
 #include "serialization_shim.hpp"
+#include "arma_binary_header.hpp"
+
+#include <sstream>
 
 namespace mlpack {
 namespace data {
 
+/**
+ * Save a matrix in Armadillo binary format.  Armadillo skips any whitespace
+ * between the header and the size of the matrix, so we pad the header with
+ * spaces such that the data starts at a multiple of 64 bytes.  The file can be
+ * loaded by Armadillo as usual, and the data is suitably aligned to be
+ * memory-mapped (see MappedMatrix).  Matrices of element types that
+ * ArmaBinaryHeader() doesn't know are saved by Armadillo instead.
+ *
+ * @param stream Stream to write the matrix to.
+ * @param matrix Matrix to save.
+ * @return Whether or not the matrix was written successfully.
+ */
+template<typename eT>
+bool SaveArmaBinary(std::ostream& stream, const arma::Mat<eT>& matrix)
+{
+  const size_t alignment = 64;
+
+  // We don't know the header of this element type, so let Armadillo write the
+  // file (without alignment) or reject it.
+  if (ArmaBinaryHeader<eT>().empty())
+    return matrix.quiet_save(stream, arma::arma_binary);
+
+  const std::string header = ArmaBinaryHeader<eT>() + "\n";
+  std::ostringstream size;
+  size << matrix.n_rows << " " << matrix.n_cols << "\n";
+
+  const size_t headerLength = header.length() + size.str().length();
+  const size_t padding = (alignment - (headerLength % alignment)) % alignment;
+
+  stream << header << std::string(padding, ' ') << size.str();
+  stream.write(reinterpret_cast<const char*>(matrix.memptr()),
+      std::streamsize(matrix.n_elem * sizeof(eT)));
+
+  return stream.good();
+}
+
 template<typename eT>
 bool Save(const std::string& filename,
           const arma::Col<eT>& vec,
@@ -162,10 +201,16 @@ bool Save(const std::string& filename,
   {
     arma::Mat<eT> tmp = trans(matrix);
 
-    // We can't save with streams for HDF5.
-    const bool success = (saveType == arma::hdf5_binary) ?
-        tmp.quiet_save(filename, saveType) :
-        tmp.quiet_save(stream, saveType);
+    // We can't save with streams for HDF5, and we write Armadillo binary files
+    // ourselves so that they can be memory-mapped.
+    bool success;
+    if (saveType == arma::hdf5_binary)
+      success = tmp.quiet_save(filename, saveType);
+    else if (saveType == arma::arma_binary)
+      success = SaveArmaBinary(stream, tmp);
+    else
+      success = tmp.quiet_save(stream, saveType);
+
     if (!success)
     {
       Timer::Stop("saving_data");
@@ -179,10 +224,16 @@ bool Save(const std::string& filename,
   }
   else
   {
-    // We can't save with streams for HDF5.
-    const bool success = (saveType == arma::hdf5_binary) ?
-        matrix.quiet_save(filename, saveType) :
-        matrix.quiet_save(stream, saveType);
+    // We can't save with streams for HDF5, and we write Armadillo binary files
+    // ourselves so that they can be memory-mapped.
+    bool success;
+    if (saveType == arma::hdf5_binary)
+      success = matrix.quiet_save(filename, saveType);
+    else if (saveType == arma::arma_binary)
+      success = SaveArmaBinary(stream, matrix);
+    else
+      success = matrix.quiet_save(stream, saveType);
+
     if (!success)
     {
       Timer::Stop("saving_data");
@@ -41,6 +41,19 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Evaluate the cosine distance on every pair of points from the two given
+   * sets, with a single matrix product for the dot products.  Then
+   * kernelMatrix(i, j) = K(a.col(i), b.col(j)).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param kernelMatrix Matrix to store the kernel values in.
+   */
+  static void EvaluateBlock(const arma::mat& a,
+                            const arma::mat& b,
+                            arma::mat& kernelMatrix);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void Serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -32,6 +32,20 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+inline void CosineDistance::EvaluateBlock(const arma::mat& a,
+                                          const arma::mat& b,
+                                          arma::mat& kernelMatrix)
+{
+  // As in Evaluate(), the similarity is 0 if either of the norms is 0.
+  kernelMatrix = trans(a) * b;
+  arma::vec aNorms = trans(sqrt(arma::sum(arma::square(a), 0)));
+  arma::rowvec bNorms = sqrt(arma::sum(arma::square(b), 0));
+  aNorms.elem(arma::find(aNorms == 0.0)).fill(DBL_MAX);
+  bNorms.elem(arma::find(bNorms == 0.0)).fill(DBL_MAX);
+  kernelMatrix.each_col() /= aNorms;
+  kernelMatrix.each_row() /= bNorms;
+}
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -51,6 +52,19 @@ class EpanechnikovKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
 
+  /**
+   * Evaluate the Epanechnikov kernel on every pair of points from the two given
+   * sets, with a single matrix product for the squared distances.  Then
+   * kernelMatrix(i, j) = K(a.col(i), b.col(j)).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param kernelMatrix Matrix to store the kernel values in.
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& kernelMatrix) const;
+
   /**
    * Evaluate the Epanechnikov kernel given that the distance between the two
    * input points is known.
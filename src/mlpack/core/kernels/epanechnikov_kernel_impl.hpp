@@ -29,6 +29,15 @@ inline double EpanechnikovKernel::Evaluate(const VecTypeA& a, const VecTypeB& b)
       * inverseBandwidthSquared);
 }
 
+inline void EpanechnikovKernel::EvaluateBlock(const arma::mat& a,
+                                              const arma::mat& b,
+                                              arma::mat& kernelMatrix) const
+{
+  SquaredDistanceBlock(a, b, kernelMatrix);
+  kernelMatrix = 1.0 - kernelMatrix * inverseBandwidthSquared;
+  kernelMatrix.elem(arma::find(kernelMatrix < 0.0)).zeros();
+}
+
 /**
  * Obtains the convolution integral [integral of K(||x-a||) K(||b-x||) dx]
  * for the two vectors.
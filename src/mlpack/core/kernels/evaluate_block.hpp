@@ -0,0 +1,158 @@
+/**
+ * @file evaluate_block.hpp
+ * @author Ryan Curtin
+ *
+ * Evaluation of a kernel on every pair of points from two sets at once.  A
+ * kernel may provide an EvaluateBlock() member that computes a whole block of
+ * the kernel matrix with matrix operations; for any other kernel, the block is
+ * filled one kernel evaluation at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_EVALUATE_BLOCK_HPP
+#define MLPACK_CORE_KERNELS_EVALUATE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the squared Euclidean distance between every column of a and every
+ * column of b, so that distances(i, j) = || a.col(i) - b.col(j) ||^2.  This is
+ * done with one matrix product, as ||a||^2 + ||b||^2 - 2 a^T b.  Rounding can
+ * make the distances of very close points slightly negative; these are set to
+ * zero.
+ *
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param distances Matrix to store the squared distances in.
+ */
+inline void SquaredDistanceBlock(const arma::mat& a,
+                                 const arma::mat& b,
+                                 arma::mat& distances)
+{
+  distances = -2.0 * trans(a) * b;
+  distances.each_col() += trans(arma::sum(arma::square(a), 0));
+  distances.each_row() += arma::sum(arma::square(b), 0);
+  distances.elem(arma::find(distances < 0.0)).zeros();
+
+  // The distance of each point to itself is exactly zero.
+  if (&a == &b)
+    distances.diag().zeros();
+}
+
+/**
+ * Compute the Euclidean distance between every column of a and every column of
+ * b, so that distances(i, j) = || a.col(i) - b.col(j) ||.  Unlike
+ * SquaredDistanceBlock(), the differences are taken directly: the rounding
+ * error of the expanded form is amplified by the square root for close points,
+ * which would make the distance of two identical points about 1e-8 instead of
+ * zero.
+ *
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param distances Matrix to store the distances in.
+ */
+inline void DistanceBlock(const arma::mat& a,
+                          const arma::mat& b,
+                          arma::mat& distances)
+{
+  distances.set_size(a.n_cols, b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+    distances.col(j) = trans(sqrt(sum(square(a.each_col() - b.col(j)), 0)));
+}
+
+/**
+ * This gives us a HasEvaluateBlockCheck object that we can use to tell whether
+ * or not a kernel can evaluate a whole block of the kernel matrix.
+ */
+HAS_MEM_FUNC(EvaluateBlock, HasEvaluateBlockCheck);
+
+/**
+ * 'value' is true if the KernelType class has a member
+ * EvaluateBlock(const arma::mat& a, const arma::mat& b, arma::mat& k), which
+ * may be const, non-const or static.
+ */
+template<typename KernelType>
+struct HasEvaluateBlock
+{
+  static const bool value =
+      HasEvaluateBlockCheck<KernelType, void(KernelType::*)(const arma::mat&,
+          const arma::mat&, arma::mat&) const>::value ||
+      HasEvaluateBlockCheck<KernelType, void(KernelType::*)(const arma::mat&,
+          const arma::mat&, arma::mat&)>::value ||
+      HasEvaluateBlockCheck<KernelType, void(*)(const arma::mat&,
+          const arma::mat&, arma::mat&)>::value;
+};
+
+/**
+ * Evaluate the kernel on every pair of points from the two given sets, so that
+ * kernelMatrix(i, j) = K(a.col(i), b.col(j)).  This overload is used when the
+ * kernel provides EvaluateBlock() and the points are stored in dense matrices.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernelMatrix Matrix to store the kernel values in.
+ */
+template<typename KernelType, typename MatType>
+void EvaluateBlock(
+    KernelType& kernel,
+    const MatType& a,
+    const MatType& b,
+    arma::mat& kernelMatrix,
+    const typename std::enable_if<HasEvaluateBlock<KernelType>::value &&
+        std::is_same<MatType, arma::mat>::value>::type* = 0)
+{
+  kernel.EvaluateBlock(a, b, kernelMatrix);
+}
+
+/**
+ * Evaluate the kernel on every pair of points from the two given sets, so that
+ * kernelMatrix(i, j) = K(a.col(i), b.col(j)).  This overload evaluates the
+ * kernel on one pair at a time.  If a and b are the same object, the kernel
+ * matrix is symmetric, and only half of it is evaluated.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernelMatrix Matrix to store the kernel values in.
+ */
+template<typename KernelType, typename MatType>
+void EvaluateBlock(
+    KernelType& kernel,
+    const MatType& a,
+    const MatType& b,
+    arma::mat& kernelMatrix,
+    const typename std::enable_if<!(HasEvaluateBlock<KernelType>::value &&
+        std::is_same<MatType, arma::mat>::value)>::type* = 0)
+{
+  kernelMatrix.set_size(a.n_cols, b.n_cols);
+
+  if (&a == &b)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      for (size_t i = 0; i <= j; ++i)
+      {
+        kernelMatrix(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+        kernelMatrix(j, i) = kernelMatrix(i, j);
+      }
+    }
+  }
+  else
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+      for (size_t i = 0; i < a.n_cols; ++i)
+        kernelMatrix(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+  }
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -68,6 +69,23 @@ class GaussianKernel
     return exp(gamma * metric::SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the Gaussian kernel on every pair of points from the two given
+   * sets, with a single matrix product for the squared distances.  Then
+   * kernelMatrix(i, j) = K(a.col(i), b.col(j)).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param kernelMatrix Matrix to store the kernel values in.
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& kernelMatrix) const
+  {
+    SquaredDistanceBlock(a, b, kernelMatrix);
+    kernelMatrix = exp(gamma * kernelMatrix);
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_HYPERBOLIC_TANGENT_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -62,6 +63,22 @@ class HyperbolicTangentKernel
     return tanh(scale * arma::dot(a, b) + offset);
   }
 
+  /**
+   * Evaluate the hyperbolic tangent kernel on every pair of points from the two
+   * given sets, with a single matrix product for the dot products.  Then
+   * kernelMatrix(i, j) = K(a.col(i), b.col(j)).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param kernelMatrix Matrix to store the kernel values in.
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& kernelMatrix) const
+  {
+    kernelMatrix = tanh(scale * trans(a) * b + offset);
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
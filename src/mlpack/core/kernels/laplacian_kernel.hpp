@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_LAPLACIAN_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -64,6 +65,23 @@ class LaplacianKernel
     return exp(-metric::EuclideanDistance::Evaluate(a, b) / bandwidth);
   }
 
+  /**
+   * Evaluate the Laplacian kernel on every pair of points from the two given
+   * sets, computing the distances one column of b at a time.  Then
+   * kernelMatrix(i, j) = K(a.col(i), b.col(j)).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param kernelMatrix Matrix to store the kernel values in.
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& kernelMatrix) const
+  {
+    DistanceBlock(a, b, kernelMatrix);
+    kernelMatrix = exp(-kernelMatrix / bandwidth);
+  }
+
   /**
    * Evaluation of the Laplacian kernel given the distance between two points.
    *
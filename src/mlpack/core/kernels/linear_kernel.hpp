@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -55,6 +56,22 @@ class LinearKernel
     return arma::dot(a, b);
   }
 
+  /**
+   * Evaluate the linear kernel on every pair of points from the two given sets,
+   * with a single matrix product.  Then kernelMatrix(i, j) = K(a.col(i),
+   * b.col(j)).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param kernelMatrix Matrix to store the kernel values in.
+   */
+  static void EvaluateBlock(const arma::mat& a,
+                            const arma::mat& b,
+                            arma::mat& kernelMatrix)
+  {
+    kernelMatrix = trans(a) * b;
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void Serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -52,6 +53,24 @@ class TriangularKernel
         bandwidth));
   }
 
+  /**
+   * Evaluate the triangular kernel on every pair of points from the two given
+   * sets, computing the distances one column of b at a time.  Then
+   * kernelMatrix(i, j) = K(a.col(i), b.col(j)).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param kernelMatrix Matrix to store the kernel values in.
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& kernelMatrix) const
+  {
+    DistanceBlock(a, b, kernelMatrix);
+    kernelMatrix = 1.0 - kernelMatrix / bandwidth;
+    kernelMatrix.elem(arma::find(kernelMatrix < 0.0)).zeros();
+  }
+
   /**
    * Evaluate the triangular kernel given that the distance between the two
    * points is known.
@@ -67,6 +67,18 @@ namespace optimization {
  * function on the first point in the dataset (presumably, the dataset is held
  * internally in the DecomposableFunctionType).
  *
+ * The DecomposableFunctionType may also implement
+ *
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 const size_t batchSize,
+ *                 arma::mat& gradient);
+ *
+ * which computes the sum of the gradients of the functions begin, ...,
+ * begin + batchSize - 1 in one call, typically with one matrix product.  If it
+ * is available, it is used for each mini-batch instead of one Gradient() call
+ * per function (and then the single-function Gradient() is not needed).
+ *
  * @tparam DecomposableFunctionType Decomposable objective function type to be
  *     minimized.
  */
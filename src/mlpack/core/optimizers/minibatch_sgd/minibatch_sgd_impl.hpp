@@ -18,6 +18,66 @@
 namespace mlpack {
 namespace optimization {
 
+//! This gives us a HasBatchGradientCheck<T, U> object that we can use to check
+//! whether a function can compute the gradient of a batch in one call.
+HAS_MEM_FUNC(Gradient, HasBatchGradientCheck);
+
+//! 'value' is true if the function type has a member
+//! Gradient(const arma::mat&, const size_t, const size_t, arma::mat&).
+template<typename FunctionType>
+struct HasBatchGradient
+{
+  static const bool value =
+      HasBatchGradientCheck<FunctionType, void(FunctionType::*)(
+          const arma::mat&, const size_t, const size_t,
+          arma::mat&) const>::value ||
+      HasBatchGradientCheck<FunctionType, void(FunctionType::*)(
+          const arma::mat&, const size_t, const size_t, arma::mat&)>::value;
+};
+
+/**
+ * Compute the sum of the gradients of the functions begin, ...,
+ * begin + batchSize - 1, with the batch Gradient() of the function.
+ */
+template<typename FunctionType>
+void BatchGradient(
+    FunctionType& function,
+    const arma::mat& iterate,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& gradient,
+    arma::mat& /* funcGradient */,
+    const typename std::enable_if<
+        HasBatchGradient<FunctionType>::value>::type* = 0)
+{
+  function.Gradient(iterate, begin, batchSize, gradient);
+}
+
+/**
+ * Compute the sum of the gradients of the functions begin, ...,
+ * begin + batchSize - 1, with one Gradient() call per function.  funcGradient
+ * is used as temporary storage, so that it is not reallocated for every
+ * function.
+ */
+template<typename FunctionType>
+void BatchGradient(
+    FunctionType& function,
+    const arma::mat& iterate,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& gradient,
+    arma::mat& funcGradient,
+    const typename std::enable_if<
+        !HasBatchGradient<FunctionType>::value>::type* = 0)
+{
+  function.Gradient(iterate, begin, gradient);
+  for (size_t j = 1; j < batchSize; ++j)
+  {
+    function.Gradient(iterate, begin + j, funcGradient);
+    gradient += funcGradient;
+  }
+}
+
 template<typename DecomposableFunctionType>
 MiniBatchSGD<DecomposableFunctionType>::MiniBatchSGD(
     DecomposableFunctionType& function,
@@ -62,6 +122,7 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
 
   // Now iterate!
   arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::mat funcGradient;
   for (size_t i = 1; i != maxIterations; ++i, ++currentBatch)
   {
     // Is this iteration the start of a sequence?
@@ -95,53 +156,19 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
         visitationOrder = arma::shuffle(visitationOrder);
     }
 
-    // Evaluate the gradient for this mini-batch.
+    // Evaluate the gradient for this mini-batch.  The last batch may be
+    // smaller than the others.
     const size_t offset = batchSize * visitationOrder[currentBatch];
-    function.Gradient(iterate, offset, gradient);
-    if (visitationOrder[currentBatch] != numBatches - 1)
-    {
-      for (size_t j = 1; j < batchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
+    const size_t currentBatchSize = std::min(batchSize, numFunctions - offset);
+    BatchGradient(function, iterate, offset, currentBatchSize, gradient,
+        funcGradient);
 
-      // Now update the iterate.
-      iterate -= (stepSize / batchSize) * gradient;
+    // Now update the iterate.
+    iterate -= (stepSize / currentBatchSize) * gradient;
 
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < batchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
-    else
-    {
-      // Handle last batch differently: it's not a full-size batch.
-      const size_t lastBatchSize = numFunctions - offset - 1;
-      for (size_t j = 1; j < lastBatchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
-
-      // Ensure the last batch size isn't zero, to avoid division by zero before
-      // updating.
-      if (lastBatchSize > 0)
-      {
-        // Now update the iterate.
-        iterate -= (stepSize / lastBatchSize) * gradient;
-      }
-      else
-      {
-        // Now update the iterate.
-        iterate -= stepSize * gradient;
-      }
-
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < lastBatchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
+    // Add that to the overall objective function.
+    for (size_t j = 0; j < currentBatchSize; ++j)
+      overallObjective += function.Evaluate(iterate, offset + j);
   }
 
   Log::Info << "Mini-batch SGD: maximum iterations (" << maxIterations << ") "
@@ -0,0 +1,42 @@
+/**
+ * @file constant_step.hpp
+ * @author Ryan Curtin
+ *
+ * Constant step size policy for parallel Stochastic Gradient Descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DECAY_POLICIES_CONSTANT_STEP_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DECAY_POLICIES_CONSTANT_STEP_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Implementation of the constant step size decay policy for parallel SGD: the
+ * same step size is used in every pass over the data.
+ */
+class ConstantStep
+{
+ public:
+  /**
+   * Return the step size to use in the given pass over the data.
+   *
+   * @param stepSize Initial step size.
+   * @param epoch Number of the pass over the data (starting at 0).
+   */
+  double StepSize(const double stepSize, const size_t /* epoch */) const
+  {
+    return stepSize;
+  }
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
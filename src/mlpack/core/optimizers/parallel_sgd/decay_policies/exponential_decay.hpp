@@ -0,0 +1,67 @@
+/**
+ * @file exponential_decay.hpp
+ * @author Ryan Curtin
+ *
+ * Exponentially decaying step size policy for parallel Stochastic Gradient
+ * Descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DECAY_POLICIES_EXPONENTIAL_DECAY_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_DECAY_POLICIES_EXPONENTIAL_DECAY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Exponentially decaying step size policy for parallel SGD.  After every pass
+ * over the data, the step size that every thread uses is multiplied by a fixed
+ * decay factor \f$ \beta \f$, so that in pass \f$ e \f$ the step size is
+ *
+ * \f[
+ * \alpha_e = \alpha \beta^e.
+ * \f]
+ *
+ * This is the step size schedule suggested for Hogwild!.
+ */
+class ExponentialDecay
+{
+ public:
+  /**
+   * Create the policy with the given decay factor.
+   *
+   * @param decay Factor that the step size is multiplied by after each pass
+   *     over the data; it should be in (0, 1].
+   */
+  ExponentialDecay(const double decay = 0.9) : decay(decay) { }
+
+  /**
+   * Return the step size to use in the given pass over the data.
+   *
+   * @param stepSize Initial step size.
+   * @param epoch Number of the pass over the data (starting at 0).
+   */
+  double StepSize(const double stepSize, const size_t epoch) const
+  {
+    return stepSize * std::pow(decay, (double) epoch);
+  }
+
+  //! Get the decay factor.
+  double Decay() const { return decay; }
+  //! Modify the decay factor.
+  double& Decay() { return decay; }
+
+ private:
+  //! The factor that the step size is multiplied by after each pass.
+  double decay;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,177 @@
+/**
+ * @file parallel_sgd.hpp
+ * @author Ryan Curtin
+ *
+ * Parallel Stochastic Gradient Descent without locking (Hogwild!).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "decay_policies/constant_step.hpp"
+#include "decay_policies/exponential_decay.hpp"
+#include "sparse_gradient_traits.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An implementation of parallel stochastic gradient descent without locks, as
+ * in Hogwild!.  For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title={Hogwild!: A lock-free approach to parallelizing stochastic gradient
+ *       descent},
+ *   author={Recht, B. and Re, C. and Wright, S. and Niu, F.},
+ *   booktitle={Advances in Neural Information Processing Systems 24 (NIPS
+ *       2011)},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * Like SGD, this minimizes a function that can be expressed as a sum of other
+ * functions, \f$ f(A) = \sum_{i = 0}^{n} f_i(A) \f$.  In each pass over the
+ * data, the (possibly shuffled) function indices are split into disjoint
+ * contiguous ranges, one per thread, and every thread takes a gradient step
+ * for each function in its range.  The steps are applied to the shared
+ * iterate without any locking: each element of the iterate is updated
+ * atomically, but a thread may compute a gradient from an iterate that other
+ * threads are modifying.  This works well when the gradient of each function
+ * only depends on and changes a small part of the iterate, as is the case for
+ * sparse data.  The step size for each pass is given by the decay policy.  The
+ * algorithm stops after the maximum number of passes, or when a pass improves
+ * the objective by less than the tolerance.
+ *
+ * For ParallelSGD to work, a DecomposableFunctionType template parameter is
+ * required.  This class must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates, const size_t i);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient);
+ *
+ * Instead of (or in addition to) the Gradient() function above, the class may
+ * implement
+ *
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::sp_mat& gradient);
+ *
+ * which returns the gradient as a sparse matrix; in that case, only the
+ * nonzero elements of the gradient are visited (unless SparseGradientTraits is
+ * specialized to turn the sparse gradient off for the function).  Evaluate()
+ * and Gradient() are called from several threads at once, so they must be
+ * safe to call concurrently.  Without OpenMP, one thread takes all the steps.
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type to be
+ *     minimized.
+ * @tparam DecayPolicyType Policy that gives the step size of each pass over
+ *     the data (ConstantStep or ExponentialDecay).
+ */
+template<
+    typename DecomposableFunctionType,
+    typename DecayPolicyType = ConstantStep
+>
+class ParallelSGD
+{
+ public:
+  /**
+   * Construct the parallel SGD optimizer with the given function and
+   * parameters.  Unlike for SGD, the maximum number of iterations refers to
+   * the maximum number of passes over all the functions.
+   *
+   * @param function Function to be optimized (minimized).
+   * @param stepSize Step size for the first pass.
+   * @param maxIterations Maximum number of passes over the functions (0 means
+   *     no limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled before each pass;
+   *     otherwise, each thread visits its range in linear order.
+   * @param decayPolicy Instantiated step size decay policy.
+   */
+  ParallelSGD(DecomposableFunctionType& function,
+              const double stepSize = 0.01,
+              const size_t maxIterations = 100,
+              const double tolerance = 1e-5,
+              const bool shuffle = true,
+              const DecayPolicyType decayPolicy = DecayPolicyType());
+
+  /**
+   * Optimize the given function using parallel stochastic gradient descent.
+   * The given starting point will be modified to store the finishing point of
+   * the algorithm, and the final objective value is returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  DecomposableFunctionType& Function() { return function; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of passes (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the step size decay policy.
+  const DecayPolicyType& DecayPolicy() const { return decayPolicy; }
+  //! Modify the step size decay policy.
+  DecayPolicyType& DecayPolicy() { return decayPolicy; }
+
+ private:
+  //! Compute the objective function over all functions.
+  double Objective(const arma::mat& iterate);
+
+  //! The instantiated function.
+  DecomposableFunctionType& function;
+
+  //! The step size for the first pass.
+  double stepSize;
+
+  //! The maximum number of allowed passes.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  //! The step size decay policy.
+  DecayPolicyType decayPolicy;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ * @file parallel_sgd_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of parallel stochastic gradient descent without locks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_sgd.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Take a step in the negative direction of the gradient of the function with
+ * the given index, using the sparse gradient of the function.  Each nonzero
+ * element of the gradient is subtracted atomically, without any locks.
+ */
+template<typename FunctionType>
+void HogwildStep(
+    FunctionType& function,
+    arma::mat& iterate,
+    const size_t i,
+    const double stepSize,
+    arma::sp_mat& sparseGradient,
+    arma::mat& /* gradient */,
+    const typename std::enable_if<
+        SparseGradientTraits<FunctionType>::UseSparseGradient>::type* = 0)
+{
+  function.Gradient(iterate, i, sparseGradient);
+
+  for (arma::sp_mat::const_iterator it = sparseGradient.begin();
+       it != sparseGradient.end(); ++it)
+  {
+    double& value = iterate(it.row(), it.col());
+    const double update = stepSize * (*it);
+
+    #pragma omp atomic
+    value -= update;
+  }
+}
+
+/**
+ * Take a step in the negative direction of the gradient of the function with
+ * the given index, using the dense gradient of the function.  Each nonzero
+ * element of the gradient is subtracted atomically, without any locks.
+ */
+template<typename FunctionType>
+void HogwildStep(
+    FunctionType& function,
+    arma::mat& iterate,
+    const size_t i,
+    const double stepSize,
+    arma::sp_mat& /* sparseGradient */,
+    arma::mat& gradient,
+    const typename std::enable_if<
+        !SparseGradientTraits<FunctionType>::UseSparseGradient>::type* = 0)
+{
+  function.Gradient(iterate, i, gradient);
+
+  double* values = iterate.memptr();
+  const double* gradientValues = gradient.memptr();
+  for (size_t j = 0; j < gradient.n_elem; ++j)
+  {
+    if (gradientValues[j] == 0.0)
+      continue;
+
+    const double update = stepSize * gradientValues[j];
+
+    #pragma omp atomic
+    values[j] -= update;
+  }
+}
+
+template<typename DecomposableFunctionType, typename DecayPolicyType>
+ParallelSGD<DecomposableFunctionType, DecayPolicyType>::ParallelSGD(
+    DecomposableFunctionType& function,
+    const double stepSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const DecayPolicyType decayPolicy) :
+    function(function),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    decayPolicy(decayPolicy)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType, typename DecayPolicyType>
+double ParallelSGD<DecomposableFunctionType, DecayPolicyType>::Optimize(
+    arma::mat& iterate)
+{
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+      (numFunctions - 1), numFunctions);
+
+  double overallObjective = Objective(iterate);
+  double lastObjective = DBL_MAX;
+
+  for (size_t epoch = 0; epoch != maxIterations; ++epoch)
+  {
+    // Output current objective function.
+    Log::Info << "Parallel SGD: iteration " << epoch << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Parallel SGD: converged to " << overallObjective << "; "
+          << "terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "Parallel SGD: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    if (shuffle) // Determine order of visitation.
+      visitationOrder = arma::shuffle(visitationOrder);
+
+    const double epochStepSize = decayPolicy.StepSize(stepSize, epoch);
+
+    // With the static schedule, every thread gets one contiguous range of the
+    // visitation order.
+    #pragma omp parallel
+    {
+      arma::sp_mat sparseGradient;
+      arma::mat gradient(iterate.n_rows, iterate.n_cols);
+
+      // On the Visual Studio compiler, we have to use intmax_t because size_t
+      // is not yet supported by their OpenMP implementation.
+      #ifdef _WIN32
+      #pragma omp for schedule(static)
+      for (intmax_t j = 0; j < (intmax_t) numFunctions; ++j)
+      #else
+      #pragma omp for schedule(static)
+      for (size_t j = 0; j < numFunctions; ++j)
+      #endif
+      {
+        HogwildStep(function, iterate, visitationOrder[j], epochStepSize,
+            sparseGradient, gradient);
+      }
+    }
+
+    lastObjective = overallObjective;
+    overallObjective = Objective(iterate);
+  }
+
+  Log::Info << "Parallel SGD: maximum iterations (" << maxIterations << ") "
+      << "reached; terminating optimization." << std::endl;
+
+  return overallObjective;
+}
+
+template<typename DecomposableFunctionType, typename DecayPolicyType>
+double ParallelSGD<DecomposableFunctionType, DecayPolicyType>::Objective(
+    const arma::mat& iterate)
+{
+  const size_t numFunctions = function.NumFunctions();
+
+  // Each thread sums the objective of its own range of functions; the sums are
+  // added in order, so that the result does not depend on the timing.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  threads = omp_get_max_threads();
+  #endif
+  std::vector<double> threadObjectives(threads, 0.0);
+
+  #pragma omp parallel num_threads(threads)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    #ifdef _WIN32
+    #pragma omp for schedule(static)
+    for (intmax_t i = 0; i < (intmax_t) numFunctions; ++i)
+    #else
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < numFunctions; ++i)
+    #endif
+    {
+      threadObjectives[thread] += function.Evaluate(iterate, i);
+    }
+  }
+
+  double objective = 0.0;
+  for (size_t t = 0; t < threads; ++t)
+    objective += threadObjectives[t];
+
+  return objective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file sparse_gradient_traits.hpp
+ * @author Ryan Curtin
+ *
+ * The SparseGradientTraits class tells ParallelSGD whether to take steps with
+ * the sparse gradient of a function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_SPARSE_GRADIENT_TRAITS_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_SPARSE_GRADIENT_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+//! This gives us a HasSparseGradientCheck<T, U> object that we can use to
+//! check whether a function can return its gradient as a sparse matrix.
+HAS_MEM_FUNC(Gradient, HasSparseGradientCheck);
+
+//! 'value' is true if the function type has a member
+//! Gradient(const arma::mat&, const size_t, arma::sp_mat&).
+template<typename FunctionType>
+struct HasSparseGradient
+{
+  static const bool value =
+      HasSparseGradientCheck<FunctionType, void(FunctionType::*)(
+          const arma::mat&, const size_t, arma::sp_mat&) const>::value ||
+      HasSparseGradientCheck<FunctionType, void(FunctionType::*)(
+          const arma::mat&, const size_t, arma::sp_mat&)>::value;
+};
+
+/**
+ * The SparseGradientTraits class provides compile-time information on how
+ * ParallelSGD should compute the gradient of one function.  By default, the
+ * sparse gradient is used whenever the function provides it.  A function whose
+ * sparse gradient is only meant for some of its data (for instance, because it
+ * approximates the regularization) should specialize this class.
+ *
+ * @tparam FunctionType Decomposable function type.
+ */
+template<typename FunctionType>
+class SparseGradientTraits
+{
+ public:
+  /**
+   * If true, then ParallelSGD takes its steps with
+   * Gradient(const arma::mat&, const size_t, arma::sp_mat&); otherwise, it uses
+   * the dense Gradient() and skips the zero elements of the gradient.
+   */
+  static const bool UseSparseGradient = HasSparseGradient<FunctionType>::value;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
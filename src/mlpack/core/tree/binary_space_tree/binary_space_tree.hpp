@@ -15,6 +15,7 @@
 
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -89,6 +90,10 @@ class BinarySpaceTree
   //! delete it.
   MatType* dataset;
 
+  //! Nodes holding at least this many points build their children as separate
+  //! OpenMP tasks, if the splitter allows it (see SplitTraits).
+  static const size_t parallelBuildThreshold = 1000;
+
  public:
   //! A single-tree traverser for binary space trees; see
   //! single_tree_traverser.hpp for implementation.
@@ -102,6 +107,11 @@ class BinarySpaceTree
   template<typename RuleType>
   class BreadthFirstDualTreeTraverser;
 
+  //! A dual-tree traverser that traverses independent query subtrees in
+  //! parallel; see parallel_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelDualTreeTraverser;
+
   /**
    * Construct this as the root node of a binary space tree using the given
    * dataset.  This will copy the input matrix; if you don't want this, consider
@@ -514,6 +524,21 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Build the left and right children of the current node, after the dataset
+   * has been split at the given column.  If the splitter allows it and the node
+   * is large enough, the left child is built in a separate OpenMP task.
+   *
+   * @param splitCol The first column that belongs to the right child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @param oldFromNew Vector holding permuted indices (may be NULL).
+   */
+  void BuildChildren(const size_t splitCol,
+                     const size_t maxLeafSize,
+                     SplitType<BoundType<MetricType>, MatType>& splitter,
+                     std::vector<size_t>* oldFromNew);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -531,6 +556,14 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Update the bound of the current node. This method is designed for
+   * HRectBound only; the bound of a large root node is computed in parallel.
+   *
+   * @param boundToUpdate The bound to update.
+   */
+  void UpdateBound(bound::HRectBound<MetricType>& boundToUpdate);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
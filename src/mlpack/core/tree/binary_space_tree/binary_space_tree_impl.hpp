@@ -782,11 +782,22 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  If
+  // the children may be built in parallel, the root opens the parallel region
+  // that the tasks of all the nodes below it run in.
+  if (!parent && SplitTraits<Split>::ThreadSafe &&
+      (count >= parallelBuildThreshold))
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      BuildChildren(splitCol, maxLeafSize, splitter, NULL);
+    }
+  }
+  else
+  {
+    BuildChildren(splitCol, maxLeafSize, splitter, NULL);
+  }
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -849,11 +860,22 @@ SplitNode(std::vector<size_t>& oldFromNew,
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  If
+  // the children may be built in parallel, the root opens the parallel region
+  // that the tasks of all the nodes below it run in.
+  if (!parent && SplitTraits<Split>::ThreadSafe &&
+      (count >= parallelBuildThreshold))
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      BuildChildren(splitCol, maxLeafSize, splitter, &oldFromNew);
+    }
+  }
+  else
+  {
+    BuildChildren(splitCol, maxLeafSize, splitter, &oldFromNew);
+  }
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -869,6 +891,45 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType>, MatType>& splitter,
+              std::vector<size_t>* oldFromNew)
+{
+  // The two children hold disjoint ranges of the dataset (and of oldFromNew),
+  // so they can be built concurrently.  Outside of a parallel region, or if
+  // the node is too small, the task is executed immediately.
+  const bool buildInTask = SplitTraits<Split>::ThreadSafe &&
+      (count >= parallelBuildThreshold);
+
+  #pragma omp task if(buildInTask) shared(splitter)
+  {
+    if (oldFromNew)
+      left = new BinarySpaceTree(this, begin, splitCol - begin, *oldFromNew,
+          splitter, maxLeafSize);
+    else
+      left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
+          maxLeafSize);
+  }
+
+  if (oldFromNew)
+    right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+        *oldFromNew, splitter, maxLeafSize);
+  else
+    right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+        splitter, maxLeafSize);
+
+  // The parent distances can only be computed once both children are built.
+  #pragma omp taskwait
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -909,6 +970,56 @@ UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+UpdateBound(bound::HRectBound<MetricType>& boundToUpdate)
+{
+  if (count == 0)
+    return;
+
+  // Nodes below the root are built in parallel already, and small nodes aren't
+  // worth the overhead.
+  if (parent || count < split::parallelSplitThreshold)
+  {
+    boundToUpdate |= dataset->cols(begin, begin + count - 1);
+    return;
+  }
+
+  // Each thread computes the bound of a subset of the points, and the results
+  // are merged.  The minimum and maximum don't depend on the order in which
+  // the points are visited, so the bound is the same as the sequential one.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (count + blockSize - 1) / blockSize;
+
+  #pragma omp parallel
+  {
+    bound::HRectBound<MetricType> threadBound(dataset->n_rows);
+
+    // On the Visual Studio compiler, we have to use intmax_t because size_t is
+    // not yet supported by their OpenMP implementation.
+    #ifdef _WIN32
+    #pragma omp for schedule(static)
+    for (intmax_t block = 0; block < (intmax_t) numBlocks; ++block)
+    #else
+    #pragma omp for schedule(static)
+    for (size_t block = 0; block < numBlocks; ++block)
+    #endif
+    {
+      const size_t first = begin + block * blockSize;
+      const size_t last = std::min(first + blockSize, begin + count) - 1;
+      threadBound |= dataset->cols(first, last);
+    }
+
+    #pragma omp critical (BinarySpaceTreeUpdateBound)
+    boundToUpdate |= threadBound;
+  }
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -0,0 +1,160 @@
+/**
+ * @file parallel_dual_tree_traverser.hpp
+ * @author Ryan Curtin
+ *
+ * Defines the ParallelDualTreeTraverser for the BinarySpaceTree tree type.
+ * This is a nested class of BinarySpaceTree which splits the query tree into
+ * independent subtrees and traverses each of them against the reference tree
+ * in a separate (OpenMP) task.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "binary_space_tree.hpp"
+#include "dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A parallel dual-tree traverser for binary space trees.  The query tree is
+ * descended (without scoring) down to the given task depth; every query subtree
+ * at that depth (or every leaf above it) is then traversed against the
+ * reference node with the depth-first DualTreeTraverser, in its own OpenMP
+ * task.  Because the query subtrees are disjoint, the tasks touch disjoint sets
+ * of query points and query statistics; idle threads pick up the remaining
+ * tasks, so unbalanced subtrees are evened out.  If mlpack is compiled without
+ * OpenMP, the subtrees are simply traversed one after another.
+ *
+ * Every task works with its own copy of the rules, constructed with the copy
+ * constructor of RuleType.  Therefore the rules must satisfy these
+ * requirements:
+ *
+ *  - A copy must share the results with the object it was copied from (e.g.
+ *    by holding them by reference), but have its own traversal information,
+ *    caches and counters; the copy constructor must not read the counters of
+ *    the object it copies.
+ *  - The number of base cases and scores must be available through the
+ *    BaseCases() and Scores() modifiers.  The counts of every copy are added
+ *    to the original rules object once the copy is done, so after Traverse()
+ *    the original rules hold the counts of the whole traversal, just like
+ *    with DualTreeTraverser.
+ *  - Score() and BaseCase() may only modify state that belongs to the query
+ *    node or query point they are called with (such as the per-query bounds
+ *    in the query statistic).
+ *
+ * NeighborSearchRules and RangeSearchRules satisfy these requirements (for
+ * RangeSearchRules, as long as the results object may be used by several
+ * threads, like RangeSearchVectorResults and RangeSearchCountResults).  Rules
+ * that update state shared between query points (such as the per-component
+ * candidates of DTBRules) must not be used with this traverser.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.
+   *
+   * @param rule Rules to traverse the trees with.
+   * @param taskDepth Query subtrees at this depth (relative to the query node
+   *     passed to Traverse()) are traversed in separate tasks.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t taskDepth = 6);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(BinarySpaceTree& queryNode,
+                BinarySpaceTree& referenceNode);
+
+  //! Get the depth of the query subtrees that are traversed in tasks.
+  size_t TaskDepth() const { return taskDepth; }
+  //! Modify the depth of the query subtrees that are traversed in tasks.
+  size_t& TaskDepth() { return taskDepth; }
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  /**
+   * Descend the query tree and spawn a task for every query subtree at the
+   * task depth.
+   *
+   * @param queryNode Current query node.
+   * @param referenceNode The reference node to be traversed.
+   * @param depth Depth of the query node relative to the root of the
+   *     traversal.
+   */
+  void SpawnTasks(BinarySpaceTree* queryNode,
+                  BinarySpaceTree* referenceNode,
+                  const size_t depth);
+
+  /**
+   * Traverse the given query subtree against the reference node with a
+   * private copy of the rules, and accumulate the statistics of the traversal
+   * and the counters of the copy of the rules.
+   */
+  void TraverseSubtree(BinarySpaceTree* queryNode,
+                       BinarySpaceTree* referenceNode);
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The depth of the query subtrees that are traversed in tasks.
+  size_t taskDepth;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
@@ -0,0 +1,134 @@
+/**
+ * @file parallel_dual_tree_traverser_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the ParallelDualTreeTraverser for BinarySpaceTree.  The
+ * query tree is split into independent subtrees which are traversed against
+ * the reference tree in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::ParallelDualTreeTraverser(
+    RuleType& rule,
+    const size_t taskDepth) :
+    rule(rule),
+    taskDepth(taskDepth),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  // One thread descends the query tree and creates the tasks; all threads of
+  // the team then execute them.
+  #pragma omp parallel
+  {
+    #pragma omp single
+    {
+      SpawnTasks(&queryNode, &referenceNode, 0);
+    }
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::SpawnTasks(
+    BinarySpaceTree* queryNode,
+    BinarySpaceTree* referenceNode,
+    const size_t depth)
+{
+  if (queryNode->IsLeaf() || depth >= taskDepth)
+  {
+    TraverseSubtree(queryNode, referenceNode);
+    return;
+  }
+
+  // The two query children are independent, so they can be handled by
+  // different threads.  We don't score the query children here: the traversal
+  // of each subtree starts from scratch with the reference node.
+  BinarySpaceTree* left = queryNode->Left();
+  BinarySpaceTree* right = queryNode->Right();
+
+  #pragma omp task
+  SpawnTasks(left, referenceNode, depth + 1);
+
+  #pragma omp task
+  SpawnTasks(right, referenceNode, depth + 1);
+
+  #pragma omp taskwait
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::TraverseSubtree(
+    BinarySpaceTree* queryNode,
+    BinarySpaceTree* referenceNode)
+{
+  // Each task has its own traversal information and caches, but shares the
+  // results with the original rules.
+  RuleType taskRule(rule);
+  DualTreeTraverser<RuleType> traverser(taskRule);
+  traverser.Traverse(*queryNode, *referenceNode);
+
+  #pragma omp critical (ParallelDualTreeTraverserStatistics)
+  {
+    numPrunes += traverser.NumPrunes();
+    numVisited += traverser.NumVisited();
+    numScores += traverser.NumScores();
+    numBaseCases += traverser.NumBaseCases();
+
+    rule.BaseCases() += taskRule.BaseCases();
+    rule.Scores() += taskRule.Scores();
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
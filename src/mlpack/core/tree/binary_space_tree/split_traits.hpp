@@ -0,0 +1,72 @@
+/**
+ * @file split_traits.hpp
+ * @author Ryan Curtin
+ *
+ * The SplitTraits class describes properties of the splitters used by
+ * BinarySpaceTree.  BinarySpaceTree uses these traits to decide whether the
+ * children of a node may be built in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class provides compile-time information on a splitter.  By
+ * default, a splitter is assumed to be unsafe to use from several threads at
+ * once; this is the case for splitters that draw random numbers (like
+ * RPTreeMaxSplit or VantagePointSplit) or that keep state between calls to
+ * SplitNode() (like UBTreeSplit).  A splitter that only reads the points of the
+ * node it is splitting should specialize this class.
+ *
+ * @tparam SplitType Fully instantiated splitter type.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * If true, then SplitNode() and PerformSplit() may be called concurrently on
+   * disjoint ranges of the dataset, and the resulting tree does not depend on
+   * the order of those calls.
+   */
+  static const bool ThreadSafe = false;
+};
+
+/**
+ * MidpointSplit is stateless and deterministic, so nodes of a dense dataset may
+ * be split in parallel.  Swapping the columns of a sparse matrix moves nonzero
+ * values between columns, so no two columns of a sparse dataset can be swapped
+ * at the same time.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ThreadSafe = !arma::is_SpMat<MatType>::value;
+};
+
+/**
+ * MeanSplit is stateless and deterministic, so nodes of a dense dataset may be
+ * split in parallel (see the MidpointSplit specialization).
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ThreadSafe = !arma::is_SpMat<MatType>::value;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -20,6 +20,90 @@ namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 namespace split {
 
+/**
+ * The number of points that a node must hold before PerformSplit() computes the
+ * assignments of its points in parallel.  For smaller nodes the cost of
+ * starting threads outweighs the benefit.
+ */
+const size_t parallelSplitThreshold = 100000;
+
+/**
+ * Rearrange the points of a large node according to the split information.
+ * First, the child that each point belongs to is computed in parallel for all
+ * points in the node; then the points are swapped exactly as in the sequential
+ * version of PerformSplit(), so the resulting ordering of the dataset is the
+ * same.  If oldFromNew is not NULL, it is updated as well.
+ *
+ * @param data The dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ * @param oldFromNew Vector which will be filled with the old positions for
+ *    each new point (may be NULL).
+ */
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo,
+                            std::vector<size_t>* oldFromNew)
+{
+  // Compute the assignments of all points.  We use char and not bool, since
+  // the elements of a std::vector<bool> can't be written concurrently.
+  std::vector<char> assignLeft(count);
+
+  // On the Visual Studio compiler, we have to use intmax_t because size_t is
+  // not yet supported by their OpenMP implementation.
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) count; ++i)
+  #else
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < count; ++i)
+  #endif
+  {
+    assignLeft[i] = SplitType::AssignToLeftNode(data.col(begin + i),
+        splitInfo);
+  }
+
+  // Now perform the same swaps that the sequential version does.  The
+  // assignments are indexed relative to the beginning of the node, and they
+  // are swapped along with the points.
+  size_t left = begin;
+  size_t right = begin + count - 1;
+
+  while ((left <= right) && assignLeft[left - begin])
+    left++;
+  while ((left <= right) && (right > 0) && !assignLeft[right - begin])
+    right--;
+
+  // Shortcut for when all points are on the right.
+  if (left == right && right == 0)
+    return left;
+
+  while (left <= right)
+  {
+    data.swap_cols(left, right);
+    std::swap(assignLeft[left - begin], assignLeft[right - begin]);
+
+    if (oldFromNew)
+    {
+      const size_t t = (*oldFromNew)[left];
+      (*oldFromNew)[left] = (*oldFromNew)[right];
+      (*oldFromNew)[right] = t;
+    }
+
+    while ((left <= right) && assignLeft[left - begin])
+      left++;
+    while ((left <= right) && !assignLeft[right - begin])
+      right--;
+  }
+
+  Log::Assert(left == right + 1);
+  return left;
+}
+
 /**
  * This function implements the default split behavior i.e. it rearranges
  * points according to the split information. The SplitType::AssignToLeftNode()
@@ -38,6 +122,13 @@ size_t PerformSplit(MatType& data,
                     const size_t count,
                     const typename SplitType::SplitInfo& splitInfo)
 {
+  // Large nodes are handled in parallel.
+  if (count >= parallelSplitThreshold)
+  {
+    return ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+        splitInfo, NULL);
+  }
+
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
   size_t left = begin;
@@ -104,6 +195,13 @@ size_t PerformSplit(MatType& data,
                     const typename SplitType::SplitInfo& splitInfo,
                     std::vector<size_t>& oldFromNew)
 {
+  // Large nodes are handled in parallel.
+  if (count >= parallelSplitThreshold)
+  {
+    return ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+        splitInfo, &oldFromNew);
+  }
+
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
   size_t left = begin;
@@ -16,6 +16,8 @@
 
 #include <map>
 #include <string>
+#include <fstream>
+#include <algorithm>
 
 using namespace mlpack;
 using namespace std::chrono;
@@ -44,24 +46,98 @@ microseconds Timer::Get(const std::string& name)
   return CLI::GetSingleton().timer.GetTimer(name);
 }
 
+/**
+ * Register the given timer.
+ */
+size_t Timer::Register(const std::string& name)
+{
+  return CLI::GetSingleton().timer.Register(name);
+}
+
+/**
+ * Start the timer with the given handle.
+ */
+void Timer::Start(const size_t handle)
+{
+  CLI::GetSingleton().timer.StartTimer(handle);
+}
+
+/**
+ * Stop the timer with the given handle.
+ */
+void Timer::Stop(const size_t handle)
+{
+  CLI::GetSingleton().timer.StopTimer(handle);
+}
+
+/**
+ * Enable or disable tracing.
+ */
+void Timer::EnableTracing(const bool enable)
+{
+  CLI::GetSingleton().timer.EnableTracing(enable);
+}
+
+/**
+ * Export the trace.
+ */
+bool Timer::ExportTrace(const std::string& filename)
+{
+  return CLI::GetSingleton().timer.ExportTrace(filename);
+}
+
+Timers::Timers() :
+    tracing(false),
+    traceStart(GetTime())
+{
+  // Each Timers object gets a different identifier, so that the timers cached
+  // by a thread can't be mistaken for those of another object.
+  static std::atomic<size_t> nextId(1);
+  id = nextId++;
+
+  // The total time is handled specially, so it gets the first handle.
+  Register("total_time");
+}
+
 std::map<std::string, microseconds>& Timers::GetAllTimers()
 {
+  // Refresh the values of all timers that have been used.  Existing entries are
+  // only updated, so iterators stay valid.
+  std::lock_guard<std::mutex> lock(mutex);
+  for (size_t h = 0; h < names.size(); ++h)
+  {
+    bool used = false;
+    for (size_t t = 0; t < threadTimers.size(); ++t)
+      if (h < threadTimers[t]->used.size() && threadTimers[t]->used[h])
+        used = true;
+
+    if (used)
+      timers[names[h]] = Total(h);
+  }
+
   return timers;
 }
 
 microseconds Timers::GetTimer(const std::string& timerName)
 {
-  return timers[timerName];
+  std::lock_guard<std::mutex> lock(mutex);
+  std::map<std::string, size_t>::const_iterator it = handles.find(timerName);
+  if (it == handles.end())
+    return (microseconds) 0;
+
+  return Total(it->second);
 }
 
 bool Timers::GetState(std::string timerName)
 {
-  return timerState[timerName];
+  const size_t handle = Register(timerName);
+  ThreadTimers& local = Local();
+  return (handle < local.running.size()) && local.running[handle];
 }
 
 void Timers::PrintTimer(const std::string& timerName)
 {
-  microseconds totalDuration = timers[timerName];
+  microseconds totalDuration = GetTimer(timerName);
   // Convert microseconds to seconds.
   seconds totalDurationSec = duration_cast<seconds>(totalDuration);
   microseconds totalDurationMicroSec =
@@ -127,42 +203,201 @@ high_resolution_clock::time_point Timers::GetTime()
 
 void Timers::StartTimer(const std::string& timerName)
 {
-  if ((timerState[timerName] == 1) && (timerName != "total_time"))
+  StartTimer(Register(timerName));
+}
+
+void Timers::StopTimer(const std::string& timerName)
+{
+  StopTimer(Register(timerName));
+}
+
+size_t Timers::Register(const std::string& timerName)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  std::map<std::string, size_t>::const_iterator it = handles.find(timerName);
+  if (it != handles.end())
+    return it->second;
+
+  names.push_back(timerName);
+  handles[timerName] = names.size() - 1;
+  return names.size() - 1;
+}
+
+void Timers::StartTimer(const size_t handle)
+{
+  ThreadTimers& local = Local();
+  Reserve(local, handle);
+
+  // The total time may be started twice; it is simply restarted.
+  if (local.running[handle])
   {
-    std::ostringstream error;
-    error << "Timer::Start(): timer '" << timerName
-        << "' has already been started";
-    throw std::runtime_error(error.str());
+    if (handle != 0)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::ostringstream error;
+      error << "Timer::Start(): timer '" << names[handle]
+          << "' has already been started";
+      throw std::runtime_error(error.str());
+    }
+  }
+  else
+  {
+    local.running[handle] = true;
+    local.used[handle] = true;
+    local.active.push_back(handle);
   }
 
-  timerState[timerName] = true;
+  local.startTimes[handle] = GetTime();
+}
 
-  high_resolution_clock::time_point currTime = GetTime();
+void Timers::StopTimer(const size_t handle)
+{
+  const high_resolution_clock::time_point currTime = GetTime();
 
-  // If the timer is added first time
-  if (timers.count(timerName) == 0)
+  ThreadTimers& local = Local();
+  Reserve(local, handle);
+
+  // The total time may be stopped twice; the time since it was last started is
+  // added again.
+  if (!local.running[handle])
   {
-    timers[timerName] = (microseconds) 0;
+    if (handle != 0)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::ostringstream error;
+      error << "Timer::Stop(): timer '" << names[handle]
+          << "' has already been stopped";
+      throw std::runtime_error(error.str());
+    }
+
+    local.used[handle] = true;
+    local.totals[handle] += currTime - local.startTimes[handle];
+    return;
   }
 
-  timerStartTime[timerName] = currTime;
+  local.running[handle] = false;
+  local.totals[handle] += currTime - local.startTimes[handle];
+
+  // Timers don't have to be stopped in the reverse order that they were
+  // started in, so search for the timer from the innermost one.
+  size_t depth = local.active.size() - 1;
+  while (local.active[depth] != handle)
+    --depth;
+  local.active.erase(local.active.begin() + depth);
+
+  if (tracing)
+  {
+    TraceEvent event;
+    event.handle = handle;
+    event.depth = depth;
+    event.start = local.startTimes[handle];
+    event.stop = currTime;
+    local.events.push_back(event);
+  }
 }
 
-void Timers::StopTimer(const std::string& timerName)
+bool Timers::ExportTrace(const std::string& filename)
+{
+  std::ofstream stream(filename.c_str());
+  if (!stream.is_open())
+  {
+    Log::Warn << "Cannot open file '" << filename << "'; trace not exported."
+        << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Write each recorded run as a complete ('X') event; the thread of the event
+  // is the order in which the thread first used a timer.
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  for (size_t t = 0; t < threadTimers.size(); ++t)
+  {
+    const std::vector<TraceEvent>& events = threadTimers[t]->events;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+      // Escape the name of the timer for JSON.
+      std::ostringstream name;
+      const std::string& timerName = names[events[i].handle];
+      for (size_t c = 0; c < timerName.size(); ++c)
+      {
+        if (timerName[c] == '"' || timerName[c] == '\\')
+          name << '\\' << timerName[c];
+        else if ((unsigned char) timerName[c] < 0x20)
+          name << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+              << (int) timerName[c] << std::dec;
+        else
+          name << timerName[c];
+      }
+
+      const microseconds start = duration_cast<microseconds>(events[i].start -
+          traceStart);
+      const microseconds length = duration_cast<microseconds>(events[i].stop -
+          events[i].start);
+
+      stream << (first ? "\n" : ",\n") << "{\"name\":\"" << name.str()
+          << "\",\"cat\":\"mlpack\",\"ph\":\"X\",\"ts\":" << start.count()
+          << ",\"dur\":" << length.count() << ",\"pid\":1,\"tid\":" << t
+          << ",\"args\":{\"depth\":" << events[i].depth << "}}";
+      first = false;
+    }
+  }
+  stream << "\n]}\n";
+
+  if (!stream.good())
+  {
+    Log::Warn << "Error writing trace to '" << filename << "'." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+Timers::ThreadTimers& Timers::Local()
 {
-  if ((timerState[timerName] == 0) && (timerName != "total_time"))
+  // Each thread caches its timers, so that only the first use of a timer in a
+  // thread has to take the lock.
+  static thread_local size_t cachedId = 0;
+  static thread_local ThreadTimers* cachedTimers = NULL;
+  if (cachedId == id)
+    return *cachedTimers;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  const std::thread::id thread = std::this_thread::get_id();
+  std::map<std::thread::id, size_t>::const_iterator it =
+      threadIndices.find(thread);
+  if (it == threadIndices.end())
   {
-    std::ostringstream error;
-    error << "Timer::Stop(): timer '" << timerName
-        << "' has already been stopped";
-    throw std::runtime_error(error.str());
+    threadTimers.push_back(std::unique_ptr<ThreadTimers>(new ThreadTimers()));
+    it = threadIndices.insert(std::make_pair(thread,
+        threadTimers.size() - 1)).first;
   }
 
-  timerState[timerName] = false;
+  cachedId = id;
+  cachedTimers = threadTimers[it->second].get();
+  return *cachedTimers;
+}
+
+void Timers::Reserve(ThreadTimers& local, const size_t handle)
+{
+  if (handle < local.totals.size())
+    return;
 
-  high_resolution_clock::time_point currTime = GetTime();
+  const size_t size = std::max(2 * local.totals.size(), handle + 1);
+  local.totals.resize(size, high_resolution_clock::duration::zero());
+  local.startTimes.resize(size);
+  local.running.resize(size, false);
+  local.used.resize(size, false);
+}
+
+microseconds Timers::Total(const size_t handle) const
+{
+  high_resolution_clock::duration total =
+      high_resolution_clock::duration::zero();
+  for (size_t t = 0; t < threadTimers.size(); ++t)
+    if (handle < threadTimers[t]->totals.size())
+      total += threadTimers[t]->totals[handle];
 
-  // Calculate the delta time.
-  timers[timerName] += duration_cast<microseconds>(currTime -
-      timerStartTime[timerName]);
+  return duration_cast<microseconds>(total);
 }
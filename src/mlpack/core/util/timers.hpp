@@ -15,6 +15,11 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include <chrono> // chrono library for cross platform timer calculation
 
 #if defined(_WIN32)
@@ -34,6 +39,25 @@ namespace mlpack {
  * The timer class provides a way for mlpack methods to be timed.  The three
  * methods contained in this class allow a named timer to be started and
  * stopped, and its value to be obtained.
+ *
+ * Timers are kept separately for each thread, so they can be used inside
+ * OpenMP regions; the value of a timer is the sum of its values over all
+ * threads.  In code that is run often, looking up timers by name is too
+ * expensive; instead, a timer can be registered once with Register(), and the
+ * returned handle can be passed to Start() and Stop():
+ *
+ * @code
+ * static const size_t baseCaseTimer = Timer::Register("base_cases");
+ *
+ * Timer::Start(baseCaseTimer);
+ * ...
+ * Timer::Stop(baseCaseTimer);
+ * @endcode
+ *
+ * Timers that are running at the same time in a thread are nested: if tracing
+ * is enabled with EnableTracing(), each run of a timer is recorded along with
+ * its depth, and the recorded runs can be written with ExportTrace() in the
+ * Chrome trace event format (which can be viewed with chrome://tracing).
  */
 class Timer
 {
@@ -62,18 +86,91 @@ class Timer
   static void Stop(const std::string& name);
 
   /**
-   * Get the value of the given timer.
+   * Get the value of the given timer.  This should not be called while other
+   * threads are running the timer.
    *
    * @param name Name of timer to return value of.
    */
   static std::chrono::microseconds Get(const std::string& name);
+
+  /**
+   * Register the timer with the given name (if it isn't registered already),
+   * and return its handle.  Starting and stopping a timer by its handle
+   * doesn't require any lookup or locking.
+   *
+   * @param name Name of timer to register.
+   * @return Handle of the timer.
+   */
+  static size_t Register(const std::string& name);
+
+  /**
+   * Start the timer with the given handle in the calling thread.
+   *
+   * @note A std::runtime_error exception will be thrown if a timer is started
+   * twice.
+   *
+   * @param handle Handle of the timer, as returned by Register().
+   */
+  static void Start(const size_t handle);
+
+  /**
+   * Stop the timer with the given handle in the calling thread.
+   *
+   * @note A std::runtime_error exception will be thrown if the timer is not
+   * running.
+   *
+   * @param handle Handle of the timer, as returned by Register().
+   */
+  static void Stop(const size_t handle);
+
+  /**
+   * Enable or disable the recording of the runs of all timers.
+   *
+   * @param enable Whether or not runs should be recorded.
+   */
+  static void EnableTracing(const bool enable = true);
+
+  /**
+   * Write all recorded runs of all timers to the given file, in the Chrome
+   * trace event JSON format.  This should not be called while other threads
+   * are running timers.
+   *
+   * @param filename Name of the file to write.
+   * @return Whether or not the file was written successfully.
+   */
+  static bool ExportTrace(const std::string& filename);
+};
+
+/**
+ * A TimerScope starts the given timer when it is constructed, and stops it when
+ * it goes out of scope.  Nested scopes give nested timers.
+ *
+ * @code
+ * {
+ *   TimerScope scope(handle);
+ *   ...
+ * } // The timer is stopped here.
+ * @endcode
+ */
+class TimerScope
+{
+ public:
+  //! Start the timer with the given handle.
+  TimerScope(const size_t handle) : handle(handle) { Timer::Start(handle); }
+
+  //! Stop the timer.
+  ~TimerScope() { Timer::Stop(handle); }
+
+ private:
+  //! The handle of the timer.
+  size_t handle;
 };
 
 class Timers
 {
  public:
-  //! Nothing to do for the constructor.
-  Timers() { }
+  //! Create the timers; no timers are registered.
+  Timers();
 
   /**
    * Returns a copy of all the timers used via this interface.
@@ -96,38 +193,122 @@ class Timers
   void PrintTimer(const std::string& timerName);
 
   /**
-   * Initializes a timer, available like a normal value specified on
-   * the command line.  Timers are of type timeval.  If a timer is started, then
+   * Initializes a timer, available like a normal value specified on
+   * the command line.  Timers are of type timeval.  If a timer is started, then
    * stopped, then re-started, then stopped, the final timer value will be the
    * length of both runs of the timer.
-   *
-   * @param timerName The name of the timer in question.
-   */
+   *
+   * @param timerName The name of the timer in question.
+   */
   void StartTimer(const std::string& timerName);
 
   /**
-   * Halts the timer, and replaces it's value with
-   * the delta time from it's start
-   *
-   * @param timerName The name of the timer in question.
-   */
+   * Halts the timer, and replaces it's value with
+   * the delta time from it's start
+   *
+   * @param timerName The name of the timer in question.
+   */
   void StopTimer(const std::string& timerName);
 
   /**
-   * Returns state of the given timer.
+   * Returns state of the given timer in the calling thread.
    *
    * @param timerName The name of the timer in question.
    */
   bool GetState(std::string timerName);
 
+  /**
+   * Register the given timer, and return its handle.
+   *
+   * @param timerName The name of the timer in question.
+   */
+  size_t Register(const std::string& timerName);
+
+  /**
+   * Start the timer with the given handle in the calling thread.
+   *
+   * @param handle The handle of the timer in question.
+   */
+  void StartTimer(const size_t handle);
+
+  /**
+   * Stop the timer with the given handle in the calling thread.
+   *
+   * @param handle The handle of the timer in question.
+   */
+  void StopTimer(const size_t handle);
+
+  //! Enable or disable the recording of timer runs.
+  void EnableTracing(const bool enable) { tracing = enable; }
+
+  /**
+   * Write the recorded timer runs of all threads to the given file, in the
+   * Chrome trace event format.
+   *
+   * @param filename The name of the file to write.
+   */
+  bool ExportTrace(const std::string& filename);
+
  private:
-  //! A map of all the timers that are being tracked.
+  //! A single recorded run of a timer.
+  struct TraceEvent
+  {
+    //! The handle of the timer.
+    size_t handle;
+    //! The number of timers that were running in the thread when it started.
+    size_t depth;
+    //! The time at which the timer was started.
+    std::chrono::high_resolution_clock::time_point start;
+    //! The time at which the timer was stopped.
+    std::chrono::high_resolution_clock::time_point stop;
+  };
+
+  //! The state of all timers in one thread, indexed by handle.
+  struct ThreadTimers
+  {
+    //! The accumulated time of each timer.
+    std::vector<std::chrono::high_resolution_clock::duration> totals;
+    //! The time at which each running timer was started.
+    std::vector<std::chrono::high_resolution_clock::time_point> startTimes;
+    //! Whether or not each timer is running.
+    std::vector<char> running;
+    //! Whether or not each timer has ever been started.
+    std::vector<char> used;
+    //! The running timers, from the outermost to the innermost.
+    std::vector<size_t> active;
+    //! The recorded runs, if tracing is enabled.
+    std::vector<TraceEvent> events;
+  };
+
+  //! Get the timers of the calling thread, creating them if necessary.
+  ThreadTimers& Local();
+
+  //! Make sure that the given thread's timers can hold the given handle.
+  static void Reserve(ThreadTimers& local, const size_t handle);
+
+  //! Sum the values of the given timer over all threads.  The lock must be
+  //! held.
+  std::chrono::microseconds Total(const size_t handle) const;
+
+  //! A unique identifier for this object, so that threads can cache their
+  //! timers.
+  size_t id;
+  //! Protects everything below, except for the contents of the thread timers.
+  std::mutex mutex;
+  //! The names of the registered timers, indexed by handle.
+  std::vector<std::string> names;
+  //! The handles of the registered timers.
+  std::map<std::string, size_t> handles;
+  //! The timers of each thread that has used a timer, in order of first use.
+  std::vector<std::unique_ptr<ThreadTimers>> threadTimers;
+  //! The index in threadTimers of the timers of each thread.
+  std::map<std::thread::id, size_t> threadIndices;
+  //! Whether or not timer runs are recorded.
+  std::atomic<bool> tracing;
+  //! The time that recorded runs are relative to.
+  std::chrono::high_resolution_clock::time_point traceStart;
+  //! The values of all timers, as returned by GetAllTimers().
   std::map<std::string, std::chrono::microseconds> timers;
-  //! A map that contains whether or not each timer is currently running.
-  std::map<std::string, bool> timerState;
-  //! A map for the starting values of the timers.
-  std::map<std::string, std::chrono::high_resolution_clock::time_point>
-      timerStartTime;
 
   std::chrono::high_resolution_clock::time_point GetTime();
 };
@@ -0,0 +1,312 @@
+/**
+ * @file im2col_convolution.hpp
+ * @author Marcus Edel
+ *
+ * Implementation of the convolution through the unrolling of the input patches
+ * into a matrix (im2col) and a single matrix product.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by copying every patch of the input
+ * that the filter is applied to into a column of a matrix (im2col), so that the
+ * convolution becomes a single matrix product that is handed to BLAS.  This
+ * uses more memory than the naive convolution, but is much faster for all but
+ * the smallest filters.  The convolution can be computed with the valid border
+ * type or the full border type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * When used as the rules of the Convolution layer, the layer skips the
+ * per-map convolutions and computes each pass over all input and output maps
+ * with one matrix product.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Unroll the patches of the given input that a filter of the given size is
+   * applied to (without padding) into the columns of a matrix.  The patch at
+   * row i and column j of the convolution output is stored in column
+   * (i + j * outputRows), and element (ki, kj) of the patch in input map m is
+   * stored in row (ki + kj * kW + m * kW * kH), which is the order of the
+   * elements of a cube of filters of size kW x kH x input.n_slices.
+   *
+   * @param input Input maps that the filter is applied to.
+   * @param kW Width of the filter (number of rows).
+   * @param kH Height of the filter (number of columns).
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param columns Matrix to store the patches in.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     arma::Mat<eT>& columns)
+  {
+    const size_t outputRows = (input.n_rows - kW) / dW + 1;
+    const size_t outputCols = (input.n_cols - kH) / dH + 1;
+
+    columns.set_size(kW * kH * input.n_slices, outputRows * outputCols);
+
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        eT* columnPtr = columns.colptr(i + j * outputRows);
+        for (size_t m = 0; m < input.n_slices; ++m)
+        {
+          for (size_t kj = 0; kj < kH; ++kj, columnPtr += kW)
+          {
+            const eT* inputPtr = input.slice_colptr(m, kj + j * dH) + i * dW;
+            std::copy(inputPtr, inputPtr + kW, columnPtr);
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * The inverse of Im2Col(): add every element of the given columns to the
+   * element of the output maps it was copied from.  The output must already
+   * have the size of the input that the columns were created from.
+   *
+   * @param columns Matrix of patches, as created by Im2Col().
+   * @param kW Width of the filter (number of rows).
+   * @param kH Height of the filter (number of columns).
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param output Output maps to add the patches to.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     arma::Cube<eT>& output)
+  {
+    const size_t outputRows = (output.n_rows - kW) / dW + 1;
+    const size_t outputCols = (output.n_cols - kH) / dH + 1;
+
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        const eT* columnPtr = columns.colptr(i + j * outputRows);
+        for (size_t m = 0; m < output.n_slices; ++m)
+        {
+          for (size_t kj = 0; kj < kH; ++kj)
+          {
+            eT* outputPtr = output.slice_colptr(m, kj + j * dH) + i * dW;
+            for (size_t ki = 0; ki < kW; ++ki, ++columnPtr, ++outputPtr)
+              *outputPtr += *columnPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1)
+  {
+    // Treat the input as a cube with a single map, without copying it.
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> columns;
+    Im2Col(inputCube, filter.n_rows, filter.n_cols, dW, dH, columns);
+
+    output.set_size((input.n_rows - filter.n_rows) / dW + 1,
+        (input.n_cols - filter.n_cols) / dH + 1);
+    arma::Row<eT> outputRow(output.memptr(), output.n_elem, false, true);
+    outputRow = arma::vectorise(filter).t() * columns;
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1)
+  {
+    const size_t outputRows = (input.n_rows + 2 * (filter.n_rows - 1)) * dW;
+    const size_t outputCols = (input.n_cols + 2 * (filter.n_cols - 1)) * dH;
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat(filter.n_rows - 1, filter.n_cols - 1,
+        filter.n_rows - 1 + input.n_rows - 1,
+        filter.n_cols - 1 + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH);
+    }
+  }
+
+};  // class Im2ColConvolution
+
+/**
+ * Whether or not the given convolution rule is an Im2ColConvolution.  The
+ * Convolution layer uses this to compute its passes directly on the unrolled
+ * input.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+//! Im2ColConvolution is an Im2ColConvolution.
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
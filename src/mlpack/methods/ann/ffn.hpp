@@ -154,6 +154,25 @@ class FFN
                   const size_t i,
                   const bool deterministic = true);
 
+  /**
+   * Evaluate the feedforward network with the given parameters on the batch of
+   * points [begin, begin + batchSize).  If every layer of the network is able
+   * to process several columns at once, the whole batch is passed through the
+   * network in a single forward pass, so that e.g. the Linear layer performs a
+   * matrix-matrix product.  Otherwise the points are evaluated one by one.
+   * The returned objective is the sum of the objectives of the points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the first point to use for the evaluation.
+   * @param batchSize Number of points to use for the evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic);
+
   /**
    * Evaluate the gradient of the feedforward network with the given parameters,
    * and with respect to only one point in the dataset. This is useful for
@@ -167,6 +186,23 @@ class FFN
                 const size_t i,
                 arma::mat& gradient);
 
+  /**
+   * Evaluate the gradient of the feedforward network with the given parameters,
+   * and with respect to the batch of points [begin, begin + batchSize).  The
+   * batch is propagated forward and backward through the network at once if
+   * all layers support it; the resulting gradient is the sum of the gradients
+   * of the individual points.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the first point to use for the gradient evaluation.
+   * @param batchSize Number of points to use for the gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient);
+
   /**
    * Compute the gradient of the feedforward network based on given input and target.
    *
@@ -251,6 +287,12 @@ private:
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Return true if every layer of the network is able to process a batch of
+   * points (several columns) in a single pass.
+   */
+  bool BatchSupport();
+
   /**
    * Swap the content of this network with given network.
    *
@@ -17,6 +17,7 @@
 
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
+#include "visitor/batch_support_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
@@ -147,6 +148,15 @@ void FFN<OutputLayerType, InitializationRuleType>::Predict(
     ResetDeterministic();
   }
 
+  // Pass all points through the network at once if possible.
+  if (BatchSupport())
+  {
+    Forward(std::move(arma::mat(predictors.memptr(), predictors.n_rows,
+        predictors.n_cols, false, true)));
+    results = boost::apply_visitor(outputParameterVisitor, network.back());
+    return;
+  }
+
   arma::mat resultsTemp;
   Forward(std::move(arma::mat(predictors.colptr(0),
       predictors.n_rows, 1, false, true)));
@@ -169,7 +179,17 @@ void FFN<OutputLayerType, InitializationRuleType>::Predict(
 
 template<typename OutputLayerType, typename InitializationRuleType>
 double FFN<OutputLayerType, InitializationRuleType>::Evaluate(
-    const arma::mat& /* parameters */, const size_t i, const bool deterministic)
+    const arma::mat& parameters, const size_t i, const bool deterministic)
+{
+  return Evaluate(parameters, i, 1, deterministic);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+double FFN<OutputLayerType, InitializationRuleType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    const bool deterministic)
 {
   if (parameter.is_empty())
   {
@@ -182,8 +202,19 @@ double FFN<OutputLayerType, InitializationRuleType>::Evaluate(
     ResetDeterministic();
   }
 
-  currentInput = predictors.unsafe_col(i);
-  currentTarget = responses.unsafe_col(i);
+  // Fall back to one forward pass per point if any of the layers can't handle
+  // more than a single column.
+  if (batchSize > 1 && !BatchSupport())
+  {
+    double res = 0;
+    for (size_t i = begin; i < begin + batchSize; ++i)
+      res += Evaluate(parameters, i, 1, deterministic);
+
+    return res;
+  }
+
+  currentInput = predictors.cols(begin, begin + batchSize - 1);
+  currentTarget = responses.cols(begin, begin + batchSize - 1);
 
   Forward(std::move(currentInput));
   double res = outputLayer.Forward(std::move(boost::apply_visitor(
@@ -195,6 +226,16 @@ double FFN<OutputLayerType, InitializationRuleType>::Evaluate(
 template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::Gradient(
     const arma::mat& parameters, const size_t i, arma::mat& gradient)
+{
+  Gradient(parameters, i, 1, gradient);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType>
+void FFN<OutputLayerType, InitializationRuleType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& gradient)
 {
   if (gradient.is_empty())
   {
@@ -210,7 +251,21 @@ void FFN<OutputLayerType, InitializationRuleType>::Gradient(
     gradient.zeros();
   }
 
-  Evaluate(parameters, i, false);
+  // Accumulate the gradients point by point if any of the layers can't handle
+  // more than a single column.
+  if (batchSize > 1 && !BatchSupport())
+  {
+    arma::mat pointGradient;
+    for (size_t i = begin; i < begin + batchSize; ++i)
+    {
+      Gradient(parameters, i, 1, pointGradient);
+      gradient += pointGradient;
+    }
+
+    return;
+  }
+
+  Evaluate(parameters, begin, batchSize, false);
 
   outputLayer.Backward(std::move(boost::apply_visitor(outputParameterVisitor,
       network.back())), std::move(currentTarget), std::move(error));
@@ -260,6 +315,19 @@ void FFN<OutputLayerType, InitializationRuleType>::ResetGradients(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType>
+bool FFN<OutputLayerType, InitializationRuleType>::BatchSupport()
+{
+  BatchSupportVisitor batchSupportVisitor;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    if (!boost::apply_visitor(batchSupportVisitor, network[i]))
+      return false;
+  }
+
+  return true;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType>
 void FFN<OutputLayerType, InitializationRuleType>::Forward(arma::mat&& input)
 {
@@ -37,18 +37,18 @@ void Constant<InputDataType, OutputDataType>::Forward(
 {
   if (inSize == 0)
   {
-    inSize = input.n_elem;
+    inSize = input.n_rows;
   }
 
-  output = constantOutput;
+  output = arma::repmat(constantOutput, 1, input.n_cols);
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename DataType>
 void Constant<InputDataType, OutputDataType>::Backward(
-    const DataType&& /* input */, DataType&& /* gy */, DataType&& g)
+    const DataType&& /* input */, DataType&& gy, DataType&& g)
 {
-  g = arma::zeros<DataType>(inSize, 1);
+  g = arma::zeros<DataType>(inSize, gy.n_cols);
 }
 
 template<typename InputDataType, typename OutputDataType>
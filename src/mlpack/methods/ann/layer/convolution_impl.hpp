@@ -123,29 +123,50 @@ void Convolution<
   size_t wConv = ConvOutSize(inputWidth, kW, dW, padW);
   size_t hConv = ConvOutSize(inputHeight, kH, dH, padH);
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(wConv, hConv, outSize);
-
-  for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
   {
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput;
+    // Unroll the input patches once, and compute all output maps with a
+    // single matrix product.  The filters of each output map are stored one
+    // after another, so the weights form a matrix with one column per output
+    // map.  The patches are kept for the gradient.
+    Im2ColConvolution<ValidConvolution>::Im2Col((padW != 0 || padH != 0) ?
+        inputPaddedTemp : inputTemp, kW, kH, dW, dH, inputColumns);
+
+    const arma::Mat<eT> filters(weight.memptr(), kW * kH * inSize, outSize,
+        false, true);
+
+    outputTemp.set_size(wConv, hConv, outSize);
+    arma::Mat<eT> outputMaps(outputTemp.memptr(), wConv * hConv, outSize,
+        false, true);
+    outputMaps = inputColumns.t() * filters;
+    outputMaps.each_row() += bias.t();
+  }
+  else
+  {
+    outputTemp = arma::zeros<arma::Cube<eT> >(wConv, hConv, outSize);
 
-      if (padW != 0 || padH != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap),
-            weight.slice(outMapIdx), convOutput, dW, dH);
-      }
-      else
+    for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap),
-            weight.slice(outMapIdx), convOutput, dW, dH);
+        arma::Mat<eT> convOutput;
+
+        if (padW != 0 || padH != 0)
+        {
+          ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap),
+              weight.slice(outMapIdx), convOutput, dW, dH);
+        }
+        else
+        {
+          ForwardConvolutionRule::Convolution(inputTemp.slice(inMap),
+              weight.slice(outMapIdx), convOutput, dW, dH);
+        }
+
+        outputTemp.slice(outMap) += convOutput;
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      outputTemp.slice(outMap) += bias(outMap);
     }
-
-    outputTemp.slice(outMap) += bias(outMap);
   }
 
   output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem, 1);
@@ -171,6 +192,37 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Map the error of every output pixel back to the input patches with a
+    // single matrix product, and add the patches to the (padded) input maps
+    // they came from.
+    const arma::Mat<eT> mappedError(gy.memptr(), outputWidth * outputHeight,
+        outSize, false, true);
+    const arma::Mat<eT> filters(weight.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    const arma::Mat<eT> columns = filters * mappedError.t();
+
+    arma::Cube<eT> paddedError = arma::zeros<arma::Cube<eT> >(
+        inputTemp.n_rows + 2 * padW, inputTemp.n_cols + 2 * padH, inSize);
+    Im2ColConvolution<ValidConvolution>::Col2Im(columns, kW, kH, dW, dH,
+        paddedError);
+
+    if (padW != 0 || padH != 0)
+    {
+      gTemp = paddedError.subcube(padW, padH, 0,
+          padW + inputTemp.n_rows - 1, padH + inputTemp.n_cols - 1,
+          inSize - 1);
+    }
+    else
+    {
+      gTemp = std::move(paddedError);
+    }
+
+    g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+    return;
+  }
+
   arma::cube mappedError = arma::cube(gy.memptr(),
         outputWidth, outputHeight, outSize);
   gTemp = arma::zeros<arma::Cube<eT> >(inputTemp.n_rows,
@@ -223,6 +275,30 @@ void Convolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    // The gradient of all filters is the product of the input patches and the
+    // error of every output pixel.  The patches are unrolled again only if the
+    // forward pass didn't do so.
+    if (!IsIm2ColConvolution<ForwardConvolutionRule>::value)
+    {
+      Im2ColConvolution<ValidConvolution>::Im2Col((padW != 0 || padH != 0) ?
+          inputPaddedTemp : inputTemp, kW, kH, dW, dH, inputColumns);
+    }
+
+    const arma::Mat<eT> mappedError(error.memptr(), outputWidth * outputHeight,
+        outSize, false, true);
+
+    // The filter gradient is stored in the same order as the weights.
+    arma::Mat<eT> filterGradient(gradient.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    filterGradient = inputColumns * mappedError;
+
+    gradient.submat(weight.n_elem, 0, weight.n_elem + outSize - 1, 0) =
+        arma::sum(mappedError).t();
+    return;
+  }
+
   arma::cube mappedError;
   if (padW != 0 && padH != 0)
   {
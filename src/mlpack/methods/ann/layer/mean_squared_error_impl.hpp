@@ -29,7 +29,9 @@ template<typename eT>
 double MeanSquaredError<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, const arma::Mat<eT>&& target)
 {
-  return arma::mean(arma::mean(arma::square(input - target)));
+  // Sum the per-point errors, so that a batch gives the same objective as the
+  // sum over the individual points.
+  return arma::accu(arma::mean(arma::square(input - target)));
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -65,7 +65,7 @@ void PReLU<InputDataType, OutputDataType>::Gradient(
   }
 
   arma::mat zeros = arma::zeros<arma::mat>(input.n_rows, input.n_cols);
-  gradient(0) = arma::accu(error % arma::min(zeros, input)) / input.n_cols;
+  gradient(0) = arma::accu(error % arma::min(zeros, input));
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -0,0 +1,99 @@
+/**
+ * @file batch_support_visitor.hpp
+ * @author Marcus Edel
+ *
+ * This file provides an abstraction to check whether a layer is able to
+ * process several input columns (a batch) in a single Forward(), Backward()
+ * and Gradient() call.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_BATCH_SUPPORT_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_BATCH_SUPPORT_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * BatchSupportVisitor returns true if the given module treats every column of
+ * the input as an independent point, so that a whole block of points can be
+ * passed through the module at once.  Modules that interpret the input as a
+ * single image or sequence (e.g. Convolution, MaxPooling, LSTM) return false.
+ */
+class BatchSupportVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Modules are assumed to work on a single column unless stated otherwise.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  //! The Add module adds the bias to every column.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(Add<InputDataType, OutputDataType>* layer) const;
+
+  //! The activation functions are applied elementwise.
+  template<
+      class ActivationFunction,
+      typename InputDataType,
+      typename OutputDataType
+  >
+  bool operator()(BaseLayer<ActivationFunction, InputDataType,
+      OutputDataType>* layer) const;
+
+  //! The Constant module replicates the constant for every column.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(Constant<InputDataType, OutputDataType>* layer) const;
+
+  //! The Dropout mask is drawn elementwise.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(Dropout<InputDataType, OutputDataType>* layer) const;
+
+  //! The ELU activation is applied elementwise.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(ELU<InputDataType, OutputDataType>* layer) const;
+
+  //! The HardTanH activation is applied elementwise.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(HardTanH<InputDataType, OutputDataType>* layer) const;
+
+  //! The LeakyReLU activation is applied elementwise.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(LeakyReLU<InputDataType, OutputDataType>* layer) const;
+
+  //! The Linear module turns a batch into a single matrix-matrix product.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(Linear<InputDataType, OutputDataType>* layer) const;
+
+  //! The LinearNoBias module turns a batch into a single matrix-matrix
+  //! product.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(LinearNoBias<InputDataType, OutputDataType>* layer) const;
+
+  //! The LogSoftMax module normalizes every column independently.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(LogSoftMax<InputDataType, OutputDataType>* layer) const;
+
+  //! The MultiplyConstant module is applied elementwise.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(MultiplyConstant<InputDataType, OutputDataType>* layer)
+      const;
+
+  //! The PReLU activation is applied elementwise.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(PReLU<InputDataType, OutputDataType>* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "batch_support_visitor_impl.hpp"
+
+#endif
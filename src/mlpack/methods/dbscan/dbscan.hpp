@@ -15,6 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
 
@@ -42,6 +43,13 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * By default, the neighbors of all points are found with one batched range
+ * search.  The clusters are then formed by joining every pair of neighboring
+ * core points with a union-find structure (in parallel, if OpenMP is
+ * available), and each border point is assigned to the cluster of its nearest
+ * core point.  The PointSelectionPolicy is only used if batch mode is turned
+ * off, in which case the clusters are expanded from one point at a time.
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -58,11 +66,15 @@ class DBSCAN
    * @param minPoints Minimum number of points for each cluster.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param batchMode If true, all clusters are found at once from the results
+   *     of one batched range search; otherwise, the clusters are expanded from
+   *     one point at a time.
    */
   DBSCAN(const double epsilon,
          const size_t minPoints,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const bool batchMode = true);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -104,6 +116,11 @@ class DBSCAN
                  arma::Row<size_t>& assignments,
                  arma::mat& centroids);
 
+  //! Get whether batch mode is used.
+  bool BatchMode() const { return batchMode; }
+  //! Modify whether batch mode is used.
+  bool& BatchMode() { return batchMode; }
+
  private:
   //! Maximum distance between two points to be part of same cluster.
   double epsilon;
@@ -112,12 +129,29 @@ class DBSCAN
   //! itself) for the point to be a core-point.
   size_t minPoints;
 
+  //! Whether to find all clusters at once from one batched range search.
+  bool batchMode;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
   //! Instantiated point selection policy.
   PointSelectionPolicy pointSelector;
 
+  /**
+   * Find all clusters at once.  The neighbors of every point are found with one
+   * range search, the core points that are neighbors of each other are joined
+   * with a concurrent union-find structure, and then each border point is
+   * assigned to the cluster of its nearest core point.  Clusters are numbered
+   * in the order of their first point.
+   *
+   * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   */
+  template<typename MatType>
+  size_t BatchCluster(const MatType& data, arma::Row<size_t>& assignments);
+
   /**
    * This function processes the point at index. It  marks the point as visited,
    * checks if the given point is core or non-core.  If it is a core point, it
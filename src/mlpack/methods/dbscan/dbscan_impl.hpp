@@ -25,9 +25,11 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const double epsilon,
     const size_t minPoints,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const bool batchMode) :
     epsilon(epsilon),
     minPoints(minPoints),
+    batchMode(batchMode),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -98,6 +100,9 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
+  if (batchMode)
+    return BatchCluster(data, assignments);
+
   assignments.set_size(data.n_cols);
   assignments.fill(SIZE_MAX);
 
@@ -129,6 +134,104 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
   return currentCluster;
 }
 
+/**
+ * Find all clusters at once, from the results of one batched range search.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType>
+size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
+    const MatType& data,
+    arma::Row<size_t>& assignments)
+{
+  assignments.set_size(data.n_cols);
+  assignments.fill(SIZE_MAX);
+
+  // Find the neighbors of all points at once.  The results are stored in flat
+  // arrays, and don't include the point itself.
+  std::vector<size_t> offsets;
+  std::vector<size_t> neighbors;
+  std::vector<double> distances;
+  Log::Debug << "Performing range search." << std::endl;
+  rangeSearch.Train(data);
+  rangeSearch.Search(math::Range(0.0, epsilon), offsets, neighbors, distances);
+  Log::Debug << "Range search complete." << std::endl;
+
+  // A point is a core point if its epsilon-neighborhood (including itself)
+  // holds at least minPoints points.
+  boost::dynamic_bitset<> core(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    core[i] = (offsets[i + 1] - offsets[i] + 1 >= minPoints);
+
+  // Join every pair of neighboring core points.  Each pair is found twice, so
+  // only the pairs with the larger index as the neighbor are used.  On the
+  // Visual Studio compiler, we have to use intmax_t because size_t is not yet
+  // supported by their OpenMP implementation.
+  emst::ConcurrentUnionFind uf(data.n_cols);
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+  #else
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (size_t i = 0; i < data.n_cols; ++i)
+  #endif
+  {
+    if (!core[i])
+      continue;
+
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      if ((neighbors[j] > (size_t) i) && core[neighbors[j]])
+        uf.Union(i, neighbors[j]);
+  }
+
+  // The component of each core point is named after its first point, so the
+  // clusters can be numbered in one pass over the points.
+  size_t numClusters = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (!core[i])
+      continue;
+
+    const size_t root = uf.Find(i);
+    assignments[i] = (root == i) ? numClusters++ : assignments[root];
+  }
+
+  // Now assign each border point to the cluster of its nearest core point.
+  // Points that are not near any core point are noise.
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+  #else
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (size_t i = 0; i < data.n_cols; ++i)
+  #endif
+  {
+    if (core[i])
+      continue;
+
+    double bestDistance = DBL_MAX;
+    size_t bestNeighbor = SIZE_MAX;
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+    {
+      if (!core[neighbors[j]])
+        continue;
+
+      if ((distances[j] < bestDistance) || ((distances[j] == bestDistance) &&
+          (neighbors[j] < bestNeighbor)))
+      {
+        bestDistance = distances[j];
+        bestNeighbor = neighbors[j];
+      }
+    }
+
+    if (bestNeighbor != SIZE_MAX)
+      assignments[i] = assignments[bestNeighbor];
+  }
+
+  Log::Debug << numClusters << " clusters found." << std::endl;
+
+  return numClusters;
+}
+
 /**
  * This function processes the point at index. It marks the point as visited,
  * checks if the given point is core or non-core. If it is a core point, it
@@ -44,6 +44,11 @@ PROGRAM_INFO("DBSCAN clustering",
     "default dual-tree search), and --naive will force brute-force range "
     "search."
     "\n\n"
+    "By default, the neighbors of all points are found with one batched range "
+    "search, and all clusters are then formed at once.  If --single_point_mode"
+    " is specified, the clusters are instead expanded from one point at a "
+    "time."
+    "\n\n"
     "An example usage to run DBSCAN on the dataset in input.csv with a radius "
     "of 0.5 and a minimum cluster size of 5 is given below:"
     "\n\n"
@@ -65,6 +70,8 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_FLAG("single_point_mode", "If set, the clusters are expanded from one "
+    "point at a time, instead of being formed all at once.", "p");
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType>
@@ -80,7 +87,8 @@ void RunDBSCAN(RangeSearchType rs = RangeSearchType())
   const double epsilon = CLI::GetParam<double>("epsilon");
   const size_t minSize = (size_t) CLI::GetParam<int>("min_size");
 
-  DBSCAN<RangeSearchType> d(epsilon, minSize, rs);
+  DBSCAN<RangeSearchType> d(epsilon, minSize, rs, RandomPointSelection(),
+      !CLI::HasParam("single_point_mode"));
 
   // If possible, avoid the overhead of calculating centroids.
   arma::Row<size_t> assignments;
@@ -0,0 +1,47 @@
+/**
+ * @file all_dimension_select.hpp
+ * @author Ryan Curtin
+ *
+ * Selects all dimensions for a split.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_ALL_DIMENSION_SELECT_HPP
+#define MLPACK_METHODS_DECISION_TREE_ALL_DIMENSION_SELECT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This dimension selection policy allows any dimension to be selected for a
+ * split; this is the behavior of a standard decision tree.
+ */
+class AllDimensionSelect
+{
+ public:
+  /**
+   * Select every dimension.
+   *
+   * @param dimensionality Number of dimensions of the data.
+   * @param dimensions Vector to store the selected dimensions in.
+   */
+  void Select(const size_t dimensionality, std::vector<size_t>& dimensions)
+  {
+    dimensions.resize(dimensionality);
+    for (size_t i = 0; i < dimensionality; ++i)
+      dimensions[i] = i;
+  }
+
+  //! Children select every dimension too.
+  AllDimensionSelect Child() { return AllDimensionSelect(); }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -34,7 +34,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   arma::uvec sortedIndices = arma::sort_index(data);
   arma::Row<size_t> sortedLabels(labels.n_elem);
   for (size_t i = 0; i < sortedLabels.n_elem; ++i)
-    sortedLabels[sortedIndices[i]] = labels[i];
+    sortedLabels[i] = labels[sortedIndices[i]];
 
   // Loop through all possible split points, choosing the best one.  Also, force
   // a minimum leaf size of 1 (empty children don't make sense).
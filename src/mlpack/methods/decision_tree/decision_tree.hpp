@@ -16,7 +16,11 @@
 #include <mlpack/prereqs.hpp>
 #include "gini_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "numeric_split_traits.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
+#include "all_dimension_select.hpp"
+#include "random_dimension_select.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -27,12 +31,33 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * The DimensionSelectionType chooses the dimensions that are searched for the
+ * split of each node.  It must provide the following functions:
+ *
+ *  - void Select(const size_t dimensionality, std::vector<size_t>& dims):
+ *    fill dims with the dimensions to search for the split of the next node,
+ *    in increasing order.
+ *  - DimensionSelectionType Child(): return the selector to use for a child
+ *    of the node that the last call to Select() was for.
+ *
+ * By default, all dimensions are searched (AllDimensionSelect); random
+ * forests search a random subset of the dimensions at each node
+ * (RandomDimensionSelect).
+ *
+ * If the numeric split type can search histograms (see NumericSplitTraits),
+ * each numeric dimension of the dataset is binned once before training, and
+ * the numeric dimensions of each node are searched through the histograms of
+ * the class counts in each bin.  Only the histograms of the smaller children of
+ * a node are counted from their points; the histograms of the largest child are
+ * the histograms of the node minus those of the other children.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
          template<typename> class CategoricalSplitType = AllCategoricalSplit,
          typename ElemType = double,
-         bool NoRecursion = false>
+         bool NoRecursion = false,
+         typename DimensionSelectionType = AllDimensionSelect>
 class DecisionTree :
     public NumericSplitType<FitnessFunction>::template
         AuxiliarySplitInfo<ElemType>,
@@ -56,13 +81,16 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename LabelsType>
   DecisionTree(MatType&& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType&& labels,
                const size_t numClasses,
-               const size_t minimumLeafSize = 10);
+               const size_t minimumLeafSize = 10,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
 
   /**
    * Construct the decision tree on the given data and labels, assuming that the
@@ -74,12 +102,15 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename LabelsType>
   DecisionTree(MatType&& data,
                LabelsType&& labels,
                const size_t numClasses,
-               const size_t minimumLeafSize = 10);
+               const size_t minimumLeafSize = 10,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
 
   /**
    * Construct a decision tree without training it.  It will be a leaf node with
@@ -135,13 +166,16 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename LabelsType>
   void Train(MatType&& data,
              const data::DatasetInfo& datasetInfo,
              LabelsType&& labels,
              const size_t numClasses,
-             const size_t minimumLeafSize = 10);
+             const size_t minimumLeafSize = 10,
+             DimensionSelectionType dimensionSelector =
+                 DimensionSelectionType());
 
   /**
    * Train the decision tree on the given data, assuming that all dimensions are
@@ -153,12 +187,15 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename LabelsType>
   void Train(MatType&& data,
              LabelsType&& labels,
              const size_t numClasses,
-             const size_t minimumLeafSize = 10);
+             const size_t minimumLeafSize = 10,
+             DimensionSelectionType dimensionSelector =
+                 DimensionSelectionType());
 
   /**
    * Classify the given point, using the entire tree.  The predicted label is
@@ -258,6 +295,34 @@ class DecisionTree :
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
 
+  //! Whether the numeric split type can search histograms.
+  typedef std::integral_constant<bool,
+      NumericSplitTraits<NumericSplit>::UsesHistograms> UsesHistograms;
+
+  /**
+   * The binned dataset, used if the numeric split type can search histograms.
+   * The columns of the bins are reordered along with the points of the
+   * dataset.
+   */
+  struct Bins
+  {
+    //! The bin of each value of the dataset.
+    arma::Mat<unsigned char> bins;
+    //! The split value between each bin and the next, for each dimension.
+    std::vector<arma::vec> splitValues;
+    //! The numeric dimensions with more than one bin.
+    std::vector<size_t> dimensions;
+    //! The largest number of bins of any dimension.
+    size_t maxBins;
+  };
+
+  //! Nodes holding at least this many points search the dimensions for the
+  //! best split in parallel.
+  static const size_t parallelSplitThreshold = 10000;
+  //! Nodes holding at least this many points (but fewer than
+  //! parallelSplitThreshold) build their children as separate OpenMP tasks.
+  static const size_t parallelBuildThreshold = 1000;
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -265,6 +330,246 @@ class DecisionTree :
   void CalculateClassProbabilities(const RowType& labels,
                                    const size_t numClasses);
 
+  /**
+   * Check if the given dimension of the points in a node can be split in a way
+   * that improves on 'bestGain', with the numeric or categorical split type,
+   * depending on the type of the dimension.  The improved gain is returned, or
+   * 'bestGain' if there is no improvement.  If a split is found, probabilities
+   * and the auxiliary split information of the split type may be modified.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      the node.
+   * @param count Number of points in the node.
+   * @param datasetInfo Type information for each dimension (NULL if all
+   *      dimensions are numeric).
+   * @param labels Labels of the points in the node.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimension Dimension to check.
+   * @param bestGain Best gain seen so far.
+   * @param probabilities Split information of the split type.
+   * @param numericAux Auxiliary split information of the numeric split type.
+   * @param categoricalAux Auxiliary split information of the categorical split
+   *      type.
+   * @param bins Binned dataset (NULL if histograms aren't used).
+   * @param histograms Histograms of the node (NULL if histograms aren't used).
+   */
+  template<typename MatType>
+  static double DimensionSplitIfBetter(
+      const MatType& data,
+      const size_t begin,
+      const size_t count,
+      const data::DatasetInfo* datasetInfo,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const size_t minimumLeafSize,
+      const size_t dimension,
+      const double bestGain,
+      arma::vec& probabilities,
+      NumericAuxiliarySplitInfo& numericAux,
+      CategoricalAuxiliarySplitInfo& categoricalAux,
+      const Bins* bins,
+      const arma::Cube<size_t>* histograms);
+
+  /**
+   * Search the histogram of a numeric dimension for a split with the numeric
+   * split type.
+   */
+  static double HistogramSplitIfBetter(const double bestGain,
+                                       const arma::Mat<size_t>& histogram,
+                                       const arma::vec& splitValues,
+                                       const size_t minimumLeafSize,
+                                       arma::vec& probabilities,
+                                       NumericAuxiliarySplitInfo& numericAux,
+                                       std::true_type /* usesHistograms */);
+
+  /**
+   * This is never called, since histograms are only used if the numeric split
+   * type can search them.
+   */
+  static double HistogramSplitIfBetter(const double bestGain,
+                                       const arma::Mat<size_t>& histogram,
+                                       const arma::vec& splitValues,
+                                       const size_t minimumLeafSize,
+                                       arma::vec& probabilities,
+                                       NumericAuxiliarySplitInfo& numericAux,
+                                       std::false_type /* usesHistograms */);
+
+  /**
+   * Bin each numeric dimension of the dataset with the numeric split type.
+   *
+   * @param data Dataset to bin.
+   * @param datasetInfo Type information for each dimension (NULL if all
+   *      dimensions are numeric).
+   * @param bins This will be filled with the binned dataset.
+   */
+  template<typename MatType>
+  static void BinData(const MatType& data,
+                      const data::DatasetInfo* datasetInfo,
+                      Bins& bins,
+                      std::true_type /* usesHistograms */);
+
+  /**
+   * This is never called, since histograms are only used if the numeric split
+   * type can search them.
+   */
+  template<typename MatType>
+  static void BinData(const MatType& data,
+                      const data::DatasetInfo* datasetInfo,
+                      Bins& bins,
+                      std::false_type /* usesHistograms */);
+
+  /**
+   * Count the points of each class in each bin of each binned dimension, for
+   * the points of a node.  Slice i of the histograms holds the counts of
+   * dimension i, with one row for each class and one column for each bin.
+   *
+   * @param bins Binned dataset.
+   * @param labels Labels for each training point.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      the node.
+   * @param count Number of points in the node.
+   * @param numClasses Number of classes in the dataset.
+   * @param histograms This will be filled with the histograms of the node.
+   */
+  static void BuildHistograms(const Bins& bins,
+                              const arma::Row<size_t>& labels,
+                              const size_t begin,
+                              const size_t count,
+                              const size_t numClasses,
+                              arma::Cube<size_t>& histograms);
+
+  /**
+   * Find the dimension with the best split of the points in a node, among the
+   * dimensions chosen by the dimension selection policy, and store the split
+   * information in classProbabilities and the auxiliary split information.
+   * The dimensions are checked in order, and a dimension is only chosen if it
+   * improves on the best gain of the dimensions before it.  At large nodes,
+   * all dimensions are checked in parallel against the gain of the node, and
+   * the results are then combined in order; this gives the same split as the
+   * serial search, as long as the split types never find a better split when
+   * they are given a higher gain to improve on.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      the node.
+   * @param count Number of points in the node.
+   * @param datasetInfo Type information for each dimension (NULL if all
+   *      dimensions are numeric).
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Dimension selection policy of the node.
+   * @param bestGain Gain of the node; this will be set to the gain of the best
+   *      split.
+   * @param bins Binned dataset (NULL if histograms aren't used).
+   * @param histograms Histograms of the node (NULL if histograms aren't used).
+   * @return The dimension to split, or the dimensionality if no split improves
+   *      on the gain of the node.
+   */
+  template<typename MatType>
+  size_t FindBestSplit(const MatType& data,
+                       const size_t begin,
+                       const size_t count,
+                       const data::DatasetInfo* datasetInfo,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       const size_t minimumLeafSize,
+                       DimensionSelectionType& dimensionSelector,
+                       double& bestGain,
+                       const Bins* bins,
+                       const arma::Cube<size_t>* histograms);
+
+  /**
+   * Reorder the points of a node so that the points of each child are
+   * contiguous, and build the children.  The children hold disjoint ranges of
+   * the dataset, so they are built as separate OpenMP tasks if the node is
+   * small enough; a node that isn't in a parallel region yet opens one for the
+   * tasks of its whole subtree.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      this node.
+   * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension (NULL if all
+   *      dimensions are numeric).
+   * @param labels Labels for each training point.
+   * @param childAssignments Child of each point in this node; this is
+   *      reordered along with the points.
+   * @param numChildren Number of children.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Dimension selection policy of this node.
+   * @param bins Binned dataset (NULL if histograms aren't used); its columns
+   *      are reordered along with the points.
+   * @param histograms Histograms of this node (NULL if histograms aren't
+   *      used); these are taken over by the largest child.
+   */
+  template<typename MatType>
+  void BuildChildren(MatType& data,
+                     const size_t begin,
+                     const size_t count,
+                     const data::DatasetInfo* datasetInfo,
+                     arma::Row<size_t>& labels,
+                     arma::Row<size_t>& childAssignments,
+                     const size_t numChildren,
+                     const size_t numClasses,
+                     const size_t minimumLeafSize,
+                     DimensionSelectionType& dimensionSelector,
+                     Bins* bins,
+                     arma::Cube<size_t>* histograms);
+
+  /**
+   * Build the children of this node, whose points are in the given contiguous
+   * ranges of the dataset, each in a separate OpenMP task if it is large
+   * enough.  This returns when all children are built.
+   *
+   * @param data Dataset to train on.
+   * @param childBegins Index of the first point of each child, followed by
+   *      the index after the last point of the last child.
+   * @param datasetInfo Type information for each dimension (NULL if all
+   *      dimensions are numeric).
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param childSelectors Dimension selection policy of each child.
+   * @param bins Binned dataset (NULL if histograms aren't used).
+   * @param childHistograms Histograms of each child (empty if histograms
+   *      aren't used).
+   */
+  template<typename MatType>
+  void BuildChildTasks(MatType& data,
+                       const std::vector<size_t>& childBegins,
+                       const data::DatasetInfo* datasetInfo,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       const size_t minimumLeafSize,
+                       std::vector<DimensionSelectionType>& childSelectors,
+                       Bins* bins,
+                       std::vector<arma::Cube<size_t>>& childHistograms);
+
+  /**
+   * Train the tree on the whole dataset.  If the numeric split type can search
+   * histograms, the dataset is binned and the histograms of the root are
+   * counted first.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Type information for each dimension (NULL if all
+   *      dimensions are numeric).
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Dimension selection policy of the root.
+   */
+  template<typename MatType>
+  void TrainRoot(MatType& data,
+                 const data::DatasetInfo* datasetInfo,
+                 arma::Row<size_t>& labels,
+                 const size_t numClasses,
+                 const size_t minimumLeafSize,
+                 DimensionSelectionType& dimensionSelector);
+
   /**
    * Corresponding to the public constructor, this method is designed for
    * avoiding unnecessary copies during training.  This constructor is called to
@@ -278,6 +583,9 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Dimension selection policy of this node.
+   * @param bins Binned dataset (NULL if histograms aren't used).
+   * @param histograms Histograms of this node (NULL if histograms aren't used).
    */
   template<typename MatType>
   DecisionTree(MatType& data,
@@ -286,7 +594,10 @@ class DecisionTree :
                const data::DatasetInfo& datasetInfo,
                arma::Row<size_t>& labels,
                const size_t numClasses,
-               const size_t minimumLeafSize = 10);
+               const size_t minimumLeafSize,
+               DimensionSelectionType& dimensionSelector,
+               Bins* bins,
+               arma::Cube<size_t>* histograms);
 
   /**
    * Corresponding to the public constructor, this method is designed for
@@ -300,6 +611,9 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Dimension selection policy of this node.
+   * @param bins Binned dataset (NULL if histograms aren't used).
+   * @param histograms Histograms of this node (NULL if histograms aren't used).
    */
   template<typename MatType>
   DecisionTree(MatType& data,
@@ -307,7 +621,10 @@ class DecisionTree :
                const size_t count,
                arma::Row<size_t>& labels,
                const size_t numClasses,
-               const size_t minimumLeafSize = 10);
+               const size_t minimumLeafSize,
+               DimensionSelectionType& dimensionSelector,
+               Bins* bins,
+               arma::Cube<size_t>* histograms);
 
   /**
    * Corresponding to the public Train() method, this method is designed for
@@ -322,6 +639,9 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Dimension selection policy of this node.
+   * @param bins Binned dataset (NULL if histograms aren't used).
+   * @param histograms Histograms of this node (NULL if histograms aren't used).
    */
   template<typename MatType>
   void Train(MatType& data,
@@ -330,7 +650,10 @@ class DecisionTree :
              const data::DatasetInfo& datasetInfo,
              arma::Row<size_t>& labels,
              const size_t numClasses,
-             const size_t minimumLeafSize = 10);
+             const size_t minimumLeafSize,
+             DimensionSelectionType& dimensionSelector,
+             Bins* bins,
+             arma::Cube<size_t>* histograms);
 
   /**
    * Corresponding to the public Train() method, this method is designed for
@@ -344,6 +667,9 @@ class DecisionTree :
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param dimensionSelector Dimension selection policy of this node.
+   * @param bins Binned dataset (NULL if histograms aren't used).
+   * @param histograms Histograms of this node (NULL if histograms aren't used).
    */
   template<typename MatType>
   void Train(MatType& data,
@@ -351,7 +677,10 @@ class DecisionTree :
              const size_t count,
              arma::Row<size_t>& labels,
              const size_t numClasses,
-             const size_t minimumLeafSize = 10);
+             const size_t minimumLeafSize,
+             DimensionSelectionType& dimensionSelector,
+             Bins* bins,
+             arma::Cube<size_t>* histograms);
 };
 
 /**
@@ -12,6 +12,10 @@
 #ifndef MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -20,17 +24,21 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType, typename LabelsType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType&& data,
-                                        const data::DatasetInfo& datasetInfo,
-                                        LabelsType&& labels,
-                                        const size_t numClasses,
-                                        const size_t minimumLeafSize)
+             NoRecursion,
+             DimensionSelectionType>::DecisionTree(
+    MatType&& data,
+    const data::DatasetInfo& datasetInfo,
+    LabelsType&& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector)
 {
   // copy or move data
   typedef typename std::remove_reference<MatType>::type TrueMatType;
@@ -38,8 +46,8 @@ DecisionTree<FitnessFunction,
   TrueMatType tmpData(std::forward<MatType>(data));
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   // Pass off work to the Train() method.
-  Train(tmpData, 0, tmpData.n_cols, datasetInfo, 
-      tmpLabels, numClasses, minimumLeafSize);
+  TrainRoot(tmpData, &datasetInfo, tmpLabels, numClasses, minimumLeafSize,
+      dimensionSelector);
 }
 
 //! Construct and train.
@@ -47,16 +55,20 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType, typename LabelsType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType&& data,
-                                        LabelsType&& labels,
-                                        const size_t numClasses,
-                                        const size_t minimumLeafSize)
+             NoRecursion,
+             DimensionSelectionType>::DecisionTree(
+    MatType&& data,
+    LabelsType&& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector)
 {
   // copy or move data
   typedef typename std::remove_reference<MatType>::type TrueMatType;
@@ -64,8 +76,8 @@ DecisionTree<FitnessFunction,
   TrueMatType tmpData(std::forward<MatType>(data));
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   // Pass off work to the Train() method.
-  Train(tmpData, 0, tmpData.n_cols, 
-      tmpLabels, numClasses, minimumLeafSize);
+  TrainRoot(tmpData, NULL, tmpLabels, numClasses, minimumLeafSize,
+      dimensionSelector);
 }
 
 //! Construct and train.
@@ -73,22 +85,29 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType& data,
-                                        const size_t begin,
-                                        const size_t count,
-                                        const data::DatasetInfo& datasetInfo,
-                                        arma::Row<size_t>& labels,
-                                        const size_t numClasses,
-                                        const size_t minimumLeafSize)
+             NoRecursion,
+             DimensionSelectionType>::DecisionTree(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo& datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector,
+    Bins* bins,
+    arma::Cube<size_t>* histograms)
 {
   // Pass off work to the Train() method.
-  Train(data, begin, count, datasetInfo, labels, numClasses, minimumLeafSize);
+  Train(data, begin, count, datasetInfo, labels, numClasses, minimumLeafSize,
+      dimensionSelector, bins, histograms);
 }
 
 //! Construct and train.
@@ -96,21 +115,28 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType& data,
-                                        const size_t begin,
-                                        const size_t count,
-                                        arma::Row<size_t>& labels,
-                                        const size_t numClasses,
-                                        const size_t minimumLeafSize)
+             NoRecursion,
+             DimensionSelectionType>::DecisionTree(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector,
+    Bins* bins,
+    arma::Cube<size_t>* histograms)
 {
   // Pass off work to the Train() method.
-  Train(data, begin, count, labels, numClasses, minimumLeafSize);
+  Train(data, begin, count, labels, numClasses, minimumLeafSize,
+      dimensionSelector, bins, histograms);
 }
 
 //! Construct, don't train.
@@ -118,12 +144,14 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::DecisionTree(const size_t numClasses) :
+             NoRecursion,
+             DimensionSelectionType>::DecisionTree(const size_t numClasses) :
     dimensionTypeOrMajorityClass(0),
     classProbabilities(numClasses)
 {
@@ -136,12 +164,14 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::DecisionTree(const DecisionTree& other) :
+             NoRecursion,
+             DimensionSelectionType>::DecisionTree(const DecisionTree& other) :
     NumericAuxiliarySplitInfo(other),
     CategoricalAuxiliarySplitInfo(other),
     splitDimension(other.splitDimension),
@@ -158,12 +188,14 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::DecisionTree(DecisionTree&& other) :
+             NoRecursion,
+             DimensionSelectionType>::DecisionTree(DecisionTree&& other) :
     NumericAuxiliarySplitInfo(std::move(other)),
     CategoricalAuxiliarySplitInfo(std::move(other)),
     children(std::move(other.children)),
@@ -180,17 +212,20 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>&
+             NoRecursion,
+             DimensionSelectionType>&
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::operator=(const DecisionTree& other)
+             NoRecursion,
+             DimensionSelectionType>::operator=(const DecisionTree& other)
 {
   // Clean memory if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -218,17 +253,20 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>&
+             NoRecursion,
+             DimensionSelectionType>&
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::operator=(DecisionTree&& other)
+             NoRecursion,
+             DimensionSelectionType>::operator=(DecisionTree&& other)
 {
   // Clean memory if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -256,12 +294,14 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 DecisionTree<FitnessFunction,
              NumericSplitType,
              CategoricalSplitType,
              ElemType,
-             NoRecursion>::~DecisionTree()
+             NoRecursion,
+             DimensionSelectionType>::~DecisionTree()
 {
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -272,17 +312,21 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType, typename LabelsType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Train(MatType&& data,
-                                      const data::DatasetInfo& datasetInfo,
-                                      LabelsType&& labels,
-                                      const size_t numClasses,
-                                      const size_t minimumLeafSize)
+                  NoRecursion,
+                  DimensionSelectionType>::Train(
+    MatType&& data,
+    const data::DatasetInfo& datasetInfo,
+    LabelsType&& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector)
 {
   // Sanity check on data.
   if (data.n_cols != labels.n_elem)
@@ -299,7 +343,8 @@ void DecisionTree<FitnessFunction,
   TrueMatType tmpData(std::forward<MatType>(data));
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   // Pass off work to the Train() method.
-  Train(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses, minimumLeafSize);
+  TrainRoot(tmpData, &datasetInfo, tmpLabels, numClasses, minimumLeafSize,
+      dimensionSelector);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -307,16 +352,20 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType, typename LabelsType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Train(MatType&& data,
-                                      LabelsType&& labels,
-                                      const size_t numClasses,
-                                      const size_t minimumLeafSize)
+                  NoRecursion,
+                  DimensionSelectionType>::Train(
+    MatType&& data,
+    LabelsType&& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector)
 {
   // Sanity check on data.
   if (data.n_cols != labels.n_elem)
@@ -333,8 +382,8 @@ void DecisionTree<FitnessFunction,
   TrueMatType tmpData(std::forward<MatType>(data));
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   // Pass off work to the Train() method.
-  Train(tmpData, 0, tmpData.n_cols,
-      tmpLabels, numClasses, minimumLeafSize);
+  TrainRoot(tmpData, NULL, tmpLabels, numClasses, minimumLeafSize,
+      dimensionSelector);
 }
 
 //! Train on the given data.
@@ -342,19 +391,25 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Train(MatType& data,
-                                      const size_t begin,
-                                      const size_t count,
-                                      const data::DatasetInfo& datasetInfo,
-                                      arma::Row<size_t>& labels,
-                                      const size_t numClasses,
-                                      const size_t minimumLeafSize)
+                  NoRecursion,
+                  DimensionSelectionType>::Train(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo& datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector,
+    Bins* bins,
+    arma::Cube<size_t>* histograms)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -366,38 +421,11 @@ void DecisionTree<FitnessFunction,
   // numericAux and categoricalAux (and clear them later if we make not split),
   // and use classProbabilities as auxiliary information.  Later we'll overwrite
   // classProbabilities to the empirical class probabilities if we do not split.
-
   double bestGain = FitnessFunction::Evaluate(
       labels.subvec(begin, begin + count - 1), numClasses);
-  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
-  {
-    double dimGain = -DBL_MAX;
-    if (datasetInfo.Type(i) == data::Datatype::categorical)
-      dimGain = CategoricalSplit::SplitIfBetter(bestGain, 
-          data.cols(begin, begin + count - 1).row(i), 
-          datasetInfo.NumMappings(i), 
-          labels.subvec(begin, begin + count - 1), 
-          numClasses, minimumLeafSize,
-          classProbabilities, *this);
-    else if (datasetInfo.Type(i) == data::Datatype::numeric)
-      dimGain = NumericSplit::SplitIfBetter(bestGain, 
-          data.cols(begin, begin + count - 1).row(i), 
-          labels.subvec(begin, begin + count - 1), 
-          numClasses, minimumLeafSize,
-          classProbabilities, *this);
-
-    // Was there an improvement?  If so mark that it's the new best dimension.
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
-
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain == 0.0)
-      break;
-  }
+  const size_t bestDim = FindBestSplit(data, begin, count, &datasetInfo, labels,
+      numClasses, minimumLeafSize, dimensionSelector, bestGain, bins,
+      histograms);
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != datasetInfo.Dimensionality())
@@ -427,37 +455,10 @@ void DecisionTree<FitnessFunction,
             classProbabilities, *this);
     }
 
-    // Figure out counts of children.
-    arma::Row<size_t> childCounts(numClasses, arma::fill::zeros);
-    for (size_t i = begin; i < begin + count; ++i)
-      childCounts[childAssignments[i - begin]]++;
-
     // Split into children.
-    size_t currentCol = begin;
-    for (size_t i = 0; i < numChildren; ++i)
-    {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
-      {
-        if (childAssignments[j - begin] == i)
-        {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          ++currentCol;
-        }
-      }
-
-      // Now build the child recursively.
-      if (NoRecursion)
-        children.push_back(new DecisionTree(data, currentChildBegin, 
-            currentCol - currentChildBegin, datasetInfo,
-            labels, numClasses, currentCol - currentChildBegin));
-      else
-        children.push_back(new DecisionTree(data, currentChildBegin, 
-            currentCol - currentChildBegin, datasetInfo,
-            labels, numClasses, minimumLeafSize));
-    }
+    BuildChildren(data, begin, count, &datasetInfo, labels, childAssignments,
+        numChildren, numClasses, minimumLeafSize, dimensionSelector, bins,
+        histograms);
   }
   else
   {
@@ -475,18 +476,24 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Train(MatType& data,
-                                      const size_t begin,
-                                      const size_t count,
-                                      arma::Row<size_t>& labels,
-                                      const size_t numClasses,
-                                      const size_t minimumLeafSize)
+                  NoRecursion,
+                  DimensionSelectionType>::Train(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector,
+    Bins* bins,
+    arma::Cube<size_t>* histograms)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -503,24 +510,9 @@ void DecisionTree<FitnessFunction,
   // class probabilities if we do not split.
   double bestGain = FitnessFunction::Evaluate(
       labels.subvec(begin, begin + count - 1), numClasses);
-  size_t bestDim = data.n_rows; // This means "no split".
-  for (size_t i = 0; i < data.n_rows; ++i)
-  {
-    double dimGain = NumericSplitType<FitnessFunction>::SplitIfBetter(bestGain,
-        data.cols(begin, begin + count - 1).row(i), 
-        labels.cols(begin, begin + count - 1), 
-        numClasses, minimumLeafSize, classProbabilities, *this);
-
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
-
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain == 0.0)
-      break;
-  }
+  const size_t bestDim = FindBestSplit(data, begin, count, NULL, labels,
+      numClasses, minimumLeafSize, dimensionSelector, bestGain, bins,
+      histograms);
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != data.n_rows)
@@ -537,47 +529,583 @@ void DecisionTree<FitnessFunction,
       childAssignments[j - begin] = NumericSplit::CalculateDirection(data(bestDim, j),
           classProbabilities, *this);
 
-    // Calculate counts of children in each node.
-    arma::Row<size_t> childCounts(numChildren);
-    childCounts.zeros();
-    for (size_t j = begin; j < begin + count; ++j)
-      childCounts[childAssignments[j - begin]]++;
+    // Split into children.
+    BuildChildren(data, begin, count, NULL, labels, childAssignments,
+        numChildren, numClasses, minimumLeafSize, dimensionSelector, bins,
+        histograms);
+  }
+  else
+  {
+    // We won't be needing these members, so reset them.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
 
-    size_t currentCol = begin;
-    for (size_t i = 0; i < numChildren; ++i)
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities(labels.subvec(begin, begin + count - 1), numClasses);
+  }
+
+}
+
+//! Check a single dimension for a split.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+template<typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    ElemType,
+                    NoRecursion,
+                    DimensionSelectionType>::DimensionSplitIfBetter(
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const size_t dimension,
+    const double bestGain,
+    arma::vec& probabilities,
+    NumericAuxiliarySplitInfo& numericAux,
+    CategoricalAuxiliarySplitInfo& categoricalAux,
+    const Bins* bins,
+    const arma::Cube<size_t>* histograms)
+{
+  if (datasetInfo &&
+      datasetInfo->Type(dimension) == data::Datatype::categorical)
+  {
+    return CategoricalSplit::SplitIfBetter(bestGain,
+        data.cols(begin, begin + count - 1).row(dimension),
+        datasetInfo->NumMappings(dimension), labels, numClasses,
+        minimumLeafSize, probabilities, categoricalAux);
+  }
+  else if (histograms)
+  {
+    return HistogramSplitIfBetter(bestGain, histograms->slice(dimension),
+        bins->splitValues[dimension], minimumLeafSize, probabilities,
+        numericAux, UsesHistograms());
+  }
+  else
+  {
+    return NumericSplit::SplitIfBetter(bestGain,
+        data.cols(begin, begin + count - 1).row(dimension), labels, numClasses,
+        minimumLeafSize, probabilities, numericAux);
+  }
+}
+
+//! Find the best split of a node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+template<typename MatType>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    ElemType,
+                    NoRecursion,
+                    DimensionSelectionType>::FindBestSplit(
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector,
+    double& bestGain,
+    const Bins* bins,
+    const arma::Cube<size_t>* histograms)
+{
+  const size_t dimensionality = (datasetInfo == NULL) ? data.n_rows :
+      datasetInfo->Dimensionality();
+  size_t bestDim = dimensionality; // This means "no split".
+
+  // Select the dimensions to search, in increasing order.
+  std::vector<size_t> dimensions;
+  dimensionSelector.Select(dimensionality, dimensions);
+
+  // The labels of the points in the node, without a copy.
+  const arma::Row<size_t> nodeLabels(labels.memptr() + begin, count, false,
+      true);
+
+  bool inParallel = false;
+  #ifdef HAS_OPENMP
+  inParallel = omp_in_parallel();
+  #endif
+
+  // Small nodes, nodes inside of a parallel region, and nodes that can't be
+  // improved on are searched one dimension at a time.
+  if (inParallel || count < parallelSplitThreshold || dimensions.size() < 2 ||
+      bestGain == 0.0)
+  {
+    for (size_t d = 0; d < dimensions.size(); ++d)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      const size_t i = dimensions[d];
+      const double dimGain = DimensionSplitIfBetter(data, begin, count,
+          datasetInfo, nodeLabels, numClasses, minimumLeafSize, i, bestGain,
+          classProbabilities, *this, *this, bins, histograms);
+
+      // Was there an improvement?  If so mark that it's the new best
+      // dimension.
+      if (dimGain > bestGain)
       {
-        if (childAssignments[j - begin] == i)
-        {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          ++currentCol;
-        }
+        bestDim = i;
+        bestGain = dimGain;
       }
 
-      // Now build the child recursively.
-      if (NoRecursion)
-        children.push_back(new DecisionTree(data, currentChildBegin, 
-            currentCol - currentChildBegin,
-            labels, numClasses, currentCol - currentChildBegin));
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain == 0.0)
+        break;
+    }
+
+    return bestDim;
+  }
+
+  // Check every dimension against the gain of the node in parallel.
+  const double nodeGain = bestGain;
+  const size_t numDimensions = dimensions.size();
+  std::vector<double> dimGains(numDimensions);
+  std::vector<arma::vec> dimProbabilities(numDimensions);
+  std::vector<NumericAuxiliarySplitInfo> numericAux(numDimensions);
+  std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(numDimensions);
+
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t d = 0; d < (intmax_t) numDimensions; ++d)
+  #else
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t d = 0; d < numDimensions; ++d)
+  #endif
+  {
+    dimGains[d] = DimensionSplitIfBetter(data, begin, count, datasetInfo,
+        nodeLabels, numClasses, minimumLeafSize, dimensions[d], nodeGain,
+        dimProbabilities[d], numericAux[d], categoricalAux[d], bins,
+        histograms);
+  }
+
+  // Now combine the results in order, as the serial search would.  A dimension
+  // that doesn't improve on the best gain so far against the gain of the node
+  // won't improve on it in the serial search either; otherwise, it is checked
+  // again against the best gain so far (if that is not the gain of the node),
+  // so that exactly the same split is found.
+  for (size_t d = 0; d < numDimensions; ++d)
+  {
+    if (dimGains[d] <= bestGain)
+      continue;
+
+    const size_t i = dimensions[d];
+    if (bestGain != nodeGain)
+    {
+      dimGains[d] = DimensionSplitIfBetter(data, begin, count, datasetInfo,
+          nodeLabels, numClasses, minimumLeafSize, i, bestGain,
+          dimProbabilities[d], numericAux[d], categoricalAux[d], bins,
+          histograms);
+    }
+
+    if (dimGains[d] > bestGain)
+    {
+      bestDim = i;
+      bestGain = dimGains[d];
+      classProbabilities = dimProbabilities[d];
+      if (datasetInfo &&
+          datasetInfo->Type(i) == data::Datatype::categorical)
+        CategoricalAuxiliarySplitInfo::operator=(categoricalAux[d]);
       else
-        children.push_back(new DecisionTree(data, currentChildBegin, 
-            currentCol - currentChildBegin,
-            labels, numClasses, minimumLeafSize));
+        NumericAuxiliarySplitInfo::operator=(numericAux[d]);
+    }
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain == 0.0)
+      break;
+  }
+
+  return bestDim;
+}
+
+//! Reorder the points of a node and build its children.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType,
+                  NoRecursion,
+                  DimensionSelectionType>::BuildChildren(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    arma::Row<size_t>& childAssignments,
+    const size_t numChildren,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector,
+    Bins* bins,
+    arma::Cube<size_t>* histograms)
+{
+  // Move the points of each child together.  The points of child i will be in
+  // the columns [childBegins[i], childBegins[i + 1]).
+  std::vector<size_t> childBegins(numChildren + 1);
+  size_t currentCol = begin;
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    size_t currentChildBegin = currentCol;
+    childBegins[i] = currentChildBegin;
+    for (size_t j = currentChildBegin; j < begin + count; ++j)
+    {
+      if (childAssignments[j - begin] == i)
+      {
+        childAssignments.swap_cols(currentCol - begin, j - begin);
+        data.swap_cols(currentCol, j);
+        labels.swap_cols(currentCol, j);
+        if (bins)
+          bins->bins.swap_cols(currentCol, j);
+        ++currentCol;
+      }
+    }
+  }
+  childBegins[numChildren] = currentCol;
+
+  // If histograms are used, only the histograms of the smaller children are
+  // counted from their points; the histograms of this node, minus those of the
+  // smaller children, are the histograms of the largest child.  Children that
+  // won't be split don't need histograms.
+  std::vector<arma::Cube<size_t>> childHistograms;
+  if (histograms && !NoRecursion)
+  {
+    size_t largest = 0;
+    for (size_t i = 1; i < numChildren; ++i)
+    {
+      if (childBegins[i + 1] - childBegins[i] >
+          childBegins[largest + 1] - childBegins[largest])
+        largest = i;
+    }
+
+    childHistograms.resize(numChildren);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      if (i == largest)
+        continue;
+
+      BuildHistograms(*bins, labels, childBegins[i],
+          childBegins[i + 1] - childBegins[i], numClasses,
+          childHistograms[i]);
+      *histograms -= childHistograms[i];
+    }
+    childHistograms[largest] = std::move(*histograms);
+  }
+
+  // The dimension selectors of the children are created here, and not in the
+  // tasks, so that they don't depend on the order the children are built in.
+  std::vector<DimensionSelectionType> childSelectors;
+  childSelectors.reserve(numChildren);
+  for (size_t i = 0; i < numChildren; ++i)
+    childSelectors.push_back(dimensionSelector.Child());
+
+  // Now build the children.  Large nodes build their children one at a time,
+  // since each of those searches for its split in parallel; a smaller node that
+  // isn't in a parallel region yet opens one for the tasks of its subtree.
+  bool inParallel = false;
+  #ifdef HAS_OPENMP
+  inParallel = omp_in_parallel();
+  #endif
+
+  children.resize(numChildren, NULL);
+  if (!inParallel && count >= parallelBuildThreshold &&
+      count < parallelSplitThreshold)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      BuildChildTasks(data, childBegins, datasetInfo, labels, numClasses,
+          minimumLeafSize, childSelectors, bins, childHistograms);
     }
   }
   else
   {
-    // We won't be needing these members, so reset them.
-    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    BuildChildTasks(data, childBegins, datasetInfo, labels, numClasses,
+        minimumLeafSize, childSelectors, bins, childHistograms);
+  }
+}
 
-    // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities(labels.subvec(begin, begin + count - 1), numClasses);
+//! Build the children of a node in tasks.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType,
+                  NoRecursion,
+                  DimensionSelectionType>::BuildChildTasks(
+    MatType& data,
+    const std::vector<size_t>& childBegins,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    std::vector<DimensionSelectionType>& childSelectors,
+    Bins* bins,
+    std::vector<arma::Cube<size_t>>& childHistograms)
+{
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    const size_t childBegin = childBegins[i];
+    const size_t childCount = childBegins[i + 1] - childBegins[i];
+
+    // Outside of a parallel region, or if the child is too small, the task is
+    // executed immediately.
+    #pragma omp task if(childCount >= parallelBuildThreshold) \
+        shared(data, labels, childSelectors, childHistograms)
+    {
+      // Build the child recursively.
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+      Bins* childBins = childHistograms.empty() ? NULL : bins;
+      arma::Cube<size_t>* childHistogram = childHistograms.empty() ? NULL :
+          &childHistograms[i];
+      if (datasetInfo)
+        children[i] = new DecisionTree(data, childBegin, childCount,
+            *datasetInfo, labels, numClasses, childLeafSize,
+            childSelectors[i], childBins, childHistogram);
+      else
+        children[i] = new DecisionTree(data, childBegin, childCount, labels,
+            numClasses, childLeafSize, childSelectors[i], childBins,
+            childHistogram);
+    }
+  }
+
+  #pragma omp taskwait
+}
+
+//! Bin the dataset if needed, and train the tree.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType,
+                  NoRecursion,
+                  DimensionSelectionType>::TrainRoot(
+    MatType& data,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector)
+{
+  // If the numeric split type can search histograms, the dataset is binned
+  // once here, and only the histograms of the root are counted from all the
+  // points.
+  Bins bins;
+  arma::Cube<size_t> histograms;
+  Bins* binsPtr = NULL;
+  arma::Cube<size_t>* histogramsPtr = NULL;
+  if (UsesHistograms::value)
+  {
+    BinData(data, datasetInfo, bins, UsesHistograms());
+    BuildHistograms(bins, labels, 0, data.n_cols, numClasses, histograms);
+    binsPtr = &bins;
+    histogramsPtr = &histograms;
+  }
+
+  if (datasetInfo)
+    Train(data, 0, data.n_cols, *datasetInfo, labels, numClasses,
+        minimumLeafSize, dimensionSelector, binsPtr, histogramsPtr);
+  else
+    Train(data, 0, data.n_cols, labels, numClasses, minimumLeafSize,
+        dimensionSelector, binsPtr, histogramsPtr);
+}
+
+//! Bin each numeric dimension of the dataset.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType,
+                  NoRecursion,
+                  DimensionSelectionType>::BinData(
+    const MatType& data,
+    const data::DatasetInfo* datasetInfo,
+    Bins& bins,
+    std::true_type /* usesHistograms */)
+{
+  bins.bins.zeros(data.n_rows, data.n_cols);
+  bins.splitValues.clear();
+  bins.splitValues.resize(data.n_rows);
+  bins.dimensions.clear();
+  bins.maxBins = 1;
+
+  // The dimensions are binned independently.
+  arma::Col<size_t> numBins(data.n_rows, arma::fill::zeros);
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t d = 0; d < (intmax_t) data.n_rows; ++d)
+  #else
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t d = 0; d < data.n_rows; ++d)
+  #endif
+  {
+    if (datasetInfo && datasetInfo->Type(d) == data::Datatype::categorical)
+      continue;
+
+    arma::Row<unsigned char> dimensionBins;
+    numBins[d] = NumericSplit::Bin(data.row(d), dimensionBins,
+        bins.splitValues[d]);
+    bins.bins.row(d) = dimensionBins;
+  }
+
+  // Dimensions with only one bin can't be split.
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    if (numBins[d] > 1)
+    {
+      bins.dimensions.push_back(d);
+      bins.maxBins = std::max(bins.maxBins, (size_t) numBins[d]);
+    }
+  }
+}
+
+//! This is never called.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType,
+                  NoRecursion,
+                  DimensionSelectionType>::BinData(
+    const MatType& /* data */,
+    const data::DatasetInfo* /* datasetInfo */,
+    Bins& /* bins */,
+    std::false_type /* usesHistograms */)
+{
+  // Nothing to do.
+}
+
+//! Count the histograms of the points of a node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType,
+                  NoRecursion,
+                  DimensionSelectionType>::BuildHistograms(
+    const Bins& bins,
+    const arma::Row<size_t>& labels,
+    const size_t begin,
+    const size_t count,
+    const size_t numClasses,
+    arma::Cube<size_t>& histograms)
+{
+  histograms.zeros(numClasses, bins.maxBins, bins.bins.n_rows);
+
+  // Each dimension has its own slice, so the dimensions of large nodes are
+  // counted in parallel (unless we are already in a parallel region).
+  #ifdef HAS_OPENMP
+  const bool parallel = !omp_in_parallel() &&
+      (count >= parallelSplitThreshold);
+  #endif
+
+  const size_t numDimensions = bins.dimensions.size();
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (intmax_t i = 0; i < (intmax_t) numDimensions; ++i)
+  #else
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (size_t i = 0; i < numDimensions; ++i)
+  #endif
+  {
+    const size_t d = bins.dimensions[i];
+    arma::Mat<size_t>& histogram = histograms.slice(d);
+    for (size_t j = begin; j < begin + count; ++j)
+      ++histogram(labels[j], bins.bins(d, j));
   }
+}
 
+//! Search the histogram of a dimension with the numeric split type.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    ElemType,
+                    NoRecursion,
+                    DimensionSelectionType>::HistogramSplitIfBetter(
+    const double bestGain,
+    const arma::Mat<size_t>& histogram,
+    const arma::vec& splitValues,
+    const size_t minimumLeafSize,
+    arma::vec& probabilities,
+    NumericAuxiliarySplitInfo& numericAux,
+    std::true_type /* usesHistograms */)
+{
+  return NumericSplit::SplitHistogramIfBetter(bestGain, histogram, splitValues,
+      minimumLeafSize, probabilities, numericAux);
+}
+
+//! This is never called.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType,
+         bool NoRecursion,
+         typename DimensionSelectionType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    ElemType,
+                    NoRecursion,
+                    DimensionSelectionType>::HistogramSplitIfBetter(
+    const double bestGain,
+    const arma::Mat<size_t>& /* histogram */,
+    const arma::vec& /* splitValues */,
+    const size_t /* minimumLeafSize */,
+    arma::vec& /* probabilities */,
+    NumericAuxiliarySplitInfo& /* numericAux */,
+    std::false_type /* usesHistograms */)
+{
+  return bestGain;
 }
 
 //! Return the class.
@@ -585,13 +1113,16 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename VecType>
 size_t DecisionTree<FitnessFunction,
                     NumericSplitType,
                     CategoricalSplitType,
                     ElemType,
-                    NoRecursion>::Classify(const VecType& point) const
+                    NoRecursion,
+                    DimensionSelectionType>::Classify(
+    const VecType& point) const
 {
   if (children.size() == 0)
   {
@@ -607,15 +1138,18 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename VecType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Classify(const VecType& point,
-                                         size_t& prediction,
-                                         arma::vec& probabilities) const
+                  NoRecursion,
+                  DimensionSelectionType>::Classify(
+    const VecType& point,
+    size_t& prediction,
+    arma::vec& probabilities) const
 {
   if (children.size() == 0)
   {
@@ -632,14 +1166,17 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Classify(const MatType& data,
-                                         arma::Row<size_t>& predictions) const
+                  NoRecursion,
+                  DimensionSelectionType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
 {
   predictions.set_size(data.n_cols);
   if (children.size() == 0)
@@ -658,15 +1195,18 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename MatType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Classify(const MatType& data,
-                                         arma::Row<size_t>& predictions,
-                                         arma::mat& probabilities) const
+                  NoRecursion,
+                  DimensionSelectionType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& probabilities) const
 {
   predictions.set_size(data.n_cols);
   if (children.size() == 0)
@@ -695,14 +1235,17 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename Archive>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::Serialize(Archive& ar,
-                                          const unsigned int /* version */)
+                  NoRecursion,
+                  DimensionSelectionType>::Serialize(
+    Archive& ar,
+    const unsigned int /* version */)
 {
   using data::CreateNVP;
 
@@ -741,13 +1284,16 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename VecType>
 size_t DecisionTree<FitnessFunction,
                     NumericSplitType,
                     CategoricalSplitType,
                     ElemType,
-                    NoRecursion>::CalculateDirection(const VecType& point) const
+                    NoRecursion,
+                    DimensionSelectionType>::CalculateDirection(
+    const VecType& point) const
 {
   if ((data::Datatype) dimensionTypeOrMajorityClass ==
       data::Datatype::categorical)
@@ -762,13 +1308,15 @@ template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename ElemType,
-         bool NoRecursion>
+         bool NoRecursion,
+         typename DimensionSelectionType>
 template<typename RowType>
 void DecisionTree<FitnessFunction,
                   NumericSplitType,
                   CategoricalSplitType,
                   ElemType,
-                  NoRecursion>::CalculateClassProbabilities(
+                  NoRecursion,
+                  DimensionSelectionType>::CalculateClassProbabilities(
     const RowType& labels,
     const size_t numClasses)
 {
@@ -47,11 +47,28 @@ class GiniGain
     for (size_t i = 0; i < labels.n_elem; ++i)
       counts[labels[i]]++;
 
+    return EvaluateCounts(counts, labels.n_elem);
+  }
+
+  /**
+   * Evaluate the Gini impurity of a set of labels, given only the number of
+   * labels of each class.  CountsType should be an Armadillo vector.
+   *
+   * @param counts Number of labels of each class.
+   * @param total Total number of labels (the sum of counts).
+   */
+  template<typename CountsType>
+  static double EvaluateCounts(const CountsType& counts, const size_t total)
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (total == 0)
+      return 0.0;
+
     // Calculate the Gini impurity of the un-split node.
     double impurity = 0.0;
-    for (size_t i = 0; i < numClasses; ++i)
+    for (size_t i = 0; i < counts.n_elem; ++i)
     {
-      const double f = ((double) counts[i] / (double) labels.n_elem);
+      const double f = ((double) counts[i] / (double) total);
       impurity += f * (1.0 - f);
     }
 
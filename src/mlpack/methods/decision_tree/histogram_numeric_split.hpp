@@ -0,0 +1,197 @@
+/**
+ * @file histogram_numeric_split.hpp
+ * @author Ryan Curtin
+ *
+ * A tree splitter that finds the best binary numeric split among the
+ * boundaries of a histogram of the points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "numeric_split_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * searches a numeric dimension for a good binary split without sorting the
+ * points.  The values of the dimension are divided into at most MaxBins bins,
+ * and only the boundaries between bins are considered as split points.  Given
+ * the number of points of each class in each bin, the class counts of the left
+ * child are accumulated bin by bin, so all boundaries are checked in
+ * O(MaxBins * numClasses) time.
+ *
+ * When used in a DecisionTree, the split supports histograms (see
+ * NumericSplitTraits): each dimension of the dataset is binned once before
+ * training with Bin(), which gives each distinct value its own bin if there
+ * are no more than MaxBins of them, and otherwise chooses bins that hold about
+ * the same number of points.  The tree then keeps the histogram of each
+ * dimension for each node, and only the histogram of the smaller child of a
+ * node is counted from its points; the histogram of the larger child is the
+ * histogram of the node minus that of the smaller child.
+ *
+ * SplitIfBetter() can also be called on the points of a single node, like the
+ * other numeric split types; then the range of the values in the node is
+ * divided into at most MaxBins equal-width bins, which are counted in one pass
+ * over the points.
+ *
+ * The FitnessFunction must provide the static function
+ * EvaluateCounts(counts, total), which calculates the gain of a set of labels
+ * from the number of labels of each class; GiniGain and InformationGain do.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  //! The maximum number of bins that a dimension is divided into.
+  static const size_t MaxBins = 256;
+
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<typename VecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const size_t minimumLeafSize,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Divide the values of one dimension of the dataset into at most MaxBins
+   * bins.  If there are no more than MaxBins distinct values, each of them gets
+   * its own bin; otherwise, the bins hold about the same number of values.  The
+   * bins are numbered in increasing order of their values.
+   *
+   * @param values Values of the dimension.
+   * @param bins This will be filled with the bin of each value.
+   * @param splitValues This will be filled with the split value between each
+   *      bin and the next.
+   * @return The number of bins.
+   */
+  template<typename VecType>
+  static size_t Bin(const VecType& values,
+                    arma::Row<unsigned char>& bins,
+                    arma::vec& splitValues);
+
+  /**
+   * Check if we can split a node, given the number of points of each class in
+   * each bin of a dimension (as computed with Bin()).  If we can split the node
+   * in a way that improves on 'bestGain', then we return the improved gain.
+   * Otherwise we return the value 'bestGain'.  If a split is made, then
+   * classProbabilities and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param histogram Number of points of each class (rows) in each bin
+   *      (columns) of the dimension; there may be more columns than bins.
+   * @param splitValues The split value between each bin and the next, as
+   *      returned by Bin().
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<typename ElemType>
+  static double SplitHistogramIfBetter(
+      const double bestGain,
+      const arma::Mat<size_t>& histogram,
+      const arma::vec& splitValues,
+      const size_t minimumLeafSize,
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+
+ private:
+  /**
+   * Find the bin boundary that gives the best split, given the number of points
+   * of each class in each bin.  The gain of the best split is returned if it
+   * improves on 'bestGain' (or if it is the best possible gain); otherwise,
+   * 'bestGain' is returned.
+   *
+   * @param bestGain Best gain seen so far.
+   * @param binClassCounts Number of points of each class (rows) in each bin
+   *      (columns).
+   * @param numBins Number of bins (the first columns of binClassCounts).
+   * @param minimumLeafSize Minimum number of points in a leaf node.
+   * @param bestBin This will be set to the last bin of the left child of the
+   *      best split, or numBins if no split was found.
+   */
+  static double BestBoundary(const double bestGain,
+                             const arma::Mat<size_t>& binClassCounts,
+                             const size_t numBins,
+                             const size_t minimumLeafSize,
+                             size_t& bestBin);
+};
+
+/**
+ * The HistogramNumericSplit can search histograms of the class counts.
+ */
+template<typename FitnessFunction>
+class NumericSplitTraits<HistogramNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool UsesHistograms = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
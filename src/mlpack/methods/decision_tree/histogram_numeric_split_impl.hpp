@@ -0,0 +1,282 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of strategy that finds the best binary numeric split among
+ * the boundaries of a histogram of the points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<typename VecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t n = data.n_elem;
+  if (n < (minimumLeafSize * 2) || n < 2)
+    return bestGain;
+
+  // Find the range of the data; if all values are the same, we can't split.
+  ElemType minValue = data[0];
+  ElemType maxValue = data[0];
+  for (size_t i = 1; i < n; ++i)
+  {
+    if (data[i] < minValue)
+      minValue = data[i];
+    else if (data[i] > maxValue)
+      maxValue = data[i];
+  }
+  if (minValue == maxValue)
+    return bestGain;
+
+  // Build the histogram in one pass: the number of points of each class in
+  // each bin, and the smallest and largest value in each bin (the split value
+  // is placed between the values of neighboring bins).
+  const size_t bins = std::min(n, (size_t) MaxBins);
+  const double scale = double(bins) / (double(maxValue) - double(minValue));
+  arma::Mat<size_t> binClassCounts(numClasses, bins, arma::fill::zeros);
+  arma::Col<size_t> binCounts(bins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(bins);
+  arma::Col<ElemType> binMax(bins);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const ElemType value = data[i];
+    const size_t bin = std::min((size_t) ((double(value) - double(minValue)) *
+        scale), bins - 1);
+
+    if (binCounts[bin] == 0)
+    {
+      binMin[bin] = value;
+      binMax[bin] = value;
+    }
+    else if (value < binMin[bin])
+    {
+      binMin[bin] = value;
+    }
+    else if (value > binMax[bin])
+    {
+      binMax[bin] = value;
+    }
+
+    ++binClassCounts(labels[i], bin);
+    ++binCounts[bin];
+  }
+
+  size_t bestBin;
+  const double gain = BestBoundary(bestGain, binClassCounts, bins,
+      minimumLeafSize, bestBin);
+  if (bestBin == bins)
+    return bestGain;
+
+  // The split value is halfway between the largest value of the last bin of
+  // the left child and the smallest value of the next non-empty bin.  There is
+  // one, since the right child isn't empty.
+  size_t nextBin = bestBin + 1;
+  while (binCounts[nextBin] == 0)
+    ++nextBin;
+
+  classProbabilities.set_size(1);
+  classProbabilities[0] = (binMax[bestBin] + binMin[nextBin]) / 2.0;
+  return gain;
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+size_t HistogramNumericSplit<FitnessFunction>::Bin(
+    const VecType& values,
+    arma::Row<unsigned char>& bins,
+    arma::vec& splitValues)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  const size_t n = values.n_elem;
+  bins.zeros(n);
+  splitValues.reset();
+  if (n == 0)
+    return 1;
+
+  std::vector<ElemType> sorted(n);
+  for (size_t i = 0; i < n; ++i)
+    sorted[i] = values[i];
+  std::sort(sorted.begin(), sorted.end());
+
+  std::vector<ElemType> distinct(sorted);
+  distinct.erase(std::unique(distinct.begin(), distinct.end()),
+      distinct.end());
+
+  // Find the largest value of each bin.  If there are few enough distinct
+  // values, each of them is a bin; otherwise, the bins end at evenly spaced
+  // positions of the sorted values, and bins that would end at the same value
+  // are merged.  Either way, the last bin ends at the largest value.
+  std::vector<ElemType> binMax;
+  if (distinct.size() <= MaxBins)
+  {
+    binMax.swap(distinct);
+  }
+  else
+  {
+    for (size_t b = 1; b <= MaxBins; ++b)
+    {
+      const ElemType value = sorted[(b * n - 1) / MaxBins];
+      if (binMax.empty() || value > binMax.back())
+        binMax.push_back(value);
+    }
+  }
+
+  // Each value goes into the first bin whose largest value isn't smaller.
+  for (size_t i = 0; i < n; ++i)
+  {
+    bins[i] = (unsigned char) (std::lower_bound(binMax.begin(), binMax.end(),
+        values[i]) - binMax.begin());
+  }
+
+  // The split value between two bins is halfway between the largest value of
+  // the first and the smallest value of the second.
+  splitValues.set_size(binMax.size() - 1);
+  for (size_t b = 0; b < splitValues.n_elem; ++b)
+  {
+    const ElemType nextValue = *std::upper_bound(sorted.begin(), sorted.end(),
+        binMax[b]);
+    splitValues[b] = (double(binMax[b]) + double(nextValue)) / 2.0;
+  }
+
+  return binMax.size();
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+double HistogramNumericSplit<FitnessFunction>::SplitHistogramIfBetter(
+    const double bestGain,
+    const arma::Mat<size_t>& histogram,
+    const arma::vec& splitValues,
+    const size_t minimumLeafSize,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  // A dimension with a single bin can't be split.
+  const size_t bins = splitValues.n_elem + 1;
+  if (bins < 2)
+    return bestGain;
+
+  size_t bestBin;
+  const double gain = BestBoundary(bestGain, histogram, bins, minimumLeafSize,
+      bestBin);
+  if (bestBin == bins)
+    return bestGain;
+
+  // The bins between the last bin of the left child and the next non-empty bin
+  // are empty in this node, so the split value right after the last bin of the
+  // left child gives the same split.
+  classProbabilities.set_size(1);
+  classProbabilities[0] = splitValues[bestBin];
+  return gain;
+}
+
+template<typename FitnessFunction>
+double HistogramNumericSplit<FitnessFunction>::BestBoundary(
+    const double bestGain,
+    const arma::Mat<size_t>& binClassCounts,
+    const size_t numBins,
+    const size_t minimumLeafSize,
+    size_t& bestBin)
+{
+  bestBin = numBins;
+
+  // The class counts of the whole node; the counts of the right child are
+  // these minus the counts of the left child.
+  const arma::Col<size_t> totalCounts =
+      arma::sum(binClassCounts.cols(0, numBins - 1), 1);
+  const size_t n = arma::accu(totalCounts);
+  if (n < (minimumLeafSize * 2) || n < 2)
+    return bestGain;
+
+  arma::Col<size_t> leftCounts(binClassCounts.n_rows, arma::fill::zeros);
+  arma::Col<size_t> rightCounts(binClassCounts.n_rows);
+
+  // Loop through all bin boundaries, choosing the best one.  Also, force a
+  // minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  size_t leftSize = 0;
+  for (size_t bin = 0; bin < numBins - 1; ++bin)
+  {
+    // Empty bins don't change the split.
+    const size_t binCount = arma::accu(binClassCounts.col(bin));
+    if (binCount == 0)
+      continue;
+
+    leftCounts += binClassCounts.col(bin);
+    leftSize += binCount;
+    if (leftSize < minimum)
+      continue;
+    if (n - leftSize < minimum)
+      break;
+
+    // Calculate the gain for the left and right child.
+    rightCounts = totalCounts - leftCounts;
+    const double leftGain = FitnessFunction::EvaluateCounts(leftCounts,
+        leftSize);
+    const double rightGain = FitnessFunction::EvaluateCounts(rightCounts,
+        n - leftSize);
+
+    // Calculate the fraction of points in the left and right children.
+    const double leftRatio = double(leftSize) / double(n);
+    const double rightRatio = 1.0 - leftRatio;
+
+    // Calculate the gain at this split point.
+    const double gain = leftRatio * leftGain + rightRatio * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain == 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      bestBin = bin;
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      bestBin = bin;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
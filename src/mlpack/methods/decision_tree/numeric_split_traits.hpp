@@ -0,0 +1,55 @@
+/**
+ * @file numeric_split_traits.hpp
+ * @author Ryan Curtin
+ *
+ * This provides the NumericSplitTraits class, a template class to get
+ * information about the numeric split types of decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This is a template class that can provide information about the numeric
+ * split types of decision trees.  By default, a split type only has to provide
+ * the functions that DecisionTree always uses; a split type that supports more
+ * should specialize this class.
+ */
+template<typename NumericSplitType>
+class NumericSplitTraits
+{
+ public:
+  /**
+   * If true, then the split type can search the histogram of the class counts
+   * of a dimension for a split, instead of the points of the node.  The split
+   * type must then provide these static functions:
+   *
+   *  - size_t Bin(const VecType& values, arma::Row<unsigned char>& bins,
+   *    arma::vec& splitValues): divide the values of one dimension of the whole
+   *    dataset into at most 256 bins, fill bins with the bin of each value and
+   *    splitValues with the split value between each bin and the next, and
+   *    return the number of bins.
+   *  - double SplitHistogramIfBetter(bestGain, histogram, splitValues,
+   *    minimumLeafSize, classProbabilities, aux): like SplitIfBetter(), but
+   *    given the number of points of each class in each bin (one column per
+   *    bin) and the split values returned by Bin().
+   *
+   * DecisionTree then bins the dataset once before training, and builds the
+   * histograms of all but the largest child of a node from their points; the
+   * histogram of the largest child is the histogram of the node minus the
+   * histograms of its siblings.
+   */
+  static const bool UsesHistograms = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
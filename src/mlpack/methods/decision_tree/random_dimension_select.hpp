@@ -0,0 +1,104 @@
+/**
+ * @file random_dimension_select.hpp
+ * @author Ryan Curtin
+ *
+ * Selects a random subset of the dimensions for a split.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_RANDOM_DIMENSION_SELECT_HPP
+#define MLPACK_METHODS_DECISION_TREE_RANDOM_DIMENSION_SELECT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This dimension selection policy selects a different random subset of the
+ * dimensions for the split of each node, as is done by random forests.  Each
+ * selector has its own random number generator, and the generators of the
+ * children are seeded from the generator of their parent, so a tree built with
+ * a selector depends only on the seed of that selector (and not, for instance,
+ * on the order in which the nodes are built).
+ */
+class RandomDimensionSelect
+{
+ public:
+  /**
+   * Create the selector, seeding its generator from mlpack's random number
+   * generator.
+   *
+   * @param numDimensions Number of dimensions to select for each split; if 0,
+   *     the square root of the dimensionality (rounded) is used.
+   */
+  RandomDimensionSelect(const size_t numDimensions = 0) :
+      numDimensions(numDimensions),
+      generator((uint32_t) math::RandInt(std::numeric_limits<int>::max()))
+  { }
+
+  /**
+   * Create the selector with the given seed.
+   *
+   * @param numDimensions Number of dimensions to select for each split; if 0,
+   *     the square root of the dimensionality (rounded) is used.
+   * @param seed Seed of the random number generator.
+   */
+  RandomDimensionSelect(const size_t numDimensions, const uint32_t seed) :
+      numDimensions(numDimensions),
+      generator(seed)
+  { }
+
+  /**
+   * Select a random subset of the dimensions, without replacement.
+   *
+   * @param dimensionality Number of dimensions of the data.
+   * @param dimensions Vector to store the selected dimensions in.
+   */
+  void Select(const size_t dimensionality, std::vector<size_t>& dimensions)
+  {
+    size_t k = numDimensions;
+    if (k == 0)
+      k = (size_t) std::floor(std::sqrt((double) dimensionality) + 0.5);
+    k = std::max(std::min(k, dimensionality), (size_t) 1);
+
+    // Shuffle the first k elements of the list of dimensions (a partial
+    // Fisher-Yates shuffle), and keep those in increasing order.
+    dimensions.resize(dimensionality);
+    for (size_t i = 0; i < dimensionality; ++i)
+      dimensions[i] = i;
+    for (size_t i = 0; i < k && i + 1 < dimensionality; ++i)
+    {
+      std::uniform_int_distribution<size_t> dist(i, dimensionality - 1);
+      std::swap(dimensions[i], dimensions[dist(generator)]);
+    }
+    dimensions.resize(std::min(k, dimensionality));
+    std::sort(dimensions.begin(), dimensions.end());
+  }
+
+  //! Create the selector of a child, seeded from this selector's generator.
+  RandomDimensionSelect Child()
+  {
+    return RandomDimensionSelect(numDimensions, (uint32_t) generator());
+  }
+
+  //! Get the number of dimensions to select for each split.
+  size_t NumDimensions() const { return numDimensions; }
+  //! Modify the number of dimensions to select for each split.
+  size_t& NumDimensions() { return numDimensions; }
+
+ private:
+  //! The number of dimensions to select for each split.
+  size_t numDimensions;
+  //! The random number generator.
+  std::mt19937 generator;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file concurrent_union_find.hpp
+ * @author Bill March (march@gatech.edu)
+ *
+ * A union-find data structure that may be used by many threads at once.  Like
+ * UnionFind, it tracks the components of a graph; Find() and Union() may be
+ * called concurrently without any locks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free union-find data structure.  Each point in the graph is initially
+ * in its own component.  Calling Union(x, y) unites the components containing
+ * x and y, and Find(x) returns the index of the component containing point x.
+ * Both may be called from several threads at once.
+ *
+ * The parent of every point is stored atomically.  A root is always linked
+ * below the root with the smaller index, so the parent of a point always has a
+ * smaller index than the point itself, and no cycle can be created by two
+ * threads that link at the same time.  The component index returned by Find()
+ * is therefore the smallest index of any point in the component, once all
+ * unions have finished.  Find() shortens the paths it walks by path halving.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  //! The parent of each point.
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i);
+  }
+
+  //! Return the number of points in the structure.
+  size_t Size() const { return parent.size(); }
+
+  /**
+   * Returns the component containing an element.  This may be called while
+   * other threads are calling Union(); the result is then the component of x
+   * at some point during the call.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(const size_t x)
+  {
+    size_t node = x;
+    while (true)
+    {
+      size_t nodeParent = parent[node].load();
+      if (nodeParent == node)
+        return node;
+
+      // Point the node at its grandparent.  If another thread changed the
+      // parent in the meantime, that is fine: the grandparent is still an
+      // ancestor of the node.
+      const size_t grandparent = parent[nodeParent].load();
+      if (grandparent != nodeParent)
+        parent[node].compare_exchange_weak(nodeParent, grandparent);
+
+      node = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.  If several threads try to join
+   * the same two components at once, exactly one of them succeeds.
+   *
+   * @param x one component
+   * @param y the other component
+   * @return true if this call joined two different components, and false if x
+   *     and y were already in the same component.
+   */
+  bool Union(const size_t x, const size_t y)
+  {
+    while (true)
+    {
+      const size_t xRoot = Find(x);
+      const size_t yRoot = Find(y);
+
+      if (xRoot == yRoot)
+        return false;
+
+      // Link the root with the larger index below the other one.  This only
+      // succeeds if the root has not been linked by another thread since it
+      // was found; otherwise, we try again.
+      const size_t lower = std::min(xRoot, yRoot);
+      const size_t upper = std::max(xRoot, yRoot);
+      size_t expected = upper;
+      if (parent[upper].compare_exchange_strong(expected, lower))
+        return true;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
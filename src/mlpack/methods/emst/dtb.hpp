@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -103,14 +104,19 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
+  ConcurrentUnionFind connections;
 
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsInComponent;
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsOutComponent;
-  //! List of edge distances.
-  arma::vec neighborsDistances;
+  //! The component of each point at this iteration, numbered from 0.
+  arma::Col<size_t> pointComponents;
+  //! The number of components at this iteration.
+  size_t numComponents;
+
+  //! List of edge nodes, for each thread.
+  std::vector<arma::Col<size_t>> neighborsInComponent;
+  //! List of edge nodes, for each thread.
+  std::vector<arma::Col<size_t>> neighborsOutComponent;
+  //! List of edge distances, for each thread.
+  std::vector<arma::vec> neighborsDistances;
 
   //! Total distance of the tree.
   double totalDist;
@@ -172,21 +178,42 @@ class DualTreeBoruvka
    * index of the edge; the second row will contain the greater index of the
    * edge; and the third row will contain the distance between the two edges.
    *
+   * If OpenMP is available, the search for the nearest neighbor of each
+   * component is split across threads, and the components are merged in
+   * parallel.  If several edges have exactly the same length, which of them
+   * are part of the tree may depend on the number of threads.
+   *
    * @param results Matrix which results will be stored in.
    */
   void ComputeMST(arma::mat& results);
 
  private:
   /**
-   * Adds a single edge to the edge list
+   * Adds a single edge to the given edge list.
    */
-  void AddEdge(const size_t e1, const size_t e2, const double distance);
+  void AddEdge(const size_t e1,
+               const size_t e2,
+               const double distance,
+               std::vector<EdgePair>& edgeList);
 
   /**
-   * Adds all the edges found in one iteration to the list of neighbors.
+   * Adds all the edges found in one iteration to the list of neighbors.  The
+   * best candidate of each component is taken from the candidates of all
+   * threads, and the components are merged in parallel.
    */
   void AddAllEdges();
 
+  /**
+   * Find the component of each point, and number the components from 0.
+   */
+  void UpdateComponents();
+
+  /**
+   * Collect query subtrees that partition the points of the tree, so that
+   * each thread can search for the neighbors of one subtree at a time.
+   */
+  void QuerySubtrees(const size_t threads, std::vector<Tree*>& subtrees);
+
   /**
    * Unpermute the edge list and output it to results.
    */
@@ -14,6 +14,10 @@
 
 #include "dtb_rules.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace emst {
 
@@ -58,15 +62,11 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(!naive),
     naive(naive),
     connections(dataset.n_cols),
+    numComponents(0),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Set size.
-
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
 }
 
 template<
@@ -83,15 +83,11 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(false),
     naive(false),
     connections(data.n_cols),
+    numComponents(0),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Fill with EdgePairs.
-
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
 }
 
 template<
@@ -123,22 +119,79 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 
   totalDist = 0; // Reset distance.
 
+  // Each thread keeps its own candidate edge for each component, so that the
+  // search for the nearest neighbors of the components can be split across
+  // threads without any locking.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  threads = omp_get_max_threads();
+  #endif
+
+  neighborsInComponent.resize(threads);
+  neighborsOutComponent.resize(threads);
+  neighborsDistances.resize(threads);
+
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  std::vector<RuleType> rules;
+  rules.reserve(threads);
+  for (size_t i = 0; i < threads; ++i)
+  {
+    rules.emplace_back(data, pointComponents, neighborsDistances[i],
+        neighborsInComponent[i], neighborsOutComponent[i], metric);
+  }
+
+  // Each thread searches for the neighbors of one query subtree at a time.
+  std::vector<Tree*> subtrees;
+  if (!naive)
+    QuerySubtrees(threads, subtrees);
+
+  // Find the initial components and reset the tree statistics.
+  Cleanup();
+
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
+    #pragma omp parallel num_threads(threads)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
-    }
-    else
-    {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      size_t thread = 0;
+      #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+      #endif
+
+      if (naive)
+      {
+        // Full O(N^2) traversal.  On the Visual Studio compiler, we have to
+        // use intmax_t because size_t is not yet supported by their OpenMP
+        // implementation.
+        #ifdef _WIN32
+        #pragma omp for schedule(static)
+        for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+        #else
+        #pragma omp for schedule(static)
+        for (size_t i = 0; i < data.n_cols; ++i)
+        #endif
+        {
+          for (size_t j = 0; j < data.n_cols; ++j)
+            rules[thread].BaseCase(i, j);
+        }
+      }
+      else
+      {
+        typename Tree::template DualTreeTraverser<RuleType>
+            traverser(rules[thread]);
+
+        // Subtrees may take very different amounts of time, so they are
+        // handed out dynamically.
+        #ifdef _WIN32
+        #pragma omp for schedule(dynamic)
+        for (intmax_t i = 0; i < (intmax_t) subtrees.size(); ++i)
+        #else
+        #pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < subtrees.size(); ++i)
+        #endif
+        {
+          traverser.Traverse(*subtrees[i], *tree);
+        }
+      }
     }
 
     AddAllEdges();
@@ -148,8 +201,16 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      size_t baseCases = 0;
+      size_t scores = 0;
+      for (size_t i = 0; i < threads; ++i)
+      {
+        baseCases += rules[i].BaseCases();
+        scores += rules[i].Scores();
+      }
+
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -158,11 +219,15 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 
   EmitResults(results);
 
+  // Sum the lengths of the sorted edges, so that the total does not depend on
+  // the order in which the threads found them.
+  totalDist = arma::accu(results.row(2));
+
   Log::Info << "Total spanning tree length: " << totalDist << std::endl;
 }
 
 /**
- * Adds a single edge to the edge list
+ * Adds a single edge to the given edge list.
  */
 template<
     typename MetricType,
@@ -173,15 +238,16 @@ template<
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddEdge(
     const size_t e1,
     const size_t e2,
-    const double distance)
+    const double distance,
+    std::vector<EdgePair>& edgeList)
 {
   Log::Assert((distance >= 0.0),
       "DualTreeBoruvka::AddEdge(): distance cannot be negative.");
 
   if (e1 < e2)
-    edges.push_back(EdgePair(e1, e2, distance));
+    edgeList.push_back(EdgePair(e1, e2, distance));
   else
-    edges.push_back(EdgePair(e2, e1, distance));
+    edgeList.push_back(EdgePair(e2, e1, distance));
 }
 
 /**
@@ -195,20 +261,133 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
+  const size_t threads = neighborsDistances.size();
+  std::vector<std::vector<EdgePair>> threadEdges(threads);
+
+  #pragma omp parallel num_threads(threads)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    #ifdef _WIN32
+    #pragma omp for schedule(static)
+    for (intmax_t component = 0; component < (intmax_t) numComponents;
+        ++component)
+    #else
+    #pragma omp for schedule(static)
+    for (size_t component = 0; component < numComponents; ++component)
+    #endif
     {
-      //totalDist = totalDist + dist;
-      // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
+      // Find the best candidate edge of any thread; ties go to the thread
+      // with the lowest index.
+      size_t best = 0;
+      for (size_t i = 1; i < threads; ++i)
+        if (neighborsDistances[i][component] <
+            neighborsDistances[best][component])
+          best = i;
+
+      const size_t inEdge = neighborsInComponent[best][component];
+      const size_t outEdge = neighborsOutComponent[best][component];
+
+      // If two components chose edges that join them, only the first union
+      // succeeds, so no cycle is added to the tree.
+      if (connections.Union(inEdge, outEdge))
+      {
+        AddEdge(inEdge, outEdge, neighborsDistances[best][component],
+            threadEdges[thread]);
+      }
     }
   }
+
+  for (size_t i = 0; i < threads; ++i)
+    edges.insert(edges.end(), threadEdges[i].begin(), threadEdges[i].end());
+}
+
+/**
+ * Find the component of each point, and number the components from 0.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::UpdateComponents()
+{
+  pointComponents.set_size(data.n_cols);
+
+  // No unions happen here, so the roots can be found in parallel.
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+  #else
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < data.n_cols; ++i)
+  #endif
+    pointComponents[i] = connections.Find(i);
+
+  // Number the roots in order, so that the candidate arrays only need one
+  // entry per component.
+  arma::Col<size_t> componentIndices(data.n_cols);
+  numComponents = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    if (pointComponents[i] == i)
+      componentIndices[i] = numComponents++;
+
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+  #else
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < data.n_cols; ++i)
+  #endif
+    pointComponents[i] = componentIndices[pointComponents[i]];
+}
+
+/**
+ * Collect query subtrees that partition the points of the tree.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::QuerySubtrees(
+    const size_t threads,
+    std::vector<Tree*>& subtrees)
+{
+  subtrees.clear();
+  subtrees.push_back(tree);
+  if (threads == 1)
+    return;
+
+  // Replace every node that has children by its children until there are
+  // enough subtrees to keep all of the threads busy.  The children of a node
+  // hold all of its points, so the subtrees still cover every point.
+  while (subtrees.size() < 16 * threads)
+  {
+    std::vector<Tree*> children;
+    bool split = false;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() == 0)
+      {
+        children.push_back(subtrees[i]);
+        continue;
+      }
+
+      split = true;
+      for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+        children.push_back(&subtrees[i]->Child(j));
+    }
+
+    subtrees.swap(children);
+    if (!split)
+      break;
+  }
 }
 
 /**
@@ -291,7 +470,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      pointComponents[tree->Point(0)];
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -300,7 +479,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (pointComponents[tree->Point(i)] != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -318,8 +497,15 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
-    neighborsDistances[i] = DBL_MAX;
+  UpdateComponents();
+
+  for (size_t i = 0; i < neighborsDistances.size(); ++i)
+  {
+    neighborsInComponent[i].set_size(numComponents);
+    neighborsOutComponent[i].set_size(numComponents);
+    neighborsDistances[i].set_size(numComponents);
+    neighborsDistances[i].fill(DBL_MAX);
+  }
 
   if (!naive)
     CleanupHelper(tree);
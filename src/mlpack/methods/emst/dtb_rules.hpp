@@ -23,8 +23,13 @@ template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the rules.  The candidate arrays are indexed by component, and
+   * pointComponents gives the component of each point for this iteration.
+   * Each thread of a parallel search should have its own candidate arrays.
+   */
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
+           const arma::Col<size_t>& pointComponents,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
@@ -101,8 +106,8 @@ class DTBRules
   //! The data points.
   const arma::mat& dataSet;
 
-  //! Stores the tree structure so far
-  UnionFind& connections;
+  //! The component of each point at this iteration.
+  const arma::Col<size_t>& pointComponents;
 
   //! The distance to the candidate nearest neighbor for each component.
   arma::vec& neighborsDistances;
@@ -36,9 +36,9 @@ class DTBStat
   double bound;
 
   //! The index of the component that all points in this node belong to.  This
-  //! is the same index returned by UnionFind for all points in this node.  If
-  //! points in this node are in different components, this value will be
-  //! negative.
+  //! is the dense component id (0 to the number of components - 1) that
+  //! DualTreeBoruvka assigns to the points in each round.  If points in this
+  //! node are in different components, this value will be negative.
   int componentMembership;
 
  public:
@@ -285,6 +285,25 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  /**
+   * Brute-force search for the k points with maximum kernel value to each
+   * query point.  The kernel is evaluated on blocks of query and reference
+   * points at once (see kernel::EvaluateBlock()), so kernels that can compute
+   * whole blocks of the kernel matrix with matrix operations are much faster.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param monochromatic If true, the query set is the reference set, and a
+   *     point is not returned as its own candidate.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool monochromatic);
 };
 
 } // namespace fastmks
@@ -18,6 +18,7 @@
 #include "fastmks_rules.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 
 namespace mlpack {
 namespace fastmks {
@@ -304,33 +305,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
 
@@ -433,36 +408,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
     Timer::Stop("computing_products");
 
@@ -502,6 +448,85 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool monochromatic)
+{
+  // The kernel values between a block of query points and a block of
+  // reference points are computed at once.  For each query point, the
+  // reference points are still considered in order, so the results are the
+  // same as those of a simple double loop.
+  const size_t queryBlockSize = 256;
+  const size_t referenceBlockSize = 1024;
+
+  const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+  arma::mat blockKernels;
+  for (size_t qBegin = 0; qBegin < querySet.n_cols; qBegin += queryBlockSize)
+  {
+    const size_t qEnd = std::min(qBegin + queryBlockSize,
+        (size_t) querySet.n_cols);
+    const MatType queryBlock = querySet.cols(qBegin, qEnd - 1);
+
+    std::vector<CandidateList> pqueues;
+    pqueues.reserve(qEnd - qBegin);
+    for (size_t q = qBegin; q < qEnd; ++q)
+    {
+      std::vector<Candidate> cList(k, def);
+      pqueues.push_back(CandidateList(CandidateCmp(), std::move(cList)));
+    }
+
+    for (size_t rBegin = 0; rBegin < referenceSet->n_cols;
+         rBegin += referenceBlockSize)
+    {
+      const size_t rEnd = std::min(rBegin + referenceBlockSize,
+          (size_t) referenceSet->n_cols);
+      const MatType referenceBlock = referenceSet->cols(rBegin, rEnd - 1);
+
+      kernel::EvaluateBlock(metric.Kernel(), referenceBlock, queryBlock,
+          blockKernels);
+
+      for (size_t q = qBegin; q < qEnd; ++q)
+      {
+        CandidateList& pqueue = pqueues[q - qBegin];
+        const double* evals = blockKernels.colptr(q - qBegin);
+        for (size_t r = rBegin; r < rEnd; ++r)
+        {
+          // Don't return the point as its own candidate.
+          if (monochromatic && q == r)
+            continue;
+
+          const double eval = evals[r - rBegin];
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
+        }
+      }
+    }
+
+    for (size_t q = qBegin; q < qEnd; ++q)
+    {
+      CandidateList& pqueue = pqueues[q - qBegin];
+      for (size_t j = 1; j <= k; j++)
+      {
+        indices(k - j, q) = pqueue.top().second;
+        kernels(k - j, q) = pqueue.top().first;
+        pqueue.pop();
+      }
+    }
+  }
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
@@ -148,19 +148,59 @@ class EMFit
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Run the E-step of the EM algorithm: compute the responsibility of each
+   * Gaussian for each observation, and sum the statistics that the M-step
+   * needs.  For each Gaussian, these are the sum of its responsibilities, and
+   * the responsibility-weighted sums of the differences between the
+   * observations and the current mean, and of the outer products of those
+   * differences.  The differences are taken to the current mean so that the
+   * covariance can be computed from the sums without cancellation.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
-   * @param weights Vector of a priori weights.
+   * The responsibilities are computed in log space, and the observations are
+   * processed in blocks of columns in parallel, each thread with its own sums.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each point being from this model, or
+   *     an empty vector if all points should have weight 1.
+   * @param dists Current Gaussians.
+   * @param weights Current a priori weights.
+   * @param responsibilitySums Vector to store the sum of the responsibilities
+   *     of each Gaussian in.
+   * @param meanSums Matrix to store the weighted sum of the differences to the
+   *     mean of each Gaussian in (one column per Gaussian).
+   * @param covarianceSums Cube to store the weighted sum of the outer products
+   *     of the differences to the mean of each Gaussian in (one slice per
+   *     Gaussian).
+   * @return Log-likelihood of the observations under the current model.
+   */
+  double ExpectationStep(
+      const arma::mat& observations,
+      const arma::vec& probabilities,
+      const std::vector<distribution::GaussianDistribution>& dists,
+      const arma::vec& weights,
+      arma::vec& responsibilitySums,
+      arma::mat& meanSums,
+      arma::cube& covarianceSums) const;
+
+  /**
+   * Run the M-step of the EM algorithm: update the Gaussians and the weights
+   * from the statistics computed by ExpectationStep().  Gaussians that are
+   * not responsible for any observation are not changed.
+   *
+   * @param responsibilitySums Sum of the responsibilities of each Gaussian.
+   * @param meanSums Weighted sum of the differences to each mean.
+   * @param covarianceSums Weighted sum of the outer products of the
+   *     differences to each mean.
+   * @param totalWeight Total weight of all observations.
+   * @param dists Gaussians to update.
+   * @param weights A priori weights to update.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  void MaximizationStep(const arma::vec& responsibilitySums,
+                        const arma::mat& meanSums,
+                        const arma::cube& covarianceSums,
+                        const double totalWeight,
+                        std::vector<distribution::GaussianDistribution>& dists,
+                        arma::vec& weights);
 
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
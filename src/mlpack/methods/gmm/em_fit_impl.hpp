@@ -16,6 +16,10 @@
 // In case it hasn't been included yet.
 #include "em_fit.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace gmm {
 
@@ -43,13 +47,18 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step also gives the log-likelihood of the current model, so each
+  // iteration needs only one pass over the observations.
+  arma::vec responsibilitySums;
+  arma::mat meanSums;
+  arma::cube covarianceSums;
+  double l = ExpectationStep(observations, arma::vec(), dists, weights,
+      responsibilitySums, meanSums, covarianceSums);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -58,62 +67,17 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = probRowSums / observations.n_cols;
+    // Calculate the new means, covariances and weights from the conditional
+    // probabilities of choosing each Gaussian given the observations and the
+    // present theta value.
+    MaximizationStep(responsibilitySums, meanSums, covarianceSums,
+        observations.n_cols, dists, weights);
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood, and the statistics for
+    // the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ExpectationStep(observations, arma::vec(), dists, weights,
+        responsibilitySums, meanSums, covarianceSums);
 
     iteration++;
   }
@@ -130,78 +94,35 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step also gives the log-likelihood of the current model, so each
+  // iteration needs only one pass over the observations.
+  arma::vec responsibilitySums;
+  arma::mat meanSums;
+  arma::cube covarianceSums;
+  double l = ExpectationStep(observations, probabilities, dists, weights,
+      responsibilitySums, meanSums, covarianceSums);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
-
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(cov);
-
-      dists[i].Covariance(std::move(cov));
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = probRowSums / accu(probabilities);
-
-    // Update values of l; calculate new log-likelihood.
+    // Calculate the new means, covariances and weights from the conditional
+    // probabilities of choosing each Gaussian given the observations and the
+    // present theta value, weighted by the probability of each point being
+    // from this mixture model.
+    MaximizationStep(responsibilitySums, meanSums, covarianceSums,
+        accu(probabilities), dists, weights);
+
+    // Update values of l; calculate new log-likelihood, and the statistics for
+    // the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ExpectationStep(observations, probabilities, dists, weights,
+        responsibilitySums, meanSums, covarianceSums);
 
     iteration++;
   }
@@ -275,33 +196,172 @@ InitialClustering(const arma::mat& observations,
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
-    const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+ExpectationStep(const arma::mat& observations,
+                const arma::vec& probabilities,
+                const std::vector<distribution::GaussianDistribution>& dists,
+                const arma::vec& weights,
+                arma::vec& responsibilitySums,
+                arma::mat& meanSums,
+                arma::cube& covarianceSums) const
 {
-  double logLikelihood = 0;
+  const size_t dimensionality = observations.n_rows;
+  const size_t components = dists.size();
+
+  // The observations are processed in blocks of columns, so that the work of
+  // each block is done with a few matrix operations.
+  const size_t blockSize = 1024;
+  const size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  const arma::vec logWeights = log(weights);
+
+  // Each thread sums its own statistics; these are summed in order of the
+  // threads afterwards, so that the result does not depend on timing.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  threads = omp_get_max_threads();
+  #endif
+
+  std::vector<arma::vec> threadResponsibilitySums(threads,
+      arma::zeros<arma::vec>(components));
+  std::vector<arma::mat> threadMeanSums(threads,
+      arma::zeros<arma::mat>(dimensionality, components));
+  std::vector<arma::cube> threadCovarianceSums(threads,
+      arma::zeros<arma::cube>(dimensionality, dimensionality, components));
+  std::vector<double> threadLogLikelihood(threads, 0.0);
+  std::vector<size_t> threadOutliers(threads, 0);
+
+  #pragma omp parallel num_threads(threads)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    arma::mat logProbabilities;
+    arma::vec componentLogProbabilities;
+
+    // On the Visual Studio compiler, we have to use intmax_t because size_t is
+    // not yet supported by their OpenMP implementation.
+    #ifdef _WIN32
+    #pragma omp for schedule(static)
+    for (intmax_t block = 0; block < (intmax_t) blocks; ++block)
+    #else
+    #pragma omp for schedule(static)
+    for (size_t block = 0; block < blocks; ++block)
+    #endif
+    {
+      const size_t begin = block * blockSize;
+      const size_t end = std::min((size_t) (block + 1) * blockSize,
+          (size_t) observations.n_cols);
+      const arma::mat points = observations.cols(begin, end - 1);
+
+      // Compute the log of the weighted probability of each point under each
+      // Gaussian, with one column per point.  The Gaussians use their factored
+      // covariance, which is computed only when the covariance changes.
+      logProbabilities.set_size(components, points.n_cols);
+      for (size_t i = 0; i < components; ++i)
+      {
+        dists[i].LogProbability(points, componentLogProbabilities);
+        logProbabilities.row(i) = trans(componentLogProbabilities) +
+            logWeights[i];
+      }
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
+      // Normalize each column with the log-sum-exp trick, which turns the log
+      // probabilities into the conditional probabilities of each Gaussian.
+      for (size_t j = 0; j < points.n_cols; ++j)
+      {
+        const double maxLogProbability = logProbabilities.col(j).max();
+        if (maxLogProbability == -std::numeric_limits<double>::infinity())
+        {
+          // The point can't be from any Gaussian; it doesn't count.
+          logProbabilities.col(j).zeros();
+          threadLogLikelihood[thread] += maxLogProbability;
+          ++threadOutliers[thread];
+          continue;
+        }
+
+        logProbabilities.col(j) = exp(logProbabilities.col(j) -
+            maxLogProbability);
+        const double sum = accu(logProbabilities.col(j));
+        logProbabilities.col(j) /= sum;
+        threadLogLikelihood[thread] += maxLogProbability + std::log(sum);
+      }
 
-  for (size_t i = 0; i < dists.size(); ++i)
-  {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+      // Now the matrix holds the conditional probabilities.
+      arma::mat& condProb = logProbabilities;
+      if (probabilities.n_elem > 0)
+        condProb.each_row() %= trans(probabilities.subvec(begin, end - 1));
+
+      threadResponsibilitySums[thread] += arma::sum(condProb, 1);
+      for (size_t i = 0; i < components; ++i)
+      {
+        const arma::mat diffs = points.each_col() - dists[i].Mean();
+        arma::mat weightedDiffs = diffs;
+        weightedDiffs.each_row() %= condProb.row(i);
+
+        threadMeanSums[thread].col(i) += arma::sum(weightedDiffs, 1);
+        threadCovarianceSums[thread].slice(i) += weightedDiffs * trans(diffs);
+      }
+    }
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  // Sum the statistics of all threads.
+  responsibilitySums = std::move(threadResponsibilitySums[0]);
+  meanSums = std::move(threadMeanSums[0]);
+  covarianceSums = std::move(threadCovarianceSums[0]);
+  double logLikelihood = threadLogLikelihood[0];
+  size_t outliers = threadOutliers[0];
+  for (size_t thread = 1; thread < threads; ++thread)
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    responsibilitySums += threadResponsibilitySums[thread];
+    meanSums += threadMeanSums[thread];
+    covarianceSums += threadCovarianceSums[thread];
+    logLikelihood += threadLogLikelihood[thread];
+    outliers += threadOutliers[thread];
   }
 
+  if (outliers > 0)
+    Log::Info << "Likelihood of " << outliers << " points is 0!  They are "
+        << "probably outliers." << std::endl;
+
   return logLikelihood;
 }
 
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+MaximizationStep(const arma::vec& responsibilitySums,
+                 const arma::mat& meanSums,
+                 const arma::cube& covarianceSums,
+                 const double totalWeight,
+                 std::vector<distribution::GaussianDistribution>& dists,
+                 arma::vec& weights)
+{
+  for (size_t i = 0; i < dists.size(); i++)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (responsibilitySums[i] == 0.0)
+      continue;
+
+    // The sums are of the differences to the old mean, so the new mean is the
+    // old mean moved by the average difference.  The covariance around the new
+    // mean then follows from the covariance around the old mean.
+    const arma::vec shift = meanSums.col(i) / responsibilitySums[i];
+    dists[i].Mean() += shift;
+
+    arma::mat covariance = covarianceSums.slice(i) / responsibilitySums[i] -
+        shift * trans(shift);
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  // Calculate the new values for omega using the updated conditional
+  // probabilities.
+  weights = responsibilitySums / totalWeight;
+}
+
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
 template<typename Archive>
 void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Serialize(
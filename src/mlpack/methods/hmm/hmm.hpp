@@ -359,6 +359,48 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * Compute the log-probability of every observation in the given data
+   * sequence under the emission distribution of every hidden state.  The
+   * returned matrix has rows equal to the number of hidden states and columns
+   * equal to the number of observations.  If the distribution can compute the
+   * log-probabilities of a whole matrix of observations at once, that is used.
+   *
+   * @param dataSeq Data sequence to compute log-probabilities for.
+   * @param logEmissionProb Matrix in which log-probabilities will be saved.
+   */
+  void EmissionLogProbability(const arma::mat& dataSeq,
+                              arma::mat& logEmissionProb) const;
+
+  /**
+   * The Forward algorithm, given the log-probabilities of the emissions (from
+   * EmissionLogProbability()).  The forward probabilities are identical to
+   * those of Forward(), but the logs of the scaling factors are returned
+   * instead, so that observations whose probability underflows can be handled.
+   *
+   * @param logEmissionProb Log-probabilities of the emissions.
+   * @param logScales Vector in which the logs of the scaling factors will be
+   *     saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   */
+  void LogForward(const arma::mat& logEmissionProb,
+                  arma::vec& logScales,
+                  arma::mat& forwardProb) const;
+
+  /**
+   * The Backward algorithm, given the log-probabilities of the emissions (from
+   * EmissionLogProbability()) and the logs of the scaling factors found by
+   * LogForward().  The backward probabilities are identical to those of
+   * Backward().
+   *
+   * @param logEmissionProb Log-probabilities of the emissions.
+   * @param logScales Vector of the logs of the scaling factors.
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  void LogBackward(const arma::mat& logEmissionProb,
+                   const arma::vec& logScales,
+                   arma::mat& backwardProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -17,9 +17,89 @@
 // Just in case...
 #include "hmm.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace hmm {
 
+/**
+ * This gives us a HasLogProbabilityCheck object that we can use to tell how a
+ * Distribution can compute log-probabilities.
+ */
+HAS_MEM_FUNC(LogProbability, HasLogProbabilityCheck);
+
+/**
+ * 'value' is true if the Distribution class has a member
+ * LogProbability(const arma::mat& observations, arma::vec& logProbabilities),
+ * which computes the log-probabilities of many observations at once.
+ */
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  static const bool value = HasLogProbabilityCheck<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
+/**
+ * 'value' is true if the Distribution class has a member
+ * double LogProbability(const arma::vec& observation).
+ */
+template<typename Distribution>
+struct HasSingleLogProbability
+{
+  static const bool value = HasLogProbabilityCheck<Distribution,
+      double(Distribution::*)(const arma::vec&) const>::value;
+};
+
+//! Compute the log-probabilities of all observations with one call, if the
+//! distribution supports it.
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename std::enable_if<
+        HasBatchLogProbability<Distribution>::value>::type* = 0)
+{
+  distribution.LogProbability(observations, logProbabilities);
+}
+
+//! Compute the log-probability of each observation separately, if the
+//! distribution can only do that.
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename std::enable_if<
+        !HasBatchLogProbability<Distribution>::value &&
+        HasSingleLogProbability<Distribution>::value>::type* = 0)
+{
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    logProbabilities[i] =
+        distribution.LogProbability(observations.unsafe_col(i));
+}
+
+//! Compute the log of the probability of each observation, if the distribution
+//! can't compute log-probabilities.
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename std::enable_if<
+        !HasBatchLogProbability<Distribution>::value &&
+        !HasSingleLogProbability<Distribution>::value>::type* = 0)
+{
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    logProbabilities[i] =
+        std::log(distribution.Probability(observations.unsafe_col(i)));
+}
+
 /**
  * Create the Hidden Markov Model with the given number of hidden states and the
  * given number of emission states.
@@ -91,10 +171,13 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
+  // Find length of all sequences and ensure they are the correct size.  We
+  // also store where each sequence starts in the list of all observations.
   size_t totalLength = 0;
+  std::vector<size_t> seqStart(dataSeq.size());
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
+    seqStart[seq] = totalLength;
     totalLength += dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
@@ -107,7 +190,22 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // all now so we don't have to do any allocation later on.
   std::vector<arma::vec> emissionProb(transition.n_cols,
       arma::vec(totalLength));
+
+  // The list of emission observations (for Distribution::Train()) is the same
+  // in every iteration.
   arma::mat emissionList(dimensionality, totalLength);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(seqStart[seq], seqStart[seq] + dataSeq[seq].n_cols - 1)
+          = dataSeq[seq];
+
+  // The sequences are independent, so the E-step is run on several sequences
+  // at once.  Each thread accumulates its own statistics; these are summed in
+  // order of the threads, so that the result does not depend on timing.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  threads = omp_get_max_threads();
+  #endif
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -115,60 +213,85 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   for (size_t iter = 0; iter < iterations; iter++)
   {
     // Clear new transition matrix and emission probabilities.
-    arma::vec newInitial(transition.n_rows);
-    newInitial.zeros();
-    arma::mat newTransition(transition.n_rows, transition.n_cols);
-    newTransition.zeros();
+    std::vector<arma::vec> threadInitial(threads,
+        arma::zeros<arma::vec>(transition.n_rows));
+    std::vector<arma::mat> threadTransition(threads,
+        arma::zeros<arma::mat>(transition.n_rows, transition.n_cols));
+    std::vector<double> threadLoglik(threads, 0.0);
 
-    // Reset log likelihood.
-    loglik = 0;
+    #pragma omp parallel num_threads(threads)
+    {
+      size_t thread = 0;
+      #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+      #endif
 
-    // Sum over time.
-    size_t sumTime = 0;
+      arma::vec& newInitial = threadInitial[thread];
+      arma::mat& newTransition = threadTransition[thread];
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
-    {
-      arma::mat stateProb;
+      arma::mat logEmissionProb;
       arma::mat forward;
       arma::mat backward;
-      arma::vec scales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newInitial[j] += stateProb(j, 0);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec logScales;
+
+      // Loop over each sequence.  On the Visual Studio compiler, we have to
+      // use intmax_t because size_t is not yet supported by their OpenMP
+      // implementation.
+      #ifdef _WIN32
+      #pragma omp for schedule(static)
+      for (intmax_t seq = 0; seq < (intmax_t) dataSeq.size(); seq++)
+      #else
+      #pragma omp for schedule(static)
+      for (size_t seq = 0; seq < dataSeq.size(); seq++)
+      #endif
       {
-        for (size_t j = 0; j < transition.n_cols; ++j)
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        EmissionLogProbability(dataSeq[seq], logEmissionProb);
+        LogForward(logEmissionProb, logScales, forward);
+        LogBackward(logEmissionProb, logScales, backward);
+        threadLoglik[thread] += accu(logScales);
+
+        // Add to estimate of initial probability for state j.
+        newInitial += forward.col(0) % backward.col(0);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.  The estimate of
+        // T_ij (probability of transition from state j to state i) for time t
+        // is an outer product; we postpone multiplication of the old T_ij until
+        // later.
+        for (size_t t = 0; t + 1 < dataSeq[seq].n_cols; ++t)
         {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+          const double logScale = std::isfinite(logScales[t + 1]) ?
+              logScales[t + 1] : 0.0;
+          newTransition += (backward.col(t + 1) %
+              exp(logEmissionProb.col(t + 1) - logScale)) * forward.col(t).t();
         }
-        sumTime++;
+
+        // Store the probability of each observation for
+        // Distribution::Train().
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+          for (size_t j = 0; j < transition.n_cols; ++j)
+            emissionProb[j][seqStart[seq] + t] = forward(j, t) *
+                backward(j, t);
       }
     }
 
+    // Sum the statistics of all threads.
+    arma::vec newInitial = threadInitial[0];
+    arma::mat newTransition = threadTransition[0];
+    loglik = threadLoglik[0];
+    for (size_t thread = 1; thread < threads; ++thread)
+    {
+      newInitial += threadInitial[thread];
+      newTransition += threadTransition[thread];
+      loglik += threadLoglik[thread];
+    }
+
     // Normalize the new initial probabilities.
     if (dataSeq.size() > 1)
       initial = newInitial / dataSeq.size();
@@ -314,16 +437,22 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& backwardProb,
                                    arma::vec& scales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  // First run the forward-backward algorithm.  The emission probabilities are
+  // computed only once for both passes.
+  arma::mat logEmissionProb;
+  arma::vec logScales;
+  EmissionLogProbability(dataSeq, logEmissionProb);
+  LogForward(logEmissionProb, logScales, forwardProb);
+  LogBackward(logEmissionProb, logScales, backwardProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
   stateProb = forwardProb % backwardProb;
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  // Finally assemble the log-likelihood and return it.  The log-likelihood is
+  // computed from the logs of the scaling factors, which can't underflow.
+  scales = exp(logScales);
+  return accu(logScales);
 }
 
 /**
@@ -400,12 +529,16 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
+  // probable sequence of states to produce the observed data sequence.  All
+  // calculations are done with log-probabilities, so that long sequences don't
+  // underflow.
   stateSeq.set_size(dataSeq.n_cols);
   arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
+  arma::Mat<size_t> stateSeqBack(transition.n_rows, dataSeq.n_cols);
+
+  // The log-probabilities of all emissions are computed at once.
+  arma::mat logEmissionProb;
+  EmissionLogProbability(dataSeq, logEmissionProb);
 
   // Store the logs of the transposed transition matrix.  This is because we
   // will be using the rows of the transition matrix.
@@ -414,16 +547,13 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
+  logStateProb.col(0) = log(initial) + logEmissionProb.col(0);
   for (size_t state = 0; state < transition.n_rows; state++)
-  {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
     stateSeqBack(state, 0) = state;
-  }
 
   // Store the best first state.
   arma::uword index;
+  arma::vec prob(transition.n_rows);
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
     // Assemble the state probability for this element.
@@ -431,10 +561,9 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     // of being the previous state.
     for (size_t j = 0; j < transition.n_rows; j++)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
-        stateSeqBack(j, t) = index;
+      prob = logStateProb.col(t - 1) + logTrans.col(j);
+      logStateProb(j, t) = prob.max(index) + logEmissionProb(j, t);
+      stateSeqBack(j, t) = index;
     }
   }
 
@@ -454,13 +583,15 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
+  arma::mat logEmissionProb;
   arma::mat forward;
-  arma::vec scales;
+  arma::vec logScales;
 
-  Forward(dataSeq, scales, forward);
+  EmissionLogProbability(dataSeq, logEmissionProb);
+  LogForward(logEmissionProb, logScales, forward);
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+  // The log-likelihood is the sum of the logs of the scales for each time step.
+  return accu(logScales);
 }
 
 /**
@@ -512,75 +643,125 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat logEmissionProb;
+  arma::vec logScales;
+  EmissionLogProbability(dataSeq, logEmissionProb);
+  LogForward(logEmissionProb, logScales, forwardProb);
+
+  scales = exp(logScales);
+}
+
+/**
+ * The Backward procedure (part of the Forward-Backward algorithm).
+ */
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  arma::mat logEmissionProb;
+  EmissionLogProbability(dataSeq, logEmissionProb);
+  LogBackward(logEmissionProb, arma::vec(log(scales)), backwardProb);
+}
+
+/**
+ * Compute the log-probabilities of each observation under each emission
+ * distribution.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbability(const arma::mat& dataSeq,
+                                               arma::mat& logEmissionProb) const
+{
+  logEmissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+
+  arma::vec logProbabilities;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    EmissionLogProbabilities(emission[state], dataSeq, logProbabilities);
+    logEmissionProb.row(state) = trans(logProbabilities);
+  }
+}
+
+/**
+ * The Forward procedure, given the log-probabilities of the emissions.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogForward(const arma::mat& logEmissionProb,
+                                   arma::vec& logScales,
+                                   arma::mat& forwardProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  // Each column is computed in the log domain and then normalized, which is
+  // the log-sum-exp trick: the largest term is factored out before the
+  // exponentiation, so that emission probabilities that are too small to be
+  // represented don't make the whole column zero.
+  forwardProb.zeros(transition.n_rows, logEmissionProb.n_cols);
+  logScales.zeros(logEmissionProb.n_cols);
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
-
-  // Then normalize the column.
-  scales[0] = accu(forwardProb.col(0));
-  if (scales[0] > 0.0)
-    forwardProb.col(0) /= scales[0];
-
-  // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  arma::vec logProb = log(initial) + logEmissionProb.col(0);
+  for (size_t t = 0; t < logEmissionProb.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    if (t > 0)
+    {
+      // The forward probability of state j at time t is the sum over all
+      // states of the probability of the previous state transitioning to the
+      // current state and emitting the given observation.  The previous column
+      // is normalized, so the sum can't underflow unless it is zero.
+      logProb = log(transition * forwardProb.col(t - 1)) +
+          logEmissionProb.col(t);
+    }
+
+    // Then normalize the column.  If no state is possible, the column stays
+    // zero.
+    const double maxLogProb = logProb.max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
     {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
+      logScales[t] = maxLogProb;
+      continue;
     }
 
-    // Normalize probability.
-    scales[t] = accu(forwardProb.col(t));
-    if (scales[t] > 0.0)
-      forwardProb.col(t) /= scales[t];
+    forwardProb.col(t) = exp(logProb - maxLogProb);
+    const double sum = accu(forwardProb.col(t));
+    forwardProb.col(t) /= sum;
+    logScales[t] = maxLogProb + std::log(sum);
   }
 }
 
+/**
+ * The Backward procedure, given the log-probabilities of the emissions.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+void HMM<Distribution>::LogBackward(const arma::mat& logEmissionProb,
+                                    const arma::vec& logScales,
+                                    arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.zeros(transition.n_rows, logEmissionProb.n_cols);
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardProb.col(logEmissionProb.n_cols - 1).fill(1);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = logEmissionProb.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      if (scales[t + 1] > 0.0)
-        backwardProb(j, t) /= scales[t + 1];
-    }
+    // The backward probability of state j at time t is the sum over all states
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.  This is normalized by the weights from
+    // the forward algorithm, which are divided out of the emission
+    // probabilities in the log domain.
+    const double logScale = std::isfinite(logScales[t + 1]) ?
+        logScales[t + 1] : 0.0;
+    backwardProb.col(t) = trans(transition) * (backwardProb.col(t + 1) %
+        exp(logEmissionProb.col(t + 1) - logScale));
   }
 }
 
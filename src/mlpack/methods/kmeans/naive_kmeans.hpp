@@ -14,6 +14,8 @@
 #ifndef MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 
+#include <mlpack/core/metrics/lmetric.hpp>
+
 namespace mlpack {
 namespace kmeans {
 
@@ -23,6 +25,12 @@ namespace kmeans {
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * When the metric is the (squared) Euclidean distance, the assignment step is
+ * performed in blocks of points: the distances between a block of points and
+ * all centroids are obtained with a single matrix multiplication using the
+ * expansion ||x - c||^2 = ||x||^2 - 2 x^T c + ||c||^2, and the blocks are
+ * distributed over all available threads (if OpenMP is enabled).
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -55,6 +63,32 @@ class NaiveKMeans
   size_t DistanceCalculations() const { return distanceCalculations; }
 
  private:
+  /**
+   * Assign every point to its closest centroid using the given metric, and
+   * accumulate the sum of the assigned points in newCentroids and their number
+   * in counts.
+   */
+  template<typename AssignMetricType>
+  void AssignPoints(const arma::mat& centroids,
+                    arma::mat& newCentroids,
+                    arma::Col<size_t>& counts,
+                    AssignMetricType& assignMetric);
+
+  /**
+   * Assign every point to its closest centroid under the Euclidean distance.
+   * The distances are computed blockwise with a matrix multiplication, and the
+   * blocks are processed in parallel with thread-local accumulators, which are
+   * added in order of the threads so that the result is deterministic.
+   */
+  template<bool TakeRoot>
+  void AssignPoints(const arma::mat& centroids,
+                    arma::mat& newCentroids,
+                    arma::Col<size_t>& counts,
+                    metric::LMetric<2, TakeRoot>& assignMetric);
+
+  //! Number of points that are assigned together in the blocked assignment.
+  static const size_t blockSize = 1024;
+
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
@@ -17,6 +17,10 @@
 // In case it hasn't been included yet.
 #include "naive_kmeans.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace kmeans {
 
@@ -38,6 +42,35 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   counts.zeros(centroids.n_cols);
 
   // Find the closest centroid to each point and update the new centroids.
+  AssignPoints(centroids, newCentroids, counts, metric);
+
+  // Now normalize the centroid.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (counts(i) != 0)
+      newCentroids.col(i) /= counts(i);
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+template<typename AssignMetricType>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts,
+    AssignMetricType& assignMetric)
+{
   for (size_t i = 0; i < dataset.n_cols; i++)
   {
     // Find the closest centroid to this point.
@@ -46,7 +79,8 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
 
     for (size_t j = 0; j < centroids.n_cols; j++)
     {
-      const double distance = metric.Evaluate(dataset.col(i), centroids.col(j));
+      const double distance = assignMetric.Evaluate(dataset.col(i),
+          centroids.col(j));
 
       if (distance < minDistance)
       {
@@ -61,24 +95,88 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     newCentroids.col(closestCluster) += arma::vec(dataset.col(i));
     counts(closestCluster)++;
   }
+}
 
-  // Now normalize the centroid.
-  for (size_t i = 0; i < centroids.n_cols; ++i)
-    if (counts(i) != 0)
-      newCentroids.col(i) /= counts(i);
+template<typename MetricType, typename MatType>
+template<bool TakeRoot>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts,
+    metric::LMetric<2, TakeRoot>& /* assignMetric */)
+{
+  // The norm of the point is the same for every centroid, so the closest
+  // centroid is the one minimizing ||c||^2 - 2 x^T c.
+  const arma::rowvec centroidNorms = arma::sum(arma::square(centroids), 0);
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
 
-  distanceCalculations += centroids.n_cols * dataset.n_cols;
+  // Each thread accumulates its own sums; these are added in order of the
+  // threads afterwards, so that the result does not depend on timing.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  threads = omp_get_max_threads();
+  #endif
 
-  // Calculate cluster distortion for this iteration.
-  double cNorm = 0.0;
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  std::vector<arma::mat> threadCentroids(threads,
+      arma::zeros<arma::mat>(centroids.n_rows, centroids.n_cols));
+  std::vector<arma::Col<size_t>> threadCounts(threads,
+      arma::zeros<arma::Col<size_t>>(centroids.n_cols));
+
+  #pragma omp parallel num_threads(threads)
   {
-    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
-        2.0);
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+    #endif
+
+    arma::mat& localCentroids = threadCentroids[thread];
+    arma::Col<size_t>& localCounts = threadCounts[thread];
+
+    // On the Visual Studio compiler, we have to use intmax_t because size_t is
+    // not yet supported by their OpenMP implementation.
+#ifdef _WIN32
+    #pragma omp for schedule(static)
+    for (intmax_t block = 0; block < (intmax_t) numBlocks; ++block)
+#else
+    #pragma omp for schedule(static)
+    for (size_t block = 0; block < numBlocks; ++block)
+#endif
+    {
+      const size_t begin = block * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) dataset.n_cols);
+
+      // Inner products between all centroids and all points of the block.
+      const arma::mat innerProducts = centroids.t() *
+          dataset.cols(begin, end - 1);
+
+      for (size_t i = 0; i < innerProducts.n_cols; ++i)
+      {
+        double minDistance = std::numeric_limits<double>::infinity();
+        size_t closestCluster = centroids.n_cols; // Invalid value.
+
+        for (size_t j = 0; j < centroids.n_cols; ++j)
+        {
+          const double distance = centroidNorms[j] - 2 * innerProducts(j, i);
+          if (distance < minDistance)
+          {
+            minDistance = distance;
+            closestCluster = j;
+          }
+        }
+
+        Log::Assert(closestCluster != centroids.n_cols);
+
+        localCentroids.col(closestCluster) += arma::vec(dataset.col(begin + i));
+        localCounts(closestCluster)++;
+      }
+    }
   }
-  distanceCalculations += centroids.n_cols;
 
-  return std::sqrt(cNorm);
+  for (size_t thread = 0; thread < threads; ++thread)
+  {
+    newCentroids += threadCentroids[thread];
+    counts += threadCounts[thread];
+  }
 }
 
 } // namespace kmeans
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/sparse_gradient_traits.hpp>
 
 namespace mlpack {
 namespace regression {
@@ -104,6 +105,38 @@ class LogisticRegressionFunction
                 const size_t i,
                 arma::mat& gradient) const;
 
+  /**
+   * Evaluate the sum of the gradients of the logistic regression log-likelihood
+   * function with respect to the points begin, ..., begin + batchSize - 1, with
+   * one matrix product.  This is used by mini-batch SGD.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param gradient Vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
+
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, and with respect to only one point in the
+   * dataset, as a sparse matrix.  Only the intercept and the features that are
+   * nonzero in the point are stored, so the regularization is only applied to
+   * those features (as is usual for sparse SGD).  ParallelSGD only uses this
+   * when the predictors are stored in a sparse matrix (see the
+   * SparseGradientTraits specialization below).
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param i Index of points to use for objective function gradient evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::sp_mat& gradient) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
@@ -122,6 +155,22 @@ class LogisticRegressionFunction
 };
 
 } // namespace regression
+
+namespace optimization {
+
+/**
+ * The sparse gradient of LogisticRegressionFunction doesn't regularize the
+ * features that are zero in the point, so ParallelSGD only uses it for sparse
+ * predictors; for dense predictors, it takes the same steps as SGD.
+ */
+template<typename MatType>
+class SparseGradientTraits<regression::LogisticRegressionFunction<MatType>>
+{
+ public:
+  static const bool UseSparseGradient = arma::is_SpMat<MatType>::value;
+};
+
+} // namespace optimization
 } // namespace mlpack
 
 // Include implementation.
@@ -76,10 +76,12 @@ double LogisticRegressionFunction<MatType>::Evaluate(
                 parameters.col(0).subvec(1, parameters.n_elem - 1));
 
   // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const arma::vec exponents = parameters(0, 0) + predictors.t() *
-      parameters.col(0).subvec(1, parameters.n_elem - 1);
-  const arma::vec sigmoid = 1.0 / (1.0 + arma::exp(-exponents));
+  // does not need to be multiplied by any of the predictors.  The parameters
+  // are multiplied from the left, so that sparse predictors don't have to be
+  // transposed.
+  const arma::rowvec exponents = parameters(0, 0) +
+      parameters.col(0).subvec(1, parameters.n_elem - 1).t() * predictors;
+  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-exponents));
 
   // Assemble full objective function.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
@@ -170,6 +172,73 @@ void LogisticRegressionFunction<MatType>::Gradient(
       * (responses[i] - sigmoid) + regularization;
 }
 
+/**
+ * Evaluate the sum of the individual gradients of the logistic regression
+ * objective function with respect to a contiguous batch of points.
+ */
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat& gradient) const
+{
+  const size_t end = begin + batchSize - 1;
+
+  // The regularization term of each point is the same.
+  arma::mat regularization;
+  regularization = lambda * parameters.col(0).subvec(1, parameters.n_elem - 1)
+      * batchSize / predictors.n_cols;
+
+  const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
+      - parameters.col(0).subvec(1, parameters.n_elem - 1).t() *
+      predictors.cols(begin, end))));
+  const arma::rowvec errors = arma::conv_to<arma::rowvec>::from(
+      responses.subvec(begin, end)) - sigmoids;
+
+  gradient.set_size(parameters.n_elem);
+  gradient[0] = -arma::accu(errors);
+  gradient.col(0).subvec(1, parameters.n_elem - 1) = -predictors.cols(begin,
+      end) * errors.t() + regularization;
+}
+
+/**
+ * Evaluate the individual gradient of the logistic regression objective
+ * function with respect to one point, as a sparse matrix that holds only the
+ * intercept and the nonzero features of the point.
+ */
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t i,
+    arma::sp_mat& gradient) const
+{
+  const arma::sp_vec point(predictors.col(i));
+
+  const double sigmoid = 1.0 / (1.0 + std::exp(-parameters(0, 0)
+      - arma::dot(predictors.col(i), parameters.col(0).subvec(1,
+      parameters.n_elem - 1))));
+  const double error = responses[i] - sigmoid;
+
+  arma::umat locations(2, point.n_nonzero + 1);
+  arma::vec values(point.n_nonzero + 1);
+  locations(0, 0) = 0;
+  locations(1, 0) = 0;
+  values[0] = -error;
+
+  size_t j = 1;
+  for (arma::sp_vec::const_iterator it = point.begin(); it != point.end();
+       ++it, ++j)
+  {
+    locations(0, j) = it.row() + 1;
+    locations(1, j) = 0;
+    values[j] = -(*it) * error + lambda * parameters(it.row() + 1, 0) /
+        predictors.n_cols;
+  }
+
+  gradient = arma::sp_mat(locations, values, parameters.n_elem, 1);
+}
+
 } // namespace regression
 } // namespace mlpack
 
@@ -129,9 +129,11 @@ void LogisticRegression<MatType>::Classify(const MatType& dataset,
 {
   // Calculate sigmoid function for each point.  The (1.0 - decisionBoundary)
   // term correctly sets an offset so that floor() returns 0 or 1 correctly.
+  // The parameters are multiplied from the left, so that a sparse dataset
+  // doesn't have to be transposed.
   labels = arma::conv_to<arma::Row<size_t>>::from((1.0 /
-      (1.0 + arma::exp(-parameters(0) - dataset.t() *
-      parameters.subvec(1, parameters.n_elem - 1)))) +
+      (1.0 + arma::exp(-parameters(0) -
+      parameters.subvec(1, parameters.n_elem - 1).t() * dataset))) +
       (1.0 - decisionBoundary));
 }
 
@@ -142,8 +144,8 @@ void LogisticRegression<MatType>::Classify(const MatType& dataset,
   // Set correct size of output matrix.
   probabilities.set_size(2, dataset.n_cols);
 
-  probabilities.row(1) = 1.0 / (1.0 + arma::exp(-parameters(0) - dataset.t() *
-      parameters.subvec(1, parameters.n_elem - 1))).t();
+  probabilities.row(1) = 1.0 / (1.0 + arma::exp(-parameters(0) -
+      parameters.subvec(1, parameters.n_elem - 1).t() * dataset));
   probabilities.row(0) = 1.0 - probabilities.row(1);
 }
 
@@ -153,7 +155,7 @@ double LogisticRegression<MatType>::ComputeError(
     const arma::Row<size_t>& responses) const
 {
   // Construct a new error function.
-  LogisticRegressionFunction<> newErrorFunction(predictors, responses,
+  LogisticRegressionFunction<MatType> newErrorFunction(predictors, responses,
       lambda);
 
   return newErrorFunction.Evaluate(parameters);
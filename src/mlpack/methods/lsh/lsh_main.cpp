@@ -41,12 +41,19 @@ PROGRAM_INFO("All K-Approximate-Nearest-Neighbor Search with LSH",
     "\n\n"
     "Because this is approximate-nearest-neighbors search, results may be "
     "different from run to run.  Thus, the --seed option can be specified to "
-    "set the random seed.");
+    "set the random seed."
+    "\n\n"
+    "Points can be added to an existing model without rebuilding its hash "
+    "tables by specifying them with --insert_file along with "
+    "--input_model_file; the new points get the indices after the points that "
+    "are already in the model.");
 
 // Define our input parameters that this program will take.
 PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
 PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
 PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+PARAM_MATRIX_IN("insert", "Matrix containing points to insert into the input "
+    "model.", "I");
 
 // We can load or save models.
 PARAM_MODEL_IN(LSHSearch<>, "input_model", "Input LSH model.", "m");
@@ -70,8 +77,8 @@ PARAM_INT_IN("num_probes", "Number of additional probes for multiprobe LSH; if "
     "0, traditional LSH is used.", "T", 0);
 PARAM_INT_IN("second_hash_size", "The size of the second level hash table.",
     "S", 99901);
-PARAM_INT_IN("bucket_size", "The size of a bucket in the second level hash.",
-    "B", 500);
+PARAM_INT_IN("bucket_size", "The maximum number of points in a bucket of the "
+    "second level hash; if 0, there is no limit.", "B", 0);
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 int main(int argc, char *argv[])
@@ -102,6 +109,12 @@ int main(int argc, char *argv[])
         << endl;
   }
 
+  if (CLI::HasParam("insert") && !CLI::HasParam("input_model"))
+  {
+    Log::Fatal << "--insert_file can only be specified with "
+        << "--input_model_file!" << endl;
+  }
+
   if (!CLI::HasParam("neighbors") && !CLI::HasParam("distances") &&
       !CLI::HasParam("output_model"))
   {
@@ -173,6 +186,18 @@ int main(int argc, char *argv[])
     allkann = std::move(CLI::GetParam<LSHSearch<>>("input_model"));
   }
 
+  if (CLI::HasParam("insert"))
+  {
+    arma::mat& insertData = CLI::GetParam<arma::mat>("insert");
+    Log::Info << "Loaded points to insert from '"
+        << CLI::GetUnmappedParam<arma::mat>("insert") << "' ("
+        << insertData.n_rows << " x " << insertData.n_cols << ")." << endl;
+
+    Timer::Start("hash_inserting");
+    allkann.Insert(insertData);
+    Timer::Stop("hash_inserting");
+  }
+
   if (CLI::HasParam("k"))
   {
     Log::Info << "Computing " << k << " distance approximate nearest neighbors."
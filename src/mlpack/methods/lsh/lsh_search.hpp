@@ -79,16 +79,15 @@ class LSHSearch
    *     upper bound on the nearest-neighbor distance in general.
    * @param secondHashSize The size of the second hash table. This should be a
    *     large prime number.
-   * @param bucketSize The size of the bucket in the second hash table. This is
-   *     the maximum number of points that can be hashed into single bucket.  A
-   *     value of 0 indicates that there is no limit (so the second hash table
-   *     can be arbitrarily large---be careful!).
+   * @param bucketSize The maximum number of points that are stored in a single
+   *     bucket of the second hash table; points that don't fit are dropped.  A
+   *     value of 0 (the default) indicates that there is no limit.
    */
   LSHSearch(const arma::mat& referenceSet,
             const arma::cube& projections,
             const double hashWidth = 0.0,
             const size_t secondHashSize = 99901,
-            const size_t bucketSize = 500);
+            const size_t bucketSize = 0);
 
   /**
    * This function initializes the LSH class. It builds the hash one the
@@ -106,17 +105,16 @@ class LSHSearch
    *     upper bound on the nearest-neighbor distance in general.
    * @param secondHashSize The size of the second hash table. This should be a
    *     large prime number.
-   * @param bucketSize The size of the bucket in the second hash table. This is
-   *     the maximum number of points that can be hashed into single bucket.  A
-   *     value of 0 indicates that there is no limit (so the second hash table
-   *     can be arbitrarily large---be careful!).
+   * @param bucketSize The maximum number of points that are stored in a single
+   *     bucket of the second hash table; points that don't fit are dropped.  A
+   *     value of 0 (the default) indicates that there is no limit.
    */
   LSHSearch(const arma::mat& referenceSet,
             const size_t numProj,
             const size_t numTables,
             const double hashWidth = 0.0,
             const size_t secondHashSize = 99901,
-            const size_t bucketSize = 500);
+            const size_t bucketSize = 0);
 
   /**
    * Create an untrained LSH model.  Be sure to call Train() before calling
@@ -173,10 +171,9 @@ class LSHSearch
    *     upper bound on the nearest-neighbor distance in general.
    * @param secondHashSize The size of the second hash table. This should be a
    *     large prime number.
-   * @param bucketSize The size of the bucket in the second hash table. This is
-   *     the maximum number of points that can be hashed into single bucket.  A
-   *     value of 0 indicates that there is no limit (so the second hash table
-   *     can be arbitrarily large---be careful!).
+   * @param bucketSize The maximum number of points that are stored in a single
+   *     bucket of the second hash table; points that don't fit are dropped.  A
+   *     value of 0 (the default) indicates that there is no limit.
    * @param projections Cube of projection tables. For a cube of size (a, b, c)
    *     we set numProj = a, numTables = c. b is the reference set
    *     dimensionality.
@@ -186,9 +183,21 @@ class LSHSearch
              const size_t numTables,
              const double hashWidth = 0.0,
              const size_t secondHashSize = 99901,
-             const size_t bucketSize = 500,
+             const size_t bucketSize = 0,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Insert new points into the trained LSH model.  The points are hashed with
+   * the existing projections and offsets and added to the buckets of the
+   * second hash table, so the hash tables are not rebuilt.  The new points are
+   * appended to the reference set, and so get the indices after the points
+   * already in the model.  Because of this, the model takes a copy of the
+   * reference set (if it did not hold one already).
+   *
+   * @param newPoints Points to insert.
+   */
+  void Insert(const arma::mat& newPoints);
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -281,9 +290,13 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the offsets of the buckets of the second hash table in
+  //! BucketContents(): bucket i holds the elements from BucketOffsets()[i] up
+  //! to (but not including) BucketOffsets()[i + 1].
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  //! Get the points in the buckets of the second hash table, bucket by bucket.
+  const arma::Col<size_t>& BucketContents() const { return bucketContents; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -297,6 +310,34 @@ class LSHSearch
   }
 
  private:
+  //! The number of points that are hashed at once when the hash tables are
+  //! built.
+  static const size_t blockSize = 4096;
+
+  /**
+   * Compute the second hash code of the given points in every table, in
+   * parallel.  Element (j, i) of the result is the bucket of point j in table
+   * i.
+   *
+   * @param points Points to hash.
+   * @param secondHashCodes Matrix to store the second hash codes in.
+   */
+  void ComputeSecondHashCodes(const arma::mat& points,
+                              arma::Mat<size_t>& secondHashCodes) const;
+
+  /**
+   * Add points to the buckets of the second hash table, after the points that
+   * are already there, with a parallel counting sort.  Points that don't fit
+   * in a full bucket are dropped.
+   *
+   * @param secondHashCodes Second hash codes of the points, as given by
+   *     ComputeSecondHashCodes().
+   * @param firstIndex Index of the first of the points in the reference set.
+   * @return The number of points that were dropped.
+   */
+  size_t AddToBuckets(const arma::Mat<size_t>& secondHashCodes,
+                      const size_t firstIndex);
+
   /**
    * This function takes a query and hashes it into each of the hash tables to
    * get keys for the query and then the key is hashed to a bucket of the second
@@ -443,17 +484,13 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
-
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The start of each bucket of the second hash table in bucketContents,
+  //! followed by the total number of elements.  Length secondHashSize + 1.
+  arma::Col<size_t> bucketOffsets;
 
-  //! For a particular hash value, points to the row in secondHashTable
-  //! corresponding to this value. Length secondHashSize.
-  arma::Col<size_t> bucketRowInHashTable;
+  //! The points in the buckets of the second hash table, stored contiguously
+  //! bucket by bucket; each bucket has (<= bucketSize) elements.
+  arma::Col<size_t> bucketContents;
 
   //! The number of distance evaluations.
   size_t distanceEvaluations;
@@ -480,7 +517,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
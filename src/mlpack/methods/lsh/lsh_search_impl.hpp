@@ -15,6 +15,10 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/random.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace neighbor {
 
@@ -72,7 +76,7 @@ LSHSearch<SortPolicy>::LSHSearch() :
     numTables(0),
     hashWidth(0),
     secondHashSize(99901),
-    bucketSize(500),
+    bucketSize(0),
     distanceEvaluations(0)
 {
 }
@@ -90,9 +94,8 @@ LSHSearch<SortPolicy>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
-    bucketRowInHashTable(other.bucketRowInHashTable),
+    bucketOffsets(other.bucketOffsets),
+    bucketContents(other.bucketContents),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Nothing to do.
@@ -111,9 +114,8 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
-    bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketContents(std::move(other.bucketContents)),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Reset other model to defaults.
@@ -123,7 +125,7 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
   other.numTables = 0;
   other.hashWidth = 0;
   other.secondHashSize = 99901;
-  other.bucketSize = 500;
+  other.bucketSize = 0;
   other.distanceEvaluations = 0;
 }
 
@@ -144,9 +146,8 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(const LSHSearch& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
-  bucketRowInHashTable = other.bucketRowInHashTable;
+  bucketOffsets = other.bucketOffsets;
+  bucketContents = other.bucketContents;
   distanceEvaluations = other.distanceEvaluations;
 
   return *this;
@@ -169,9 +170,8 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
-  bucketRowInHashTable = std::move(other.bucketRowInHashTable);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketContents = std::move(other.bucketContents);
   distanceEvaluations = other.distanceEvaluations;
 
   // Reset other model to defaults.
@@ -181,7 +181,7 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   other.numTables = 0;
   other.hashWidth = 0;
   other.secondHashSize = 99901;
-  other.bucketSize = 500;
+  other.bucketSize = 0;
   other.distanceEvaluations = 0;
 
   return *this;
@@ -205,11 +205,15 @@ void LSHSearch<SortPolicy>::Train(const arma::mat& referenceSet,
                                   const size_t bucketSize,
                                   const arma::cube &projection)
 {
-  // Set new reference set.
-  if (this->referenceSet && ownsSet)
-    delete this->referenceSet;
-  this->referenceSet = &referenceSet;
-  this->ownsSet = false;
+  // Set new reference set.  (If we are retrained on the reference set we own,
+  // for instance through Projections(), we keep it.)
+  if (&referenceSet != this->referenceSet)
+  {
+    if (this->referenceSet && ownsSet)
+      delete this->referenceSet;
+    this->referenceSet = &referenceSet;
+    this->ownsSet = false;
+  }
 
   // Set new parameters.
   this->numProj = numProj;
@@ -247,13 +251,6 @@ void LSHSearch<SortPolicy>::Train(const arma::mat& referenceSet,
   secondHashWeights = arma::floor(arma::randu(numProj) *
                                   (double) secondHashSize);
 
-  // Instead of putting the points in the row corresponding to the bucket, we
-  // chose the next empty row and keep track of the row in which the bucket
-  // lies. This allows us to stack together and slice out the empty buckets at
-  // the end of the hashing.
-  bucketRowInHashTable.set_size(secondHashSize);
-  bucketRowInHashTable.fill(secondHashSize);
-
   // Step II: The offsets for all projections in all tables.
   // Since the 'offsets' are in [0, hashWidth], we obtain the 'offsets'
   // as randu(numProj, numTables) * hashWidth.
@@ -281,101 +278,248 @@ void LSHSearch<SortPolicy>::Train(const arma::mat& referenceSet,
         "tables provided must be equal to numProj");
   }
 
-  // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, referenceSet.n_cols);
+  // Step IV: Compute the second hash code of every point in every table.
+  arma::Mat<size_t> secondHashCodes;
+  ComputeSecondHashCodes(referenceSet, secondHashCodes);
+
+  // Step V: Put the points into the buckets of the (initially empty) second
+  // hash table.
+  bucketOffsets.zeros(secondHashSize + 1);
+  bucketContents.reset();
+  const size_t dropped = AddToBuckets(secondHashCodes, 0);
+  if (dropped > 0)
+  {
+    Log::Warn << "LSHSearch::Train(): " << dropped << " points did not fit in "
+        << "their bucket (bucket size " << bucketSize << ") and were dropped; "
+        << "use a bucket size of 0 for no limit." << std::endl;
+  }
+}
+
+// Insert new points into the model.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Insert(const arma::mat& newPoints)
+{
+  if (projections.n_slices == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points can be inserted!");
+  }
+
+  if (newPoints.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): dimensionality of new points ("
+        << newPoints.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet->n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Hash the new points with the existing projections and offsets.
+  arma::Mat<size_t> secondHashCodes;
+  ComputeSecondHashCodes(newPoints, secondHashCodes);
+
+  // The new points are appended to the reference set; we own the result.
+  const size_t firstIndex = referenceSet->n_cols;
+  arma::mat* newReferenceSet = new arma::mat(referenceSet->n_rows,
+      firstIndex + newPoints.n_cols);
+  if (firstIndex > 0)
+    newReferenceSet->cols(0, firstIndex - 1) = *referenceSet;
+  if (newPoints.n_cols > 0)
+    newReferenceSet->cols(firstIndex, newReferenceSet->n_cols - 1) = newPoints;
+
+  if (ownsSet)
+    delete referenceSet;
+  referenceSet = newReferenceSet;
+  ownsSet = true;
+
+  const size_t dropped = AddToBuckets(secondHashCodes, firstIndex);
+  if (dropped > 0)
+  {
+    Log::Warn << "LSHSearch::Insert(): " << dropped << " points did not fit "
+        << "in their bucket (bucket size " << bucketSize << ") and were "
+        << "dropped; use a bucket size of 0 for no limit." << std::endl;
+  }
+}
 
-  for (size_t i = 0; i < numTables; i++)
+// Compute the second hash codes of the given points.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::ComputeSecondHashCodes(
+    const arma::mat& points,
+    arma::Mat<size_t>& secondHashCodes) const
+{
+  // We will store the second hash code of point j in table i in element
+  // (j, i), so that the codes are in memory in the order the points are
+  // inserted into the buckets (table by table).
+  const size_t numPoints = points.n_cols;
+  secondHashCodes.set_size(numPoints, numTables);
+
+  // The points are hashed in blocks, in parallel, so that the projections of
+  // only a block of points have to be held at once.
+  const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(static)
+  for (intmax_t b = 0; b < (intmax_t) numBlocks; ++b)
+  #else
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  #endif
   {
-    // Step IV: create the 'numProj'-dimensional key for each point in each
-    // table.
-
-    // The following code performs the task of hashing each point to a
-    // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
-    //
-    // For a single table, let the 'numProj' projections be denoted by 'proj_i'
-    // and the corresponding offset be 'offset_i'.  Then the key of a single
-    // point is obtained as:
-    // key = { floor( (<proj_i, point> + offset_i) / 'hashWidth' ) forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (referenceSet);
-    hashMat += offsetMat;
-    hashMat /= hashWidth;
-
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
-    // Now we hash every key, point ID to its corresponding bucket.  We must
-    // also normalize the hashes to the range [0, secondHashSize).
-    arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
-    for (size_t j = 0; j < unmodVector.n_elem; ++j)
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, numPoints) - 1;
+
+    for (size_t i = 0; i < numTables; i++)
     {
-      double shs = (double) secondHashSize; // Convenience cast.
-      if (unmodVector[j] >= 0.0)
-      {
-        const size_t key = size_t(fmod(unmodVector[j], shs));
-        secondHashVectors(i, j) = key;
-      }
-      else
+      // Create the 'numProj'-dimensional key for each point in each table.
+
+      // The following code performs the task of hashing each point to a
+      // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
+      // 'blockSize') key matrix.
+      //
+      // For a single table, let the 'numProj' projections be denoted by
+      // 'proj_i' and the corresponding offset be 'offset_i'.  Then the key of
+      // a single point is obtained as:
+      // key = { floor( (<proj_i, point> + offset_i) / 'hashWidth' ) forall i }
+      arma::mat hashMat = projections.slice(i).t() * points.cols(begin, end);
+      hashMat.each_col() += offsets.col(i);
+      hashMat /= hashWidth;
+
+      // Hash every key to its corresponding bucket.  We must also normalize
+      // the hashes to the range [0, secondHashSize).
+      arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
+      for (size_t j = 0; j < unmodVector.n_elem; ++j)
       {
-        const double mod = fmod(-unmodVector[j], shs);
-        const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
-        secondHashVectors(i, j) = key;
+        double shs = (double) secondHashSize; // Convenience cast.
+        if (unmodVector[j] >= 0.0)
+        {
+          const size_t key = size_t(fmod(unmodVector[j], shs));
+          secondHashCodes(begin + j, i) = key;
+        }
+        else
+        {
+          const double mod = fmod(-unmodVector[j], shs);
+          const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
+          secondHashCodes(begin + j, i) = key;
+        }
       }
     }
   }
+}
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+// Add points to the buckets of the second hash table.
+template<typename SortPolicy>
+size_t LSHSearch<SortPolicy>::AddToBuckets(
+    const arma::Mat<size_t>& secondHashCodes,
+    const size_t firstIndex)
+{
+  // The points are placed with a counting sort over the hash codes.  The codes
+  // are split into one contiguous chunk per thread; each thread first counts
+  // the codes of its chunk, and after the counts are summed, places the points
+  // of its chunk.  Since the chunks are in order, the new points of each bucket
+  // are in the same order as if they were inserted one at a time (table by
+  // table, and by index within a table), after the points already there.
+  const size_t numPoints = secondHashCodes.n_rows;
+  const size_t numCodes = secondHashCodes.n_elem;
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+  numChunks = std::max(std::min((size_t) omp_get_max_threads(),
+      numCodes / blockSize), (size_t) 1);
+  #endif
+  const size_t chunkSize = (numCodes + numChunks - 1) / numChunks;
+
+  arma::Mat<size_t> chunkCounts(secondHashSize, numChunks, arma::fill::zeros);
+
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(static)
+  for (intmax_t c = 0; c < (intmax_t) numChunks; ++c)
+  #else
+  #pragma omp parallel for schedule(static)
+  for (size_t c = 0; c < numChunks; ++c)
+  #endif
+  {
+    const size_t end = std::min((c + 1) * chunkSize, numCodes);
+    for (size_t e = c * chunkSize; e < end; ++e)
+      ++chunkCounts(secondHashCodes[e], c);
+  }
 
-  // Enforce the maximum bucket size.
+  // Compute the start of each bucket, enforcing the maximum bucket size, and
+  // turn the counts of each chunk into the position (within the bucket) of the
+  // first point of that chunk.
   const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
+  arma::Col<size_t> newBucketOffsets(secondHashSize + 1);
+  newBucketOffsets[0] = 0;
+  size_t numBuckets = 0;
+  size_t maxBucketSize = 0;
+  for (size_t h = 0; h < secondHashSize; ++h)
+  {
+    const size_t oldSize = bucketOffsets[h + 1] - bucketOffsets[h];
+    size_t count = oldSize;
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      const size_t chunkCount = chunkCounts(h, c);
+      chunkCounts(h, c) = count;
+      count += chunkCount;
+    }
+
+    const size_t size = std::max(std::min(count, effectiveBucketSize),
+        oldSize);
+    newBucketOffsets[h + 1] = newBucketOffsets[h] + size;
+    if (size > 0)
+      ++numBuckets;
+    maxBucketSize = std::max(maxBucketSize, size);
+  }
+
+  arma::Col<size_t> newBucketContents(newBucketOffsets[secondHashSize]);
 
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
+  // Copy the points that are already in the buckets.
+  if (bucketContents.n_elem > 0)
+  {
+    #ifdef _WIN32
+    #pragma omp parallel for schedule(static)
+    for (intmax_t h = 0; h < (intmax_t) secondHashSize; ++h)
+    #else
+    #pragma omp parallel for schedule(static)
+    for (size_t h = 0; h < secondHashSize; ++h)
+    #endif
+    {
+      std::copy(bucketContents.begin() + bucketOffsets[h],
+          bucketContents.begin() + bucketOffsets[h + 1],
+          newBucketContents.begin() + newBucketOffsets[h]);
+    }
+  }
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(static)
+  for (intmax_t c = 0; c < (intmax_t) numChunks; ++c)
+  #else
+  #pragma omp parallel for schedule(static)
+  for (size_t c = 0; c < numChunks; ++c)
+  #endif
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    const size_t end = std::min((c + 1) * chunkSize, numCodes);
+    for (size_t e = c * chunkSize; e < end; ++e)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
+      const size_t hashInd = secondHashCodes[e];
+      const size_t position = chunkCounts(hashInd, c)++;
+      // Points that don't fit in a full bucket are not stored.
+      if (newBucketOffsets[hashInd] + position < newBucketOffsets[hashInd + 1])
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        newBucketContents[newBucketOffsets[hashInd] + position] = firstIndex +
+            e % numPoints;
       }
+    }
+  }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
+  const size_t dropped = numCodes + bucketContents.n_elem -
+      newBucketContents.n_elem;
+  bucketOffsets = std::move(newBucketOffsets);
+  bucketContents = std::move(newBucketContents);
 
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+  Log::Info << "Final hash table size: " << numBuckets << " buckets, with a "
+            << "maximum length of " << maxBucketSize << ", totaling "
+            << bucketContents.n_elem << " elements." << std::endl;
 
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  return dropped;
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -765,7 +909,7 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
   hashMat.set_size(T + 1, numTablesToSearch);
 
   // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
+  // the second hash table using the secondHashWeights.
   hashMat.row(0) = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
       ::from(secondHashWeights.t() * allProjInTables);
   // Mod to compute 2nd-level codes.
@@ -784,8 +928,8 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
                                 T,
                                 additionalProbingBins);
 
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
+      // Map each probing bin to a bin in the second hash table (just like we
+      // did for the primary hash table).
       hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
         arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
         from( secondHashWeights.t() * additionalProbingBins );
@@ -802,9 +946,8 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     for (size_t p = 0; p < T + 1; ++p)
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      // Count the bucket contents.
+      maxNumPoints += bucketOffsets[hashInd + 1] - bucketOffsets[hashInd];
     }
   }
 
@@ -832,13 +975,12 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
       for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
       {
         // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+        const size_t hashInd = hashMat(p, i);
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+        // Pick the indices in the bucket corresponding to hashInd.
+        for (size_t j = bucketOffsets[hashInd]; j < bucketOffsets[hashInd + 1];
+            ++j)
+          refPointsConsidered[bucketContents[j]]++;
       }
     }
 
@@ -862,12 +1004,11 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
       for (size_t p = 0; p < T + 1; ++p)
       {
         const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize)
-         // Store all secondHashTable points in the candidates set.
-         for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-           refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
+        // Store all points of the bucket in the candidates set.
+        for (size_t j = bucketOffsets[hashInd]; j < bucketOffsets[hashInd + 1];
+            ++j)
+          refPointsConsideredSmall(start++) = bucketContents[j];
       }
     }
 
@@ -953,7 +1094,7 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
   {
     // Go through every query point.
     // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // second hash table to obtain the neighbor candidates.
     arma::uvec refIndices;
     ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
         Teffective);
@@ -1030,7 +1171,7 @@ Search(const size_t k,
   {
     // Go through every query point.
     // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // second hash table to obtain the neighbor candidates.
     arma::uvec refIndices;
     ReturnIndicesFromTable(referenceSet->col(i), refIndices, numTablesToSearch,
         Teffective);
@@ -1125,81 +1266,99 @@ void LSHSearch<SortPolicy>::Serialize(Archive& ar,
   ar & CreateNVP(secondHashSize, "secondHashSize");
   ar & CreateNVP(secondHashWeights, "secondHashWeights");
   ar & CreateNVP(bucketSize, "bucketSize");
-  // needs specific handling for new version
 
-  // Backward compatibility: in older versions of LSHSearch, the secondHashTable
-  // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
-  // prune it down to size.
-  if (version == 0)
+  // Backward compatibility: older versions of LSHSearch stored every non-empty
+  // bucket in its own vector, and held the row of each bucket and the number
+  // of points in each row separately.  These are loaded and then packed into
+  // bucketOffsets and bucketContents.
+  if (version < 2)
   {
-    arma::Mat<size_t> tmpSecondHashTable;
-    ar & CreateNVP(tmpSecondHashTable, "secondHashTable");
-
-    // The old secondHashTable was stored in row-major format, so we transpose
-    // it.
-    tmpSecondHashTable = tmpSecondHashTable.t();
-
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
-    for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
+    arma::Col<size_t> bucketRowInHashTable;
+
+    // In the oldest versions, the secondHashTable was stored as an
+    // arma::Mat<size_t>.  So we need to properly load that, then prune it down
+    // to size.
+    if (version == 0)
     {
-      // Find length of each column.  We know we are at the end of the list when
-      // the value referenceSet->n_cols is seen.
+      arma::Mat<size_t> tmpSecondHashTable;
+      ar & CreateNVP(tmpSecondHashTable, "secondHashTable");
 
-      size_t len = 0;
-      for ( ; len < tmpSecondHashTable.n_rows; ++len)
-        if (tmpSecondHashTable(len, i) == referenceSet->n_cols)
-          break;
+      // The old secondHashTable was stored in row-major format, so we
+      // transpose it.
+      tmpSecondHashTable = tmpSecondHashTable.t();
 
-      // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
-      for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
-    }
-  }
-  else
-  {
-    size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
-    ar & CreateNVP(tables, "numSecondHashTables");
+      secondHashTable.resize(tmpSecondHashTable.n_cols);
+      for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      {
+        // Find length of each column.  We know we are at the end of the list
+        // when the value referenceSet->n_cols is seen.
+
+        size_t len = 0;
+        for ( ; len < tmpSecondHashTable.n_rows; ++len)
+          if (tmpSecondHashTable(len, i) == referenceSet->n_cols)
+            break;
+
+        // Set the size of the new column correctly.
+        secondHashTable[i].set_size(len);
+        for (size_t j = 0; j < len; ++j)
+          secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      }
 
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
+      // The oldest versions also held bucketContentSize for all possible
+      // buckets (of size secondHashSize).  We can't shrink it until we have
+      // bucketRowInHashTable, so we also have to load that.
+      arma::Col<size_t> tmpBucketContentSize;
+      ar & CreateNVP(tmpBucketContentSize, "bucketContentSize");
+      ar & CreateNVP(bucketRowInHashTable, "bucketRowInHashTable");
+
+      // Compress into a smaller vector by just dropping all of the zeros.
+      bucketContentSize.zeros(secondHashTable.size());
+      for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
+        if (tmpBucketContentSize[i] > 0)
+          bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    }
+    else
     {
-      secondHashTable.clear();
+      size_t tables;
+      ar & CreateNVP(tables, "numSecondHashTables");
+
       secondHashTable.resize(tables);
+      for (size_t i = 0; i < secondHashTable.size(); ++i)
+      {
+        std::ostringstream oss;
+        oss << "secondHashTable" << i;
+        ar & CreateNVP(secondHashTable[i], oss.str());
+      }
+
+      ar & CreateNVP(bucketContentSize, "bucketContentSize");
+      ar & CreateNVP(bucketRowInHashTable, "bucketRowInHashTable");
     }
 
-    for (size_t i = 0; i < secondHashTable.size(); ++i)
+    // Empty buckets have a row that is out of range.
+    bucketOffsets.zeros(secondHashSize + 1);
+    for (size_t h = 0; h < bucketRowInHashTable.n_elem; ++h)
+      if (bucketRowInHashTable[h] < secondHashTable.size())
+        bucketOffsets[h + 1] = bucketContentSize[bucketRowInHashTable[h]];
+    bucketOffsets = arma::cumsum(bucketOffsets);
+
+    bucketContents.set_size(bucketOffsets[secondHashSize]);
+    for (size_t h = 0; h < bucketRowInHashTable.n_elem; ++h)
     {
-      std::ostringstream oss;
-      oss << "secondHashTable" << i;
-      ar & CreateNVP(secondHashTable[i], oss.str());
+      if (bucketRowInHashTable[h] < secondHashTable.size())
+      {
+        const arma::Col<size_t>& bucket =
+            secondHashTable[bucketRowInHashTable[h]];
+        for (size_t j = bucketOffsets[h]; j < bucketOffsets[h + 1]; ++j)
+          bucketContents[j] = bucket[j - bucketOffsets[h]];
+      }
     }
   }
-
-  // Backward compatibility: old versions of LSHSearch held bucketContentSize
-  // for all possible buckets (of size secondHashSize), but now we hold a
-  // compressed representation.
-  if (version == 0)
-  {
-    // The vector was stored in the old uncompressed form.  So we need to shrink
-    // it.  But we can't do that until we have bucketRowInHashTable, so we also
-    // have to load that.
-    arma::Col<size_t> tmpBucketContentSize;
-    ar & CreateNVP(tmpBucketContentSize, "bucketContentSize");
-    ar & CreateNVP(bucketRowInHashTable, "bucketRowInHashTable");
-
-    // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
-    for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
-      if (tmpBucketContentSize[i] > 0)
-        bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
-  }
   else
   {
-    ar & CreateNVP(bucketContentSize, "bucketContentSize");
-    ar & CreateNVP(bucketRowInHashTable, "bucketRowInHashTable");
+    ar & CreateNVP(bucketOffsets, "bucketOffsets");
+    ar & CreateNVP(bucketContents, "bucketContents");
   }
 
   ar & CreateNVP(distanceEvaluations, "distanceEvaluations");
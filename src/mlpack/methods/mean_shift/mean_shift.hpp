@@ -76,6 +76,12 @@ class MeanShift
    * Perform mean shift clustering on the data, returning a list of cluster
    * assignments and centroids.
    *
+   * The tree on the data is built only once.  In each iteration, the
+   * neighbors of all centroids that are still moving are found with one
+   * batched range search, and the centroids are then shifted in parallel (if
+   * OpenMP is available).  Centroids that have converged are not searched for
+   * again.
+   *
    * @tparam MatType Type of matrix.
    * @param data Dataset to cluster.
    * @param assignments Vector to store cluster assignments in.
@@ -122,10 +128,13 @@ class MeanShift
 
   /**
    * Use kernel to calculate new centroid given dataset and valid neighbors.
+   * The neighbors of the centroid are neighbors[begin] to neighbors[end - 1].
    *
    * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
+   * @param neighbors Valid neighbors of all centroids
+   * @param distances Distances to neighbors of all centroids
+   * @param begin Index of the first neighbor of this centroid
+   * @param end One past the index of the last neighbor of this centroid
    # @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
@@ -133,14 +142,19 @@ class MeanShift
   CalculateCentroid(const MatType& data,
                     const std::vector<size_t>& neighbors,
                     const std::vector<double>& distances,
+                    const size_t begin,
+                    const size_t end,
                     arma::colvec& centroid);
 
   /**
    * Use mean to calculate new centroid given dataset and valid neighbors.
+   * The neighbors of the centroid are neighbors[begin] to neighbors[end - 1].
    *
    * @param data The whole dataset
-   * @param neighbors Valid neighbors
-   * @param distances Distances to neighbors
+   * @param neighbors Valid neighbors of all centroids
+   * @param distances Distances to neighbors of all centroids
+   * @param begin Index of the first neighbor of this centroid
+   * @param end One past the index of the last neighbor of this centroid
    # @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
@@ -148,6 +162,8 @@ class MeanShift
   CalculateCentroid(const MatType& data,
                     const std::vector<size_t>& neighbors,
                     const std::vector<double>&, /*unused*/
+                    const size_t begin,
+                    const size_t end,
                     arma::colvec& centroid);
 
   /**
@@ -137,10 +137,12 @@ MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
                   const std::vector<size_t>& neighbors,
                   const std::vector<double>& distances,
+                  const size_t begin,
+                  const size_t end,
                   arma::colvec& centroid)
 {
   double sumWeight = 0;
-  for (size_t i = 0; i < neighbors.size(); ++i)
+  for (size_t i = begin; i < end; ++i)
   {
     if (distances[i] > 0)
     {
@@ -167,12 +169,14 @@ MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
                   const std::vector<size_t>& neighbors,
                   const std::vector<double>&, /*unused*/
+                  const size_t begin,
+                  const size_t end,
                   arma::colvec& centroid)
 {
-  for (size_t i = 0; i < neighbors.size(); ++i)
+  for (size_t i = begin; i < end; ++i)
     centroid += data.unsafe_col(neighbors[i]);
 
-  centroid /= neighbors.size();
+  centroid /= (end - begin);
   return true;
 }
 
@@ -201,63 +205,105 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
     pSeeds = &seeds;
   }
 
-  // Holds all centroids before removing duplicate ones.
-  arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Holds all centroids before removing duplicate ones.  The initial centroid
+  // of each seed is the seed itself.
+  arma::mat allCentroids(*pSeeds);
 
   assignments.set_size(data.n_cols);
 
+  // The tree is only built once.  In each iteration, all centroids that are
+  // still moving are searched for at once, and the results are stored in
+  // compressed sparse row format.
   range::RangeSearch<> rangeSearcher(data);
   math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  std::vector<size_t> offsets;
+  std::vector<size_t> neighbors;
+  std::vector<double> distances;
 
-  // For each seed, perform mean shift algorithm.
+  // The seeds whose centroids are still moving, and whether the centroid of
+  // each seed has converged.
+  std::vector<size_t> activeSeeds(pSeeds->n_cols);
   for (size_t i = 0; i < pSeeds->n_cols; ++i)
+    activeSeeds[i] = i;
+  std::vector<char> converged(pSeeds->n_cols, 0);
+
+  for (size_t completedIterations = 0; (completedIterations < maxIterations) &&
+       !activeSeeds.empty(); completedIterations++)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations;
-         completedIterations++)
+    arma::mat activeCentroids(allCentroids.n_rows, activeSeeds.size());
+    for (size_t j = 0; j < activeSeeds.size(); ++j)
+      activeCentroids.col(j) = allCentroids.col(activeSeeds[j]);
+
+    rangeSearcher.Search(activeCentroids, validRadius, offsets, neighbors,
+        distances);
+
+    // Shift each centroid.  Each seed is handled by one thread, so the seeds
+    // can be shifted in parallel.  On the Visual Studio compiler, we have to
+    // use intmax_t because size_t is not yet supported by their OpenMP
+    // implementation.
+    std::vector<char> moving(activeSeeds.size(), 0);
+    #ifdef _WIN32
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (intmax_t j = 0; j < (intmax_t) activeSeeds.size(); ++j)
+    #else
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (size_t j = 0; j < activeSeeds.size(); ++j)
+    #endif
     {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() <= 1)
-        break;
+      const size_t i = activeSeeds[j];
+      if (offsets[j + 1] - offsets[j] <= 1)
+        continue;
 
       // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
+      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+      if (!CalculateCentroid(data, neighbors, distances, offsets[j],
+          offsets[j + 1], newCentroid))
         newCentroid = allCentroids.unsafe_col(i);
 
       // If the mean shift vector is small enough, it has converged.
       if (metric::EuclideanDistance::Evaluate(newCentroid,
           allCentroids.unsafe_col(i)) < 1e-3 * radius)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
-        {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
-        }
-
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
+        converged[i] = 1;
       }
+      else
+      {
+        // Update the centroid.
+        allCentroids.col(i) = newCentroid;
+        moving[j] = 1;
+      }
+    }
 
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
+    // Drop the seeds that have converged or stopped.
+    size_t numActive = 0;
+    for (size_t j = 0; j < activeSeeds.size(); ++j)
+      if (moving[j])
+        activeSeeds[numActive++] = activeSeeds[j];
+    activeSeeds.resize(numActive);
+  }
+
+  // Keep the converged centroids that are not duplicates of earlier ones, in
+  // the order of the seeds.
+  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  {
+    if (!converged[i])
+      continue;
+
+    // Determine if the new centroid is duplicate with old ones.
+    bool isDuplicated = false;
+    for (size_t k = 0; k < centroids.n_cols; ++k)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          allCentroids.unsafe_col(i), centroids.unsafe_col(k));
+      if (distance < radius)
+      {
+        isDuplicated = true;
+        break;
+      }
     }
+
+    if (!isDuplicated)
+      centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
   }
 
   // Assign centroids to each point.
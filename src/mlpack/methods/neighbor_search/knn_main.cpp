@@ -22,6 +22,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "ns_server.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -51,7 +52,18 @@ PROGRAM_INFO("k-Nearest-Neighbors",
     "neighbors output file corresponds to the index of the point in the "
     "reference set which is the i'th nearest neighbor from the point in the "
     "query set with index j.  Row i and column j in the distances output file "
-    "corresponds to the distance between those two points.");
+    "corresponds to the distance between those two points."
+    "\n\n"
+    "If --server is specified, the program does not exit after building or "
+    "loading the model: it keeps reading batches of query points from standard "
+    "input and writes the neighbors of each batch to standard output, so the "
+    "reference tree is only built once.  Each input line holds one query point "
+    "(comma- or space-separated), and each batch ends with an empty line.  For "
+    "each query point, a line with the k neighbor indices followed by the k "
+    "distances is written; the results of a batch are followed by an empty "
+    "line.  A line holding 'quit' stops the server.  If --server_socket is "
+    "also specified, queries are read from clients of a Unix domain socket at "
+    "the given path instead.");
 
 // Define our input parameters that this program will take.
 PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
@@ -103,6 +115,13 @@ PARAM_FLAG("single_mode", "(Deprecated) If true, single-tree search is used "
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
 
+// Server mode: answer batches of queries without rebuilding the model.
+PARAM_FLAG("server", "If true, read batches of query points from standard "
+    "input (or --server_socket) and write their neighbors to standard output "
+    "until the input ends.", "");
+PARAM_STRING_IN("server_socket", "Path of a Unix domain socket to read query "
+    "batches from and write results to in --server mode.", "", "");
+
 int main(int argc, char *argv[])
 {
   // Give CLI the command line parameters the user passed in.
@@ -151,7 +170,7 @@ int main(int argc, char *argv[])
         << "results from this program will be saved!" << endl;
 
   // If the user specifies k but no output files, they should be warned.
-  if (CLI::HasParam("k") &&
+  if (CLI::HasParam("k") && !CLI::HasParam("server") &&
       !(CLI::HasParam("neighbors") || CLI::HasParam("distances")))
     Log::Warn << "Neither --neighbors_file nor --distances_file is specified, "
         << "so the nearest neighbor search results will not be saved!" << endl;
@@ -172,6 +191,25 @@ int main(int argc, char *argv[])
     Log::Warn << "--true_distances_file (-D) ignored because no search is being"
         << " performed (--k is not specified)." << endl;
 
+  if (CLI::HasParam("server"))
+  {
+    if (!CLI::HasParam("k"))
+      Log::Fatal << "--server requires the number of neighbors (--k) to be "
+          << "specified!" << endl;
+    if (CLI::HasParam("query"))
+      Log::Fatal << "--query_file (-q) cannot be specified with --server; "
+          << "query points are read from the server input." << endl;
+    if (CLI::HasParam("neighbors") || CLI::HasParam("distances") ||
+        CLI::HasParam("true_neighbors") || CLI::HasParam("true_distances"))
+      Log::Warn << "--neighbors_file, --distances_file, --true_neighbors_file "
+          << "and --true_distances_file are ignored with --server." << endl;
+  }
+  else if (CLI::HasParam("server_socket"))
+  {
+    Log::Warn << "--server_socket is ignored because --server is not "
+        << "specified." << endl;
+  }
+
   // Sanity check on leaf size.
   const int lsInt = CLI::GetParam<int>("leaf_size");
   if (lsInt < 1)
@@ -325,7 +363,29 @@ int main(int argc, char *argv[])
   }
 
   // Perform search, if desired.
-  if (CLI::HasParam("k"))
+  if (CLI::HasParam("server"))
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    if (k > knn.Dataset().n_cols)
+    {
+      Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less ";
+      Log::Fatal << "than or equal to the number of reference points (";
+      Log::Fatal << knn.Dataset().n_cols << ")." << endl;
+    }
+
+    // The model is kept for the whole session; only query trees are built for
+    // each batch.
+    if (CLI::HasParam("server_socket"))
+    {
+      ServeQueries(knn, k, CLI::GetParam<string>("server_socket"));
+    }
+    else
+    {
+      const size_t batches = ServeQueries(knn, k, std::cin, std::cout);
+      Log::Info << "Answered " << batches << " batches of queries." << endl;
+    }
+  }
+  else if (CLI::HasParam("k"))
   {
     const size_t k = (size_t) CLI::GetParam<int>("k");
 
@@ -54,6 +54,18 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct a copy of the given rules object that shares the lists of
+   * candidate neighbors (and therefore the results) with it, but has its own
+   * traversal information, base case cache and counters.  This is used by
+   * parallel traversers, where each task works on a disjoint set of query
+   * points with its own rules object.  The copy must not outlive the object it
+   * was copied from.
+   *
+   * @param other Rules object to share the candidate neighbors with.
+   */
+  NeighborSearchRules(const NeighborSearchRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -179,8 +191,12 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Storage for the candidate neighbors, if they are owned by this object.
+  std::vector<CandidateList> candidateStorage;
+
+  //! Set of candidate neighbors for each point (this may be shared with the
+  //! rules object this object was copied from).
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
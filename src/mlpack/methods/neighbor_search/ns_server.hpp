@@ -0,0 +1,81 @@
+/**
+ * @file ns_server.hpp
+ * @author Ryan Curtin
+ *
+ * Functions to answer batches of neighbor search queries with a model that is
+ * built (or loaded) only once.  This is used by the --server mode of the
+ * mlpack_knn program.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_SERVER_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_SERVER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "ns_model.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * Read batches of query points from the given input stream, search for the k
+ * neighbors of each query point in the given model, and write the results to
+ * the given output stream.  The model (and its reference tree) is reused for
+ * every batch, so only the query tree (if any) is built for each batch.
+ *
+ * Each line of the input holds one query point, as numbers separated by commas
+ * or whitespace.  A batch ends with an empty line or at the end of the input.
+ * The input ends at the end of the stream, or when a line holding only "quit"
+ * is read.
+ *
+ * For each batch, one line is written per query point, in the same order as
+ * the query points: first the indices of the k neighbors and then the k
+ * distances to those neighbors, all separated by commas.  The results of each
+ * batch are followed by an empty line, and the output is flushed after every
+ * batch.  If a batch can't be parsed (for instance, because a point has the
+ * wrong dimensionality), a single line starting with "error: " is written
+ * instead of the results, followed by an empty line, and serving continues.
+ *
+ * @param model Model to search with.
+ * @param k Number of neighbors to search for.
+ * @param input Stream to read query batches from.
+ * @param output Stream to write results to.
+ * @param quit Set to true if the input ended with "quit" (may be NULL).
+ * @return Number of batches that were answered.
+ */
+template<typename SortPolicy>
+size_t ServeQueries(NSModel<SortPolicy>& model,
+                    const size_t k,
+                    std::istream& input,
+                    std::ostream& output,
+                    bool* quit = NULL);
+
+/**
+ * Listen on the Unix domain socket at the given path, and answer the queries of
+ * each client that connects, one client at a time, using the protocol of
+ * ServeQueries().  When a client closes the connection, the next client is
+ * accepted; when a client sends "quit", the server stops and the socket file is
+ * removed.  Unix domain sockets are not available on Windows, where false is
+ * always returned.
+ *
+ * @param model Model to search with.
+ * @param k Number of neighbors to search for.
+ * @param socketPath Path of the socket to create.  It must not exist yet.
+ * @return Whether or not the server stopped because a client sent "quit"
+ *     (false if the socket couldn't be created or a connection failed).
+ */
+template<typename SortPolicy>
+bool ServeQueries(NSModel<SortPolicy>& model,
+                  const size_t k,
+                  const std::string& socketPath);
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ns_server_impl.hpp"
+
+#endif
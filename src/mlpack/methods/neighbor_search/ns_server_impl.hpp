@@ -0,0 +1,308 @@
+/**
+ * @file ns_server_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the functions that answer batches of neighbor search
+ * queries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_SERVER_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_SERVER_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "ns_server.hpp"
+
+#include <limits>
+#include <sstream>
+
+#ifndef _WIN32
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+  #include <cerrno>
+  #include <cstring>
+#endif
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy>
+size_t ServeQueries(NSModel<SortPolicy>& model,
+                    const size_t k,
+                    std::istream& input,
+                    std::ostream& output,
+                    bool* quit)
+{
+  if (quit)
+    *quit = false;
+
+  const size_t dimensionality = model.Dataset().n_rows;
+  size_t batches = 0;
+
+  // Distances are written with enough digits to be read back exactly.
+  output.precision(std::numeric_limits<double>::max_digits10);
+
+  std::string line;
+  bool done = false;
+  while (!done)
+  {
+    // Collect the points of the next batch.
+    std::vector<double> values;
+    size_t points = 0;
+    std::string error;
+    while (true)
+    {
+      if (!std::getline(input, line))
+      {
+        done = true;
+        break;
+      }
+
+      // Commas are treated as whitespace; a trailing carriage return is too.
+      for (size_t i = 0; i < line.size(); ++i)
+        if (line[i] == ',' || line[i] == '\r')
+          line[i] = ' ';
+
+      std::istringstream stream(line);
+      std::string token;
+      if (!(stream >> token))
+      {
+        // An empty line ends the batch, unless no points were read yet.
+        if (points > 0 || !error.empty())
+          break;
+        continue;
+      }
+
+      if (token == "quit" && !(stream >> token))
+      {
+        if (quit)
+          *quit = true;
+        done = true;
+        break;
+      }
+
+      // Once an error is found, the rest of the batch is skipped.
+      if (!error.empty())
+        continue;
+
+      stream.clear();
+      stream.str(line);
+      size_t count = 0;
+      double value;
+      while (stream >> value)
+      {
+        values.push_back(value);
+        ++count;
+      }
+
+      if (!stream.eof())
+      {
+        std::ostringstream oss;
+        oss << "cannot parse query point " << points << " of the batch";
+        error = oss.str();
+      }
+      else if (count != dimensionality)
+      {
+        std::ostringstream oss;
+        oss << "query point " << points << " of the batch has " << count
+            << " dimensions, but the reference set has " << dimensionality;
+        error = oss.str();
+      }
+
+      ++points;
+    }
+
+    if (!error.empty())
+    {
+      output << "error: " << error << std::endl << std::endl;
+      continue;
+    }
+
+    if (points == 0)
+      continue;
+
+    // The query set is built directly from the values; the points are stored
+    // one per column.
+    arma::mat querySet(values.data(), dimensionality, points);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    model.Search(std::move(querySet), k, neighbors, distances);
+
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+        output << neighbors(j, i) << ",";
+      for (size_t j = 0; j < k; ++j)
+        output << distances(j, i) << ((j + 1 < k) ? "," : "\n");
+    }
+    output << std::endl;
+
+    ++batches;
+  }
+
+  return batches;
+}
+
+#ifndef _WIN32
+/**
+ * A minimal stream buffer that reads from and writes to a connected socket, so
+ * that ServeQueries() can be used with a socket like any other stream.
+ */
+class SocketBuffer : public std::streambuf
+{
+ public:
+  //! Create the buffer for the given connected socket.
+  SocketBuffer(const int socket) : socket(socket)
+  {
+    setg(input, input, input);
+    setp(output, output + sizeof(output));
+  }
+
+  //! Flush the buffer.  The socket is not closed.
+  ~SocketBuffer() { sync(); }
+
+ protected:
+  //! Read more data from the socket.
+  int_type underflow()
+  {
+    ssize_t length;
+    do
+    {
+      length = recv(socket, input, sizeof(input), 0);
+    } while (length < 0 && errno == EINTR);
+
+    if (length <= 0)
+      return traits_type::eof();
+
+    setg(input, input, input + length);
+    return traits_type::to_int_type(*gptr());
+  }
+
+  //! Write the buffered data, and buffer the given character.
+  int_type overflow(int_type c)
+  {
+    if (sync() != 0)
+      return traits_type::eof();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+
+    return traits_type::not_eof(c);
+  }
+
+  //! Write all buffered data to the socket.
+  int sync()
+  {
+    // A client that has gone away must not kill the server with SIGPIPE.
+    #ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+
+    char* begin = pbase();
+    while (begin < pptr())
+    {
+      const ssize_t length = send(socket, begin, pptr() - begin, flags);
+      if (length < 0 && errno == EINTR)
+        continue;
+      if (length <= 0)
+      {
+        setp(output, output + sizeof(output));
+        return -1;
+      }
+
+      begin += length;
+    }
+
+    setp(output, output + sizeof(output));
+    return 0;
+  }
+
+ private:
+  //! The connected socket.
+  int socket;
+  //! Buffer for data read from the socket.
+  char input[4096];
+  //! Buffer for data to be written to the socket.
+  char output[4096];
+};
+#endif
+
+template<typename SortPolicy>
+bool ServeQueries(NSModel<SortPolicy>& model,
+                  const size_t k,
+                  const std::string& socketPath)
+{
+#ifndef _WIN32
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path))
+  {
+    Log::Warn << "Socket path '" << socketPath << "' is too long." << std::endl;
+    return false;
+  }
+  std::strcpy(address.sun_path, socketPath.c_str());
+
+  const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0 || bind(server, (sockaddr*) &address, sizeof(address)) != 0 ||
+      listen(server, 8) != 0)
+  {
+    Log::Warn << "Cannot listen on socket '" << socketPath << "': "
+        << std::strerror(errno) << "." << std::endl;
+    if (server >= 0)
+      close(server);
+    return false;
+  }
+
+  Log::Info << "Listening for queries on '" << socketPath << "'." << std::endl;
+
+  bool quit = false;
+  while (!quit)
+  {
+    const int client = accept(server, NULL, NULL);
+    if (client < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      Log::Warn << "Cannot accept connection on socket '" << socketPath
+          << "': " << std::strerror(errno) << "." << std::endl;
+      break;
+    }
+
+    {
+      SocketBuffer buffer(client);
+      std::iostream stream(&buffer);
+      const size_t batches = ServeQueries(model, k, stream, stream, &quit);
+      Log::Info << "Answered " << batches << " batches of queries."
+          << std::endl;
+    }
+    close(client);
+  }
+
+  close(server);
+  unlink(socketPath.c_str());
+  return quit;
+#else
+  // Unix domain sockets aren't available on Windows.
+  (void) model;
+  (void) k;
+  Log::Warn << "Cannot listen on socket '" << socketPath << "': sockets are "
+      << "not supported on Windows." << std::endl;
+  return false;
+#endif
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,264 @@
+/**
+ * @file random_forest.hpp
+ * @author Ryan Curtin
+ *
+ * Definition of a random forest: an ensemble of decision trees, each trained on
+ * a bootstrap sample of the data with a random subset of the dimensions
+ * searched at each node.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The RandomForest class is an ensemble of decision trees for classification.
+ * Each tree is trained on a bootstrap sample of the dataset (a sample of the
+ * same size, drawn with replacement), and only a random subset of the
+ * dimensions is searched for the split of each node, as given by the
+ * DimensionSelectionType.  The trees are trained in parallel with OpenMP.  A
+ * point is classified by summing the class probabilities that each tree gives
+ * for it; the predicted class is the class with the largest sum.
+ *
+ * The random seed of each tree is drawn from mlpack's random number generator
+ * before training starts, so the forest only depends on the random seed (see
+ * math::RandomSeed()) and not on the number of threads.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @article{breiman2001random,
+ *   title={Random forests},
+ *   author={Breiman, Leo},
+ *   journal={Machine Learning},
+ *   volume={45},
+ *   number={1},
+ *   pages={5--32},
+ *   year={2001}
+ * }
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to use for the decision trees.
+ * @tparam DimensionSelectionType Policy that selects the dimensions to search
+ *     at each node.
+ * @tparam NumericSplitType Split type to use for numeric dimensions.
+ * @tparam CategoricalSplitType Split type to use for categorical dimensions.
+ * @tparam ElemType Type of the elements of the dataset.
+ */
+template<typename FitnessFunction = GiniGain,
+         typename DimensionSelectionType = RandomDimensionSelect,
+         template<typename> class NumericSplitType = BestBinaryNumericSplit,
+         template<typename> class CategoricalSplitType = AllCategoricalSplit,
+         typename ElemType = double>
+class RandomForest
+{
+ public:
+  //! The type of the trees in the forest.
+  typedef DecisionTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+      ElemType, false, DimensionSelectionType> DecisionTreeType;
+
+  /**
+   * Construct the random forest without any training or specifying the number
+   * of trees.  Predictions will not be meaningful.
+   */
+  RandomForest() : numClasses(0) { }
+
+  /**
+   * Create a random forest, training on the given labeled training data, where
+   * all dimensions are numeric.
+   *
+   * @param dataset Dataset to train on.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param dimensionSelector Dimension selection policy; the selector of each
+   *     tree is created from it with Child().
+   */
+  template<typename MatType>
+  RandomForest(const MatType& dataset,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numTrees = 20,
+               const size_t minimumLeafSize = 1,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Create a random forest, training on the given labeled training data, where
+   * the dimensions may be numeric or categorical.
+   *
+   * @param dataset Dataset to train on.
+   * @param datasetInfo Type information for each dimension of the dataset.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param dimensionSelector Dimension selection policy; the selector of each
+   *     tree is created from it with Child().
+   */
+  template<typename MatType>
+  RandomForest(const MatType& dataset,
+               const data::DatasetInfo& datasetInfo,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numTrees = 20,
+               const size_t minimumLeafSize = 1,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the random forest on the given labeled training data, where all
+   * dimensions are numeric.  This replaces any trees that are already in the
+   * forest.
+   *
+   * @param dataset Dataset to train on.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param dimensionSelector Dimension selection policy; the selector of each
+   *     tree is created from it with Child().
+   */
+  template<typename MatType>
+  void Train(const MatType& dataset,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t numTrees = 20,
+             const size_t minimumLeafSize = 1,
+             DimensionSelectionType dimensionSelector =
+                 DimensionSelectionType());
+
+  /**
+   * Train the random forest on the given labeled training data, where the
+   * dimensions may be numeric or categorical.  This replaces any trees that
+   * are already in the forest.
+   *
+   * @param dataset Dataset to train on.
+   * @param datasetInfo Type information for each dimension of the dataset.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param dimensionSelector Dimension selection policy; the selector of each
+   *     tree is created from it with Child().
+   */
+  template<typename MatType>
+  void Train(const MatType& dataset,
+             const data::DatasetInfo& datasetInfo,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t numTrees = 20,
+             const size_t minimumLeafSize = 1,
+             DimensionSelectionType dimensionSelector =
+                 DimensionSelectionType());
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point, and the probability of each class
+   * (the average of the class probabilities given by the trees).
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with the class probabilities for
+   *     the point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of the given points.  The points are classified in
+   * parallel.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with the predicted class of each
+   *     point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points, and the probability of each class
+   * for each point.  The points are classified in parallel.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with the predicted class of each
+   *     point.
+   * @param probabilities This will be filled with the class probabilities of
+   *     each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Access a tree in the forest.
+  const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
+  //! Modify a tree in the forest (be careful!).
+  DecisionTreeType& Tree(const size_t i) { return trees[i]; }
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  /**
+   * Serialize the random forest.
+   */
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Train the trees of the forest.
+   *
+   * @param dataset Dataset to train on.
+   * @param datasetInfo Type information for each dimension of the dataset
+   *     (NULL if all dimensions are numeric).
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param dimensionSelector Dimension selection policy.
+   */
+  template<typename MatType>
+  void TrainTrees(const MatType& dataset,
+                  const data::DatasetInfo* datasetInfo,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const size_t numTrees,
+                  const size_t minimumLeafSize,
+                  DimensionSelectionType& dimensionSelector);
+
+  //! The trees in the forest.
+  std::vector<DecisionTreeType> trees;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "random_forest_impl.hpp"
+
+#endif
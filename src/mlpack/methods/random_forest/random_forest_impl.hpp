@@ -0,0 +1,343 @@
+/**
+ * @file random_forest_impl.hpp
+ * @author Ryan Curtin
+ *
+ * Implementation of the random forest.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_forest.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename MatType>
+RandomForest<FitnessFunction,
+             DimensionSelectionType,
+             NumericSplitType,
+             CategoricalSplitType,
+             ElemType>::RandomForest(
+    const MatType& dataset,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector) :
+    numClasses(0)
+{
+  TrainTrees(dataset, NULL, labels, numClasses, numTrees, minimumLeafSize,
+      dimensionSelector);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename MatType>
+RandomForest<FitnessFunction,
+             DimensionSelectionType,
+             NumericSplitType,
+             CategoricalSplitType,
+             ElemType>::RandomForest(
+    const MatType& dataset,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector) :
+    numClasses(0)
+{
+  TrainTrees(dataset, &datasetInfo, labels, numClasses, numTrees,
+      minimumLeafSize, dimensionSelector);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename MatType>
+void RandomForest<FitnessFunction,
+                  DimensionSelectionType,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType>::Train(
+    const MatType& dataset,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector)
+{
+  TrainTrees(dataset, NULL, labels, numClasses, numTrees, minimumLeafSize,
+      dimensionSelector);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename MatType>
+void RandomForest<FitnessFunction,
+                  DimensionSelectionType,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType>::Train(
+    const MatType& dataset,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const size_t minimumLeafSize,
+    DimensionSelectionType dimensionSelector)
+{
+  TrainTrees(dataset, &datasetInfo, labels, numClasses, numTrees,
+      minimumLeafSize, dimensionSelector);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename VecType>
+size_t RandomForest<FitnessFunction,
+                    DimensionSelectionType,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    ElemType>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+  return prediction;
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename VecType>
+void RandomForest<FitnessFunction,
+                  DimensionSelectionType,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType>::Classify(const VecType& point,
+                                      size_t& prediction,
+                                      arma::vec& probabilities) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("RandomForest::Classify(): no random forest "
+        "trained!");
+  }
+
+  // Sum the class probabilities of all trees.
+  probabilities.zeros(numClasses);
+  arma::vec treeProbabilities;
+  size_t treePrediction;
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    trees[t].Classify(point, treePrediction, treeProbabilities);
+    probabilities += treeProbabilities;
+  }
+
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+  probabilities /= trees.size();
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename MatType>
+void RandomForest<FitnessFunction,
+                  DimensionSelectionType,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType>::Classify(const MatType& data,
+                                      arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename MatType>
+void RandomForest<FitnessFunction,
+                  DimensionSelectionType,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType>::Classify(const MatType& data,
+                                      arma::Row<size_t>& predictions,
+                                      arma::mat& probabilities) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("RandomForest::Classify(): no random forest "
+        "trained!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(numClasses, data.n_cols);
+
+  // Each point is independent of the others, so the points can be classified
+  // in parallel.  The probabilities of the trees are summed in the same order
+  // for every point, so the result does not depend on the number of threads.
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+  #else
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < data.n_cols; ++i)
+  #endif
+  {
+    arma::vec v = probabilities.unsafe_col(i); // Alias of column.
+    Classify(data.col(i), predictions[i], v);
+  }
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename Archive>
+void RandomForest<FitnessFunction,
+                  DimensionSelectionType,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType>::Serialize(Archive& ar,
+                                       const unsigned int /* version */)
+{
+  size_t numTrees = trees.size();
+  ar & data::CreateNVP(numTrees, "numTrees");
+  ar & data::CreateNVP(numClasses, "numClasses");
+
+  if (Archive::is_loading::value)
+  {
+    trees.clear();
+    trees.resize(numTrees);
+  }
+
+  for (size_t i = 0; i < trees.size(); ++i)
+  {
+    std::ostringstream oss;
+    oss << "tree" << i;
+    ar & data::CreateNVP(trees[i], oss.str());
+  }
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+template<typename MatType>
+void RandomForest<FitnessFunction,
+                  DimensionSelectionType,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  ElemType>::TrainTrees(
+    const MatType& dataset,
+    const data::DatasetInfo* datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const size_t minimumLeafSize,
+    DimensionSelectionType& dimensionSelector)
+{
+  // Sanity check on data.
+  if (dataset.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::Train(): number of points (" << dataset.n_cols
+        << ") does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+  if (dataset.n_cols == 0)
+    throw std::invalid_argument("RandomForest::Train(): dataset is empty!");
+
+  this->numClasses = numClasses;
+  trees.clear();
+  trees.resize(numTrees);
+
+  // The seed of each tree's bootstrap sample and the dimension selector of
+  // each tree are drawn before the trees are trained in parallel, so that they
+  // don't depend on the order the trees are trained in.
+  std::vector<uint32_t> seeds(numTrees);
+  std::vector<DimensionSelectionType> selectors;
+  selectors.reserve(numTrees);
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    seeds[i] = (uint32_t) math::RandInt(std::numeric_limits<int>::max());
+    selectors.push_back(dimensionSelector.Child());
+  }
+
+  #ifdef _WIN32
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t i = 0; i < (intmax_t) numTrees; ++i)
+  #else
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < numTrees; ++i)
+  #endif
+  {
+    // Draw the bootstrap sample.
+    std::mt19937 generator(seeds[i]);
+    std::uniform_int_distribution<size_t> dist(0, dataset.n_cols - 1);
+    MatType bootstrapDataset(dataset.n_rows, dataset.n_cols);
+    arma::Row<size_t> bootstrapLabels(dataset.n_cols);
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      const size_t index = dist(generator);
+      bootstrapDataset.col(j) = dataset.col(index);
+      bootstrapLabels[j] = labels[index];
+    }
+
+    // Now train the tree on the sample.  Since we are in a parallel region,
+    // each tree is built by one thread, and its subtrees become tasks that idle
+    // threads can pick up.
+    if (datasetInfo)
+      trees[i].Train(std::move(bootstrapDataset), *datasetInfo,
+          std::move(bootstrapLabels), numClasses, minimumLeafSize,
+          selectors[i]);
+    else
+      trees[i].Train(std::move(bootstrapDataset), std::move(bootstrapLabels),
+          numClasses, minimumLeafSize, selectors[i]);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,259 @@
+/**
+ * @file random_forest_main.cpp
+ * @author Ryan Curtin
+ *
+ * A command-line program to train and evaluate a random forest.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include "random_forest.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::tree;
+
+PROGRAM_INFO("Random forests",
+    "Train and evaluate using a random forest.  Given a dataset containing "
+    "numeric features and associated labels for each point in the dataset, this"
+    " program can train a random forest on that data: an ensemble of decision "
+    "trees, each trained on a bootstrap sample of the data with a random subset"
+    " of the dimensions searched for the split of each node.  The trees are "
+    "trained in parallel, and test points are classified in parallel by summing"
+    " the class probabilities of all trees."
+    "\n\n"
+    "The training file and associated labels are specified with the "
+    "--training_file and --labels_file options, respectively.  The labels "
+    "should be in the range [0, num_classes - 1]. Optionally, if --labels_file "
+    "is not specified, the labels are assumed to be the last dimension of the "
+    "training dataset."
+    "\n\n"
+    "The --num_trees (-N) parameter specifies the number of trees in the "
+    "forest, the --minimum_leaf_size (-n) parameter specifies the minimum "
+    "number of training points in each leaf of each tree, and the "
+    "--num_dimensions (-d) parameter specifies the number of dimensions to "
+    "search at each node; if it is 0, the square root of the dimensionality "
+    "is used.  The --seed (-s) parameter specifies the random seed.  If "
+    "--print_training_error (-e) is specified, the training error will be "
+    "printed."
+    "\n\n"
+    "When a model is trained, it may be saved to file with the "
+    "--output_model_file (-M) option.  A model may be loaded from file for "
+    "predictions with the --input_model_file (-m) option.  The "
+    "--input_model_file option may not be specified when the --training_file "
+    "option is specified."
+    "\n\n"
+    "A file containing test data may be specified with the --test_file (-T) "
+    "option, and if performance numbers are desired for that test set, labels "
+    "may be specified with the --test_labels_file (-L) option.  Predictions "
+    "for each test point may be stored into the file specified by the "
+    "--predictions_file (-p) option.  Class probabilities for each prediction "
+    "will be stored in the file specified by the --probabilities_file (-P) "
+    "option.");
+
+// Datasets.
+PARAM_MATRIX_IN("training", "Matrix of training points.", "t");
+PARAM_UROW_IN("labels", "Training labels.", "l");
+PARAM_MATRIX_IN("test", "Matrix of test points.", "T");
+PARAM_UROW_IN("test_labels", "Test point labels, if accuracy calculation "
+    "is desired.", "L");
+
+// Training parameters.
+PARAM_INT_IN("num_trees", "Number of trees in the random forest.", "N", 20);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in a leaf.", "n",
+    1);
+PARAM_INT_IN("num_dimensions", "Number of dimensions to search for the split "
+    "of each node (0 means the square root of the dimensionality).", "d", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_FLAG("print_training_error", "Print the training error.", "e");
+
+// Output parameters.
+PARAM_MATRIX_OUT("probabilities", "Class probabilities for each test point.",
+    "P");
+PARAM_UROW_OUT("predictions", "Class predictions for each test point.", "p");
+
+/**
+ * This is the class that we will serialize.  It is a pretty simple wrapper
+ * around RandomForest<>.
+ */
+class RandomForestModel
+{
+ public:
+  // The random forest itself, left public for direct access by this program.
+  RandomForest<> rf;
+
+  // Create the model.
+  RandomForestModel() { /* Nothing to do. */ }
+
+  // Serialize the model.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & data::CreateNVP(rf, "rf");
+  }
+};
+
+// Models.
+PARAM_MODEL_IN(RandomForestModel, "input_model", "Pre-trained random forest, "
+    "to be used with test points.", "m");
+PARAM_MODEL_OUT(RandomForestModel, "output_model", "Output for trained random "
+    "forest.", "M");
+
+int main(int argc, char** argv)
+{
+  CLI::ParseCommandLine(argc, argv);
+
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // Check parameters.
+  if (CLI::HasParam("training") && CLI::HasParam("input_model"))
+    Log::Fatal << "Cannot specify both --training_file and --input_model_file!"
+        << endl;
+
+  if (!CLI::HasParam("training") && !CLI::HasParam("input_model"))
+    Log::Fatal << "Either --training_file or --input_model_file must be "
+        << "specified!" << endl;
+
+  if (CLI::HasParam("test_labels") && !CLI::HasParam("test"))
+    Log::Warn << "--test_labels_file ignored because --test_file is not passed."
+        << endl;
+
+  if (!CLI::HasParam("output_model") && !CLI::HasParam("probabilities") &&
+      !CLI::HasParam("predictions") && !CLI::HasParam("test_labels"))
+    Log::Warn << "None of --output_model_file, --probabilities_file, or "
+        << "--predictions_file are given, and accuracy is not being calculated;"
+        << " no output will be saved!" << endl;
+
+  if (CLI::HasParam("print_training_error") && !CLI::HasParam("training"))
+    Log::Warn << "--print_training_error ignored because --training_file is not"
+        << " specified." << endl;
+
+  if (!CLI::HasParam("test"))
+  {
+    if (CLI::HasParam("probabilities"))
+      Log::Warn << "--probabilities_file ignored because --test_file is not "
+          << "specified." << endl;
+    if (CLI::HasParam("predictions"))
+      Log::Warn << "--predictions_file ignored because --test_file is not "
+          << "specified." << endl;
+  }
+
+  if (CLI::GetParam<int>("num_trees") <= 0)
+    Log::Fatal << "Invalid number of trees (" << CLI::GetParam<int>("num_trees")
+        << "); must be positive!" << endl;
+
+  if (CLI::GetParam<int>("minimum_leaf_size") <= 0)
+    Log::Fatal << "Invalid minimum leaf size ("
+        << CLI::GetParam<int>("minimum_leaf_size") << "); must be positive!"
+        << endl;
+
+  if (CLI::GetParam<int>("num_dimensions") < 0)
+    Log::Fatal << "Invalid number of dimensions ("
+        << CLI::GetParam<int>("num_dimensions") << "); must be nonnegative!"
+        << endl;
+
+  // Load the model or build the forest.
+  RandomForestModel model;
+
+  if (CLI::HasParam("training"))
+  {
+    arma::mat dataset = std::move(CLI::GetParam<arma::mat>("training"));
+    arma::Row<size_t> labels;
+    if (CLI::HasParam("labels"))
+    {
+      labels = std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+    }
+    else
+    {
+      // Extract the labels as the last dimension of the training set.
+      Log::Info << "Using the last dimension of training set as labels."
+          << endl;
+      labels = arma::conv_to<arma::Row<size_t>>::from(
+          dataset.row(dataset.n_rows - 1));
+      dataset.shed_row(dataset.n_rows - 1);
+    }
+
+    // Calculate number of classes.
+    const size_t numClasses = arma::max(arma::max(labels)) + 1;
+
+    // Now build the forest.
+    const size_t numTrees = (size_t) CLI::GetParam<int>("num_trees");
+    const size_t minLeafSize = (size_t) CLI::GetParam<int>("minimum_leaf_size");
+    const size_t numDimensions =
+        (size_t) CLI::GetParam<int>("num_dimensions");
+
+    Timer::Start("rf_training");
+    model.rf.Train(dataset, labels, numClasses, numTrees, minLeafSize,
+        RandomDimensionSelect(numDimensions));
+    Timer::Stop("rf_training");
+
+    // Do we need to print training error?
+    if (CLI::HasParam("print_training_error"))
+    {
+      arma::Row<size_t> predictions;
+      model.rf.Classify(dataset, predictions);
+
+      size_t correct = 0;
+      for (size_t i = 0; i < dataset.n_cols; ++i)
+        if (predictions[i] == labels[i])
+          ++correct;
+
+      // Print number of correct points.
+      Log::Info << double(correct) / double(dataset.n_cols) * 100 << "\% "
+          << "correct on training set (" << correct << " / " << dataset.n_cols
+          << ")." << endl;
+    }
+  }
+  else
+  {
+    model = std::move(CLI::GetParam<RandomForestModel>("input_model"));
+  }
+
+  // Do we need to get predictions?
+  if (CLI::HasParam("test"))
+  {
+    arma::mat testPoints = std::move(CLI::GetParam<arma::mat>("test"));
+
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+
+    Timer::Start("rf_prediction");
+    model.rf.Classify(testPoints, predictions, probabilities);
+    Timer::Stop("rf_prediction");
+
+    // Do we need to calculate accuracy?
+    if (CLI::HasParam("test_labels"))
+    {
+      arma::Row<size_t> testLabels =
+          std::move(CLI::GetParam<arma::Row<size_t>>("test_labels"));
+
+      size_t correct = 0;
+      for (size_t i = 0; i < testPoints.n_cols; ++i)
+        if (predictions[i] == testLabels[i])
+          ++correct;
+
+      // Print number of correct points.
+      Log::Info << double(correct) / double(testPoints.n_cols) * 100 << "\% "
+          << "correct on test set (" << correct << " / " << testPoints.n_cols
+          << ")." << endl;
+    }
+
+    // Do we need to save outputs?
+    if (CLI::HasParam("predictions"))
+      CLI::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+    if (CLI::HasParam("probabilities"))
+      CLI::GetParam<arma::mat>("probabilities") = std::move(probabilities);
+  }
+
+  // Do we need to save the model?
+  if (CLI::HasParam("output_model"))
+    CLI::GetParam<RandomForestModel>("output_model") = std::move(model);
+
+  CLI::Destroy();
+}
@@ -299,6 +299,80 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed sparse row (CSR) format.
+   * Instead of a vector for each query point, all results are stored in two
+   * flat arrays, which is much faster and uses much less memory when there are
+   * many results.
+   *
+   * That is:
+   *
+   * - offsets.size() is the number of query points plus one, and offsets[0] is
+   *   0.
+   *
+   * - The results for query point i are neighbors[j] and distances[j], for
+   *   offsets[i] <= j < offsets[i + 1].  They are not sorted in any particular
+   *   order.
+   *
+   * In naive and single-tree mode, the query points are searched in parallel
+   * (if OpenMP is available), with a separate result buffer for each thread.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Object which will hold the offset of the results of each
+   *      query point in neighbors and distances.
+   * @param neighbors Object which will hold the neighbors of all query points.
+   * @param distances Object which will hold the distances of all query points.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              std::vector<size_t>& offsets,
+              std::vector<size_t>& neighbors,
+              std::vector<double>& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in compressed sparse row (CSR) format.  This
+   * means that the query set and the reference set are the same.  See the
+   * bichromatic overload for the format of the results.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Object which will hold the offset of the results of each
+   *      query point in neighbors and distances.
+   * @param neighbors Object which will hold the neighbors of all query points.
+   * @param distances Object which will hold the distances of all query points.
+   */
+  void Search(const math::Range& range,
+              std::vector<size_t>& offsets,
+              std::vector<size_t>& neighbors,
+              std::vector<double>& distances);
+
+  /**
+   * Count the reference points in the given range for each point in the query
+   * set, without storing the points themselves.  When all points in a
+   * reference node are known to be in range, they are counted without
+   * calculating any distances.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Object which will hold the number of reference points in
+   *      range of each query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             std::vector<size_t>& counts);
+
+  /**
+   * Count the points in the given range for each point in the reference set
+   * (not counting the point itself), without storing the points themselves.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Object which will hold the number of points in range of each
+   *      point in the reference set.
+   */
+  void Count(const math::Range& range, std::vector<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -351,6 +425,46 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Run the search with the given results objects, one for each thread (in
+   * naive and single-tree mode, query points may be searched in parallel;
+   * otherwise only the first results object is used).  Indices in the results
+   * are in terms of the datasets the search was run on; SearchResults() gives
+   * the mappings back to the original indices.
+   *
+   * @param querySet Set of query points, or NULL to search with the reference
+   *      set.
+   * @param range Range of distances in which to search.
+   * @param results Results objects to use.
+   * @param oldFromNewQueries Filled with the mapping of the query points, if a
+   *      query tree is built.
+   * @param queryMapping Set to the mapping of the query points (or NULL if they
+   *      are not rearranged).
+   * @param referenceMapping Set to the mapping of the reference points (or NULL
+   *      if they are not rearranged).
+   */
+  template<typename ResultsType>
+  void SearchResults(const MatType* querySet,
+                     const math::Range& range,
+                     std::vector<ResultsType>& results,
+                     std::vector<size_t>& oldFromNewQueries,
+                     const std::vector<size_t>*& queryMapping,
+                     const std::vector<size_t>*& referenceMapping);
+
+  //! Search with the given query set (or NULL for the reference set), and
+  //! store the results in CSR format.
+  void SearchCSR(const MatType* querySet,
+                 const math::Range& range,
+                 std::vector<size_t>& offsets,
+                 std::vector<size_t>& neighbors,
+                 std::vector<double>& distances);
+
+  //! Count the results with the given query set (or NULL for the reference
+  //! set).
+  void CountResults(const MatType* querySet,
+                    const math::Range& range,
+                    std::vector<size_t>& counts);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
@@ -18,6 +18,10 @@
 // The rules for traversal.
 #include "range_search_rules.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace range {
 
@@ -732,6 +736,328 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<size_t>& offsets,
+    std::vector<size_t>& neighbors,
+    std::vector<double>& distances)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchCSR(&querySet, range, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    std::vector<size_t>& offsets,
+    std::vector<size_t>& neighbors,
+    std::vector<double>& distances)
+{
+  SearchCSR(NULL, range, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<size_t>& counts)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Count(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  CountResults(&querySet, range, counts);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    std::vector<size_t>& counts)
+{
+  CountResults(NULL, range, counts);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultsType>
+void RangeSearch<MetricType, MatType, TreeType>::SearchResults(
+    const MatType* querySet,
+    const math::Range& range,
+    std::vector<ResultsType>& results,
+    std::vector<size_t>& oldFromNewQueries,
+    const std::vector<size_t>*& queryMapping,
+    const std::vector<size_t>*& referenceMapping)
+{
+  typedef RangeSearchRules<MetricType, Tree, ResultsType> RuleType;
+
+  // If no query set is given, we search with the reference set.
+  const bool sameSet = (querySet == NULL);
+  const MatType& queries = sameSet ? *referenceSet : *querySet;
+
+  // Reference indices (and query indices, if the sets are the same) only need
+  // to be mapped if we built the reference tree ourselves.
+  queryMapping = NULL;
+  referenceMapping = NULL;
+  if (!naive && treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    referenceMapping = &oldFromNewReferences;
+    if (sameSet)
+      queryMapping = &oldFromNewReferences;
+  }
+
+  Timer::Start("range_search/computing_neighbors");
+
+  if (naive || singleMode)
+  {
+    // Trees whose first point is the centroid store distances in the
+    // statistics of the reference nodes during the search, so in that case we
+    // can't search for several query points at once.
+    const bool parallel = naive ||
+        !tree::TreeTraits<Tree>::FirstPointIsCentroid;
+
+    size_t totalBaseCases = 0;
+    size_t totalScores = 0;
+    #pragma omp parallel if (parallel && results.size() > 1) \
+        num_threads(results.size()) reduction(+:totalBaseCases, totalScores)
+    {
+      size_t thread = 0;
+      #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+      #endif
+
+      RuleType rules(*referenceSet, queries, range, results[thread], metric,
+          sameSet);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      // On the Visual Studio compiler, we have to use intmax_t because size_t
+      // is not yet supported by their OpenMP implementation.
+      #ifdef _WIN32
+      #pragma omp for schedule(dynamic, 64)
+      for (intmax_t i = 0; i < (intmax_t) queries.n_cols; ++i)
+      #else
+      #pragma omp for schedule(dynamic, 64)
+      for (size_t i = 0; i < queries.n_cols; ++i)
+      #endif
+      {
+        if (naive)
+        {
+          // The naive brute-force solution.
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            rules.BaseCase(i, j);
+        }
+        else
+        {
+          traverser.Traverse(i, *referenceTree);
+        }
+      }
+
+      totalBaseCases += rules.BaseCases();
+      totalScores += rules.Scores();
+    }
+
+    baseCases = naive ? (queries.n_cols * referenceSet->n_cols) :
+        totalBaseCases;
+    scores = totalScores;
+  }
+  else // Dual-tree recursion.
+  {
+    Tree* queryTree = referenceTree;
+    if (!sameSet)
+    {
+      // Build the query tree.
+      Timer::Stop("range_search/computing_neighbors");
+      Timer::Start("range_search/tree_building");
+      queryTree = BuildTree<Tree>(*querySet, oldFromNewQueries);
+      Timer::Stop("range_search/tree_building");
+      Timer::Start("range_search/computing_neighbors");
+
+      if (tree::TreeTraits<Tree>::RearrangesDataset)
+        queryMapping = &oldFromNewQueries;
+    }
+
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, results[0],
+        metric, sameSet);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+
+    // Clean up tree memory.
+    if (!sameSet)
+      delete queryTree;
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::SearchCSR(
+    const MatType* querySet,
+    const math::Range& range,
+    std::vector<size_t>& offsets,
+    std::vector<size_t>& neighbors,
+    std::vector<double>& distances)
+{
+  const size_t numQueries = (querySet == NULL) ? referenceSet->n_cols :
+      querySet->n_cols;
+  offsets.assign(numQueries + 1, 0);
+  neighbors.clear();
+  distances.clear();
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // Each thread appends its results to its own buffers; in dual-tree mode only
+  // one thread is used.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  if (naive || singleMode)
+    threads = omp_get_max_threads();
+  #endif
+
+  std::vector<std::vector<size_t>> threadQueries(threads);
+  std::vector<std::vector<size_t>> threadNeighbors(threads);
+  std::vector<std::vector<double>> threadDistances(threads);
+  std::vector<RangeSearchFlatResults> results;
+  for (size_t t = 0; t < threads; ++t)
+  {
+    results.push_back(RangeSearchFlatResults(threadQueries[t],
+        threadNeighbors[t], threadDistances[t]));
+  }
+
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults(querySet, range, results, oldFromNewQueries, queryMapping,
+      referenceMapping);
+
+  // Count the results of each query point, and turn the counts into offsets.
+  for (size_t t = 0; t < threads; ++t)
+  {
+    for (size_t i = 0; i < threadQueries[t].size(); ++i)
+    {
+      const size_t query = (queryMapping == NULL) ? threadQueries[t][i] :
+          (*queryMapping)[threadQueries[t][i]];
+      ++offsets[query + 1];
+    }
+  }
+
+  for (size_t i = 1; i <= numQueries; ++i)
+    offsets[i] += offsets[i - 1];
+
+  // Now move the results of each thread into place.
+  neighbors.resize(offsets[numQueries]);
+  distances.resize(offsets[numQueries]);
+  std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+  for (size_t t = 0; t < threads; ++t)
+  {
+    for (size_t i = 0; i < threadQueries[t].size(); ++i)
+    {
+      const size_t query = (queryMapping == NULL) ? threadQueries[t][i] :
+          (*queryMapping)[threadQueries[t][i]];
+      const size_t position = positions[query]++;
+
+      neighbors[position] = (referenceMapping == NULL) ?
+          threadNeighbors[t][i] : (*referenceMapping)[threadNeighbors[t][i]];
+      distances[position] = threadDistances[t][i];
+    }
+
+    // Free each buffer as soon as it is no longer needed.
+    std::vector<size_t>().swap(threadQueries[t]);
+    std::vector<size_t>().swap(threadNeighbors[t]);
+    std::vector<double>().swap(threadDistances[t]);
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::CountResults(
+    const MatType* querySet,
+    const math::Range& range,
+    std::vector<size_t>& counts)
+{
+  const size_t numQueries = (querySet == NULL) ? referenceSet->n_cols :
+      querySet->n_cols;
+  counts.assign(numQueries, 0);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // The threads can share the counts, because each query point is only
+  // searched by one thread.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+  if (naive || singleMode)
+    threads = omp_get_max_threads();
+  #endif
+
+  std::vector<size_t> newCounts(numQueries, 0);
+  std::vector<RangeSearchCountResults> results(threads,
+      RangeSearchCountResults(newCounts));
+
+  std::vector<size_t> oldFromNewQueries;
+  const std::vector<size_t>* queryMapping;
+  const std::vector<size_t>* referenceMapping;
+  SearchResults(querySet, range, results, oldFromNewQueries, queryMapping,
+      referenceMapping);
+
+  // Map the query points back to their original indices, if necessary.
+  if (queryMapping == NULL)
+  {
+    counts.swap(newCounts);
+  }
+  else
+  {
+    for (size_t i = 0; i < numQueries; ++i)
+      counts[(*queryMapping)[i]] = newCounts[i];
+  }
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
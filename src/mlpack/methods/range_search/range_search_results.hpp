@@ -0,0 +1,160 @@
+/**
+ * @file range_search_results.hpp
+ * @author Ryan Curtin
+ *
+ * Classes that collect the results of range search for RangeSearchRules: as a
+ * vector of results for each query point, as one flat list of results, or only
+ * as the number of results of each query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * The results classes are lightweight handles: they only hold pointers to the
+ * objects the results are stored in, so copies of a results object (for
+ * instance, in copies of the rules) add to the same results.  Each results
+ * class provides the following:
+ *
+ *  - static const bool CountOnly: if true, only the number of results of each
+ *    query point is kept, so distances don't have to be computed when a whole
+ *    node is known to be in range.
+ *  - void Add(queryIndex, referenceIndex, distance): add a single result.
+ *  - void AddCount(queryIndex, count): add the given number of results whose
+ *    indices and distances are not known (only called if CountOnly is true).
+ *  - void Reserve(queryIndex, count): the given number of results will be
+ *    added for the given query point.
+ */
+
+/**
+ * Store the results in a vector of neighbors and a vector of distances for each
+ * query point.  This is the format that RangeSearch::Search() returns.
+ */
+class RangeSearchVectorResults
+{
+ public:
+  static const bool CountOnly = false;
+
+  //! Store results in the given vectors, which must hold a vector for each
+  //! query point.
+  RangeSearchVectorResults(std::vector<std::vector<size_t>>& neighbors,
+                           std::vector<std::vector<double>>& distances) :
+      neighbors(&neighbors), distances(&distances) { }
+
+  //! Add a single result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    (*neighbors)[queryIndex].push_back(referenceIndex);
+    (*distances)[queryIndex].push_back(distance);
+  }
+
+  //! This is never called, since distances are always needed.
+  void AddCount(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Make room for the given number of results of the given query point.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    (*neighbors)[queryIndex].reserve((*neighbors)[queryIndex].size() + count);
+    (*distances)[queryIndex].reserve((*distances)[queryIndex].size() + count);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>* neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<double>>* distances;
+};
+
+/**
+ * Store the results as one flat list of (query, neighbor, distance) triples, in
+ * three arrays.  Appending to a few large arrays avoids the allocation of a
+ * vector for every query point; the list can be turned into the compressed
+ * sparse row format afterwards.  A flat results object must only be used by
+ * one thread at a time.
+ */
+class RangeSearchFlatResults
+{
+ public:
+  static const bool CountOnly = false;
+
+  //! Store results in the given arrays.
+  RangeSearchFlatResults(std::vector<size_t>& queries,
+                         std::vector<size_t>& neighbors,
+                         std::vector<double>& distances) :
+      queries(&queries), neighbors(&neighbors), distances(&distances) { }
+
+  //! Add a single result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    queries->push_back(queryIndex);
+    neighbors->push_back(referenceIndex);
+    distances->push_back(distance);
+  }
+
+  //! This is never called, since distances are always needed.
+  void AddCount(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Nothing to do: the arrays grow geometrically anyway.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+ private:
+  //! The query point of each result.
+  std::vector<size_t>* queries;
+  //! The neighbor of each result.
+  std::vector<size_t>* neighbors;
+  //! The distance of each result.
+  std::vector<double>* distances;
+};
+
+/**
+ * Only count the results of each query point.  Several threads may use the same
+ * counts, as long as they work on different query points.
+ */
+class RangeSearchCountResults
+{
+ public:
+  static const bool CountOnly = true;
+
+  //! Store the counts in the given vector, which must hold an element for each
+  //! query point.
+  RangeSearchCountResults(std::vector<size_t>& counts) : counts(&counts) { }
+
+  //! Count a single result.
+  void Add(const size_t queryIndex,
+           const size_t /* referenceIndex */,
+           const double /* distance */)
+  {
+    ++(*counts)[queryIndex];
+  }
+
+  //! Count the given number of results.
+  void AddCount(const size_t queryIndex, const size_t count)
+  {
+    (*counts)[queryIndex] += count;
+  }
+
+  //! Nothing to do.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+ private:
+  //! The number of results of each query point.
+  std::vector<size_t>* counts;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
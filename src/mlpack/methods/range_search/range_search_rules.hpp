@@ -14,6 +14,8 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include "range_search_results.hpp"
+
 namespace mlpack {
 namespace range {
 
@@ -23,8 +25,12 @@ namespace range {
  *
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam ResultsType The class that collects the results (see
+ *     range_search_results.hpp).
  */
-template<typename MetricType, typename TreeType>
+template<typename MetricType,
+         typename TreeType,
+         typename ResultsType = RangeSearchVectorResults>
 class RangeSearchRules
 {
  public:
@@ -49,6 +55,35 @@ class RangeSearchRules
                    MetricType& metric,
                    const bool sameSet = false);
 
+  /**
+   * Construct the RangeSearchRules object, storing results in the given results
+   * object.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param results Object to store the results in.
+   * @param metric Instantiated metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  RangeSearchRules(const arma::mat& referenceSet,
+                   const arma::mat& querySet,
+                   const math::Range& range,
+                   const ResultsType& results,
+                   MetricType& metric,
+                   const bool sameSet = false);
+
+  /**
+   * Construct a copy of the given rules object that adds to the same results,
+   * but has its own traversal information, base case cache and counters.  This
+   * is used by parallel traversers, where each task works on a disjoint set of
+   * query points with its own rules object.
+   *
+   * @param other Rules object to share the results with.
+   */
+  RangeSearchRules(const RangeSearchRules& other);
+
   /**
    * Compute the base case between the given query point and reference point.
    *
@@ -114,8 +149,12 @@ class RangeSearchRules
 
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
   //! Get the number of scores (that is, calls to RangeDistance()).
   size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
 
  private:
   //! The reference set.
@@ -127,11 +166,8 @@ class RangeSearchRules
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The object the results should be stored in.
+  ResultsType results;
 
   //! The instantiated metric.
   MetricType& metric;
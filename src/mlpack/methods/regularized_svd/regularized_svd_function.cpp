@@ -122,6 +122,39 @@ void RegularizedSVDFunction::Gradient(const arma::mat& parameters,
   }
 }
 
+void RegularizedSVDFunction::Gradient(const arma::mat& parameters,
+                                      const size_t i,
+                                      arma::sp_mat& gradient) const
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  double ratingError = rating - arma::dot(parameters.col(user),
+                                          parameters.col(item));
+
+  // Gradient is non-zero only for the parameter columns corresponding to the
+  // example; the gradient is the same as one term of the full gradient.
+  arma::umat locations(2, 2 * rank);
+  arma::vec values(2 * rank);
+  for (size_t j = 0; j < rank; ++j)
+  {
+    locations(0, j) = j;
+    locations(1, j) = user;
+    values[j] = 2 * (lambda * parameters(j, user) -
+                     ratingError * parameters(j, item));
+
+    locations(0, rank + j) = j;
+    locations(1, rank + j) = item;
+    values[rank + j] = 2 * (lambda * parameters(j, item) -
+                            ratingError * parameters(j, user));
+  }
+
+  gradient = arma::sp_mat(locations, values, rank, numUsers + numItems);
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -109,23 +109,34 @@ void SoftmaxRegressionFunction::GetGroundTruthMatrix(const arma::Row<size_t>& la
 void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
     const arma::mat& parameters,
     arma::mat& probabilities) const
+{
+  GetProbabilitiesMatrix(parameters, data, probabilities);
+}
+
+/**
+ * Calculates the class probabilities of the given points.
+ */
+void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
+    const arma::mat& parameters,
+    const arma::mat& points,
+    arma::mat& probabilities) const
 {
   arma::mat hypothesis;
 
   if (fitIntercept)
   {
     // In order to add the intercept term, we should compute following matrix:
-    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
-    //     hypothesis = arma::exp(parameters * [1; data]).
+    //     [1; points] = arma::join_cols(ones(1, points.n_cols), points)
+    //     hypothesis = arma::exp(parameters * [1; points]).
     //
-    // Since the cost of join maybe high due to the copy of original data,
+    // Since the cost of join maybe high due to the copy of original points,
     // split the hypothesis computation to two components.
-    hypothesis = arma::exp(arma::repmat(parameters.col(0), 1, data.n_cols) +
-                           parameters.cols(1, parameters.n_cols - 1) * data);
+    hypothesis = arma::exp(arma::repmat(parameters.col(0), 1, points.n_cols) +
+                           parameters.cols(1, parameters.n_cols - 1) * points);
   }
   else
   {
-    hypothesis = arma::exp(parameters * data);
+    hypothesis = arma::exp(parameters * points);
   }
 
   probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
@@ -205,3 +216,69 @@ void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
                lambda * parameters;
   }
 }
+
+/**
+ * Evaluates the objective function for one training example.
+ */
+double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t i) const
+{
+  // Use the training example without copying it.
+  const arma::mat point(const_cast<double*>(data.colptr(i)), data.n_rows, 1,
+      false, true);
+
+  arma::mat probabilities;
+  GetProbabilitiesMatrix(parameters, point, probabilities);
+
+  // The negative log likelihood of the example, and the regularization.
+  const double logLikelihood = arma::accu(arma::sp_mat(groundTruth.col(i)) %
+      arma::log(probabilities));
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
+
+  return -logLikelihood + weightDecay;
+}
+
+/**
+ * Calculates the gradient of the objective function for one training example.
+ */
+void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
+                                         const size_t i,
+                                         arma::mat& gradient) const
+{
+  Gradient(parameters, i, 1, gradient);
+}
+
+/**
+ * Calculates the sum of the gradients of the objective function for a
+ * contiguous batch of training examples.
+ */
+void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         const size_t batchSize,
+                                         arma::mat& gradient) const
+{
+  // Use the training examples of the batch without copying them.
+  const arma::mat points(const_cast<double*>(data.colptr(begin)), data.n_rows,
+      batchSize, false, true);
+
+  arma::mat probabilities;
+  GetProbabilitiesMatrix(parameters, points, probabilities);
+
+  // The gradient of each example is (p - y) * x' + lambda * theta, where p is
+  // the vector of class probabilities and y is the ground truth.
+  const arma::mat inner = probabilities -
+      arma::sp_mat(groundTruth.cols(begin, begin + batchSize - 1));
+
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  if (fitIntercept)
+  {
+    gradient.col(0) = arma::sum(inner, 1) + batchSize * lambda *
+        parameters.col(0);
+    gradient.cols(1, parameters.n_cols - 1) = inner * points.t() +
+        batchSize * lambda * parameters.cols(1, parameters.n_cols - 1);
+  }
+  else
+  {
+    gradient = inner * points.t() + batchSize * lambda * parameters;
+  }
+}
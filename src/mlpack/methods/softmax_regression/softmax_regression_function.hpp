@@ -111,6 +111,47 @@ class SoftmaxRegressionFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluates the objective function of the softmax regression model for one
+   * training example, for optimizers such as SGD that use one example (or a
+   * mini-batch of examples) at a time.  This is the negative log likelihood of
+   * the example plus the regularization cost, so the objective of the whole
+   * dataset is the mean of the objectives of the examples.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param i Index of the training example.
+   */
+  double Evaluate(const arma::mat& parameters, const size_t i) const;
+
+  /**
+   * Evaluates the gradient of the objective function for one training example.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param i Index of the training example.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::mat& gradient) const;
+
+  /**
+   * Evaluates the sum of the gradients of the objective function for the
+   * training examples begin, ..., begin + batchSize - 1, with one matrix
+   * product.  This is used by mini-batch SGD.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first training example of the batch.
+   * @param batchSize Number of training examples in the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                const size_t batchSize,
+                arma::mat& gradient) const;
+
+  //! Return the number of training examples (for SGD-like optimizers).
+  size_t NumFunctions() const { return data.n_cols; }
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
@@ -133,6 +174,14 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
+  /**
+   * Evaluate the probabilities matrix of the given points; see the public
+   * GetProbabilitiesMatrix().
+   */
+  void GetProbabilitiesMatrix(const arma::mat& parameters,
+                              const arma::mat& points,
+                              arma::mat& probabilities) const;
+
   //! Training data matrix.
   const arma::mat& data;
   //! Label matrix for the provided data.
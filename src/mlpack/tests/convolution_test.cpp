@@ -16,6 +16,8 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/layer/convolution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -149,6 +151,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through the unrolled input patches.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -186,6 +192,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through the unrolled input patches.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -231,6 +241,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through the unrolled input patches.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -280,6 +294,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through the unrolled input patches.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -370,4 +388,63 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
       filterCube, outputCube);
 }
 
+/**
+ * Make sure that the Convolution layer gives the same results with the
+ * im2col convolution rules as with the naive convolution rules.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution> > Im2ColLayer;
+
+  // The gradients are only compared for a single input map without padding,
+  // where the naive rules store them in the same order as the weights.
+  const size_t inSizes[] = { 1, 3 };
+  const size_t pads[] = { 0, 1 };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    for (size_t p = 0; p < 2; ++p)
+    {
+      const size_t inSize = inSizes[i];
+      const size_t pad = pads[p];
+
+      Convolution<> naive(inSize, 4, 3, 3, 1, 1, pad, pad, 7, 6);
+      Im2ColLayer im2col(inSize, 4, 3, 3, 1, 1, pad, pad, 7, 6);
+      naive.Parameters().randu();
+      im2col.Parameters() = naive.Parameters();
+      naive.Reset();
+      im2col.Reset();
+
+      arma::mat input = arma::randu(7 * 6 * inSize, 1);
+      arma::mat naiveOutput, im2colOutput;
+      naive.Forward(std::move(input), std::move(naiveOutput));
+      im2col.Forward(std::move(input), std::move(im2colOutput));
+
+      BOOST_REQUIRE_EQUAL(naive.OutputWidth(), im2col.OutputWidth());
+      BOOST_REQUIRE_EQUAL(naive.OutputHeight(), im2col.OutputHeight());
+      CheckMatrices(naiveOutput, im2colOutput);
+
+      arma::mat error = arma::randu(naiveOutput.n_elem, 1);
+      arma::mat naiveDelta, im2colDelta;
+      naive.Backward(std::move(input), std::move(error),
+          std::move(naiveDelta));
+      im2col.Backward(std::move(input), std::move(error),
+          std::move(im2colDelta));
+      CheckMatrices(naiveDelta, im2colDelta);
+
+      if (inSize == 1 && pad == 0)
+      {
+        arma::mat naiveGradient(naive.Parameters().n_elem, 1);
+        arma::mat im2colGradient(im2col.Parameters().n_elem, 1);
+        naive.Gradient(std::move(input), std::move(error),
+            std::move(naiveGradient));
+        im2col.Gradient(std::move(input), std::move(error),
+            std::move(im2colGradient));
+        CheckMatrices(naiveGradient, im2colGradient);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/dbscan/dbscan.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -18,6 +19,9 @@
 using namespace mlpack;
 using namespace mlpack::dbscan;
 using namespace mlpack::distribution;
+using namespace mlpack::range;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
 
 BOOST_AUTO_TEST_SUITE(DBSCANTest);
 
@@ -27,15 +31,20 @@ BOOST_AUTO_TEST_CASE(OneClusterTest)
   // large enough, all points end up as in one cluster.
   arma::mat points(10, 200, arma::fill::randu);
 
-  DBSCAN<> d(2.0, 2);
+  // Check both batch mode and point-by-point expansion.
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    DBSCAN<> d(2.0, 2, RangeSearch<>(), RandomPointSelection(),
+        (mode == 0));
 
-  arma::Row<size_t> assignments;
-  const size_t clusters = d.Cluster(points, assignments);
+    arma::Row<size_t> assignments;
+    const size_t clusters = d.Cluster(points, assignments);
 
-  BOOST_REQUIRE_EQUAL(clusters, 1);
-  BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
-  for (size_t i = 0; i < assignments.n_elem; ++i)
-    BOOST_REQUIRE_EQUAL(assignments[i], 0);
+    BOOST_REQUIRE_EQUAL(clusters, 1);
+    BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
+    for (size_t i = 0; i < assignments.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[i], 0);
+  }
 }
 
 /**
@@ -45,15 +54,20 @@ BOOST_AUTO_TEST_CASE(TinyEpsilonTest)
 {
   arma::mat points(10, 200, arma::fill::randu);
 
-  DBSCAN<> d(1e-50, 2);
+  // Check both batch mode and point-by-point expansion.
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    DBSCAN<> d(1e-50, 2, RangeSearch<>(), RandomPointSelection(),
+        (mode == 0));
 
-  arma::Row<size_t> assignments;
-  const size_t clusters = d.Cluster(points, assignments);
+    arma::Row<size_t> assignments;
+    const size_t clusters = d.Cluster(points, assignments);
 
-  BOOST_REQUIRE_EQUAL(clusters, 0);
-  BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
-  for (size_t i = 0; i < assignments.n_elem; ++i)
-    BOOST_REQUIRE_EQUAL(assignments[i], SIZE_MAX);
+    BOOST_REQUIRE_EQUAL(clusters, 0);
+    BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
+    for (size_t i = 0; i < assignments.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[i], SIZE_MAX);
+  }
 }
 
 /**
@@ -68,16 +82,21 @@ BOOST_AUTO_TEST_CASE(OutlierTest)
   points.col(45) = arma::vec("-100 0.0");
   points.col(101) = arma::vec("1.5 1.5");
 
-  DBSCAN<> d(0.1, 3);
+  // Check both batch mode and point-by-point expansion.
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    DBSCAN<> d(0.1, 3, RangeSearch<>(), RandomPointSelection(),
+        (mode == 0));
 
-  arma::Row<size_t> assignments;
-  const size_t clusters = d.Cluster(points, assignments);
+    arma::Row<size_t> assignments;
+    const size_t clusters = d.Cluster(points, assignments);
 
-  BOOST_REQUIRE_GT(clusters, 0);
-  BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
-  BOOST_REQUIRE_EQUAL(assignments[15], SIZE_MAX);
-  BOOST_REQUIRE_EQUAL(assignments[45], SIZE_MAX);
-  BOOST_REQUIRE_EQUAL(assignments[101], SIZE_MAX);
+    BOOST_REQUIRE_GT(clusters, 0);
+    BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
+    BOOST_REQUIRE_EQUAL(assignments[15], SIZE_MAX);
+    BOOST_REQUIRE_EQUAL(assignments[45], SIZE_MAX);
+    BOOST_REQUIRE_EQUAL(assignments[101], SIZE_MAX);
+  }
 }
 
 /**
@@ -98,51 +117,121 @@ BOOST_AUTO_TEST_CASE(GaussiansTest)
   for (size_t i = 200; i < 300; ++i)
     points.col(i) = g3.Random();
 
-  DBSCAN<> d(2.0, 3);
-
-  arma::Row<size_t> assignments;
-  arma::mat centroids;
-  const size_t clusters = d.Cluster(points, assignments, centroids);
-  BOOST_REQUIRE_EQUAL(clusters, 3);
-
-  // Our centroids should be close to one of our Gaussians.
-  arma::Row<size_t> matches(3);
-  matches.fill(3);
-  for (size_t j = 0; j < 3; ++j)
+  // Check both batch mode and point-by-point expansion.
+  for (size_t mode = 0; mode < 2; ++mode)
   {
-    if (arma::norm(g1.Mean() - centroids.col(j)) < 3.0)
-      matches(0) = j;
-    else if (arma::norm(g2.Mean() - centroids.col(j)) < 3.0)
-      matches(1) = j;
-    else if (arma::norm(g3.Mean() - centroids.col(j)) < 3.0)
-      matches(2) = j;
+    DBSCAN<> d(2.0, 3, RangeSearch<>(), RandomPointSelection(),
+        (mode == 0));
+
+    arma::Row<size_t> assignments;
+    arma::mat centroids;
+    const size_t clusters = d.Cluster(points, assignments, centroids);
+    BOOST_REQUIRE_EQUAL(clusters, 3);
+
+    // Our centroids should be close to one of our Gaussians.
+    arma::Row<size_t> matches(3);
+    matches.fill(3);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      if (arma::norm(g1.Mean() - centroids.col(j)) < 3.0)
+        matches(0) = j;
+      else if (arma::norm(g2.Mean() - centroids.col(j)) < 3.0)
+        matches(1) = j;
+      else if (arma::norm(g3.Mean() - centroids.col(j)) < 3.0)
+        matches(2) = j;
+    }
+
+    BOOST_REQUIRE_NE(matches(0), matches(1));
+    BOOST_REQUIRE_NE(matches(1), matches(2));
+    BOOST_REQUIRE_NE(matches(2), matches(0));
+
+    BOOST_REQUIRE_NE(matches(0), 3);
+    BOOST_REQUIRE_NE(matches(1), 3);
+    BOOST_REQUIRE_NE(matches(2), 3);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+      // Each point should either be noise or in cluster matches(0).
+      BOOST_REQUIRE_NE(assignments(i), matches(1));
+      BOOST_REQUIRE_NE(assignments(i), matches(2));
+    }
+
+    for (size_t i = 100; i < 200; ++i)
+    {
+      BOOST_REQUIRE_NE(assignments(i), matches(0));
+      BOOST_REQUIRE_NE(assignments(i), matches(2));
+    }
+
+    for (size_t i = 200; i < 300; ++i)
+    {
+      BOOST_REQUIRE_NE(assignments(i), matches(0));
+      BOOST_REQUIRE_NE(assignments(i), matches(1));
+    }
   }
+}
+
+/**
+ * Check core points, border points and noise on a small hand-made dataset.
+ */
+BOOST_AUTO_TEST_CASE(BatchBorderPointTest)
+{
+  // Two groups of core points; point 4 is a border point of the first group,
+  // and point 8 is noise.
+  arma::mat points("0.0 0.1 0.2 0.3 0.55 1.0 1.1 1.2 5.0");
 
-  BOOST_REQUIRE_NE(matches(0), matches(1));
-  BOOST_REQUIRE_NE(matches(1), matches(2));
-  BOOST_REQUIRE_NE(matches(2), matches(0));
+  DBSCAN<> d(0.3, 3);
 
-  BOOST_REQUIRE_NE(matches(0), 3);
-  BOOST_REQUIRE_NE(matches(1), 3);
-  BOOST_REQUIRE_NE(matches(2), 3);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
 
-  for (size_t i = 0; i < 100; ++i)
-  {
-    // Each point should either be noise or in cluster matches(0).
-    BOOST_REQUIRE_NE(assignments(i), matches(1));
-    BOOST_REQUIRE_NE(assignments(i), matches(2));
-  }
+  // Clusters are numbered in the order of their first point.
+  BOOST_REQUIRE_EQUAL(clusters, 2);
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
+  for (size_t i = 0; i < 5; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 0);
+  for (size_t i = 5; i < 8; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 1);
+  BOOST_REQUIRE_EQUAL(assignments[8], SIZE_MAX);
+}
 
-  for (size_t i = 100; i < 200; ++i)
-  {
-    BOOST_REQUIRE_NE(assignments(i), matches(0));
-    BOOST_REQUIRE_NE(assignments(i), matches(2));
-  }
+/**
+ * Make sure that batch mode gives the same clusters no matter how the range
+ * search is done.
+ */
+BOOST_AUTO_TEST_CASE(BatchRangeSearchTypeTest)
+{
+  arma::mat points(3, 600);
 
-  for (size_t i = 200; i < 300; ++i)
+  GaussianDistribution g1(3), g2(3), g3(3);
+  g1.Mean() = arma::vec("0.0 0.0 0.0");
+  g2.Mean() = arma::vec("3.0 3.0 4.0");
+  g3.Mean() = arma::vec("-3.0 1.0 -3.5");
+  for (size_t i = 0; i < 200; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 200; i < 400; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 400; i < 600; ++i)
+    points.col(i) = g3.Random();
+
+  DBSCAN<> dualTree(0.6, 5);
+  DBSCAN<> naive(0.6, 5, RangeSearch<>(true));
+  DBSCAN<> singleTree(0.6, 5, RangeSearch<>(false, true));
+  DBSCAN<RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree>>
+      coverTree(0.6, 5);
+
+  arma::Row<size_t> dualAssignments, naiveAssignments, singleAssignments,
+      coverAssignments;
+  const size_t clusters = dualTree.Cluster(points, dualAssignments);
+  BOOST_REQUIRE_EQUAL(naive.Cluster(points, naiveAssignments), clusters);
+  BOOST_REQUIRE_EQUAL(singleTree.Cluster(points, singleAssignments),
+      clusters);
+  BOOST_REQUIRE_EQUAL(coverTree.Cluster(points, coverAssignments), clusters);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
   {
-    BOOST_REQUIRE_NE(assignments(i), matches(0));
-    BOOST_REQUIRE_NE(assignments(i), matches(1));
+    BOOST_REQUIRE_EQUAL(naiveAssignments[i], dualAssignments[i]);
+    BOOST_REQUIRE_EQUAL(singleAssignments[i], dualAssignments[i]);
+    BOOST_REQUIRE_EQUAL(coverAssignments[i], dualAssignments[i]);
   }
 }
 
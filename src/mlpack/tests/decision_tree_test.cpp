@@ -256,6 +256,253 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Check that the BestBinaryNumericSplit finds the right split when the values
+ * are not given in sorted order.
+ */
+BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitUnsortedTest)
+{
+  arma::vec values("0.5 0.1 0.9 0.3 0.7 0.0 1.0 0.2 0.8 0.4 0.6");
+  arma::Row<size_t> labels("1 0 1 0 1 0 1 0 1 0 1");
+
+  arma::vec classProbabilities;
+  BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate(labels, 2);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter(bestGain,
+      values, labels, 2, 3, classProbabilities, aux);
+
+  // The split is still perfect.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+}
+
+/**
+ * Check that EvaluateCounts() gives the same gain as Evaluate() for both
+ * fitness functions.
+ */
+BOOST_AUTO_TEST_CASE(EvaluateCountsTest)
+{
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < 100; ++i)
+    labels[i] = math::RandInt(5);
+
+  arma::Col<size_t> counts(5, arma::fill::zeros);
+  for (size_t i = 0; i < 100; ++i)
+    counts[labels[i]]++;
+
+  BOOST_REQUIRE_CLOSE(GiniGain::EvaluateCounts(counts, 100),
+      GiniGain::Evaluate(labels, 5), 1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::EvaluateCounts(counts, 100),
+      InformationGain::Evaluate(labels, 5), 1e-5);
+
+  // With no points, the gain is zero.
+  counts.zeros();
+  BOOST_REQUIRE_EQUAL(GiniGain::EvaluateCounts(counts, 0), 0.0);
+  BOOST_REQUIRE_EQUAL(InformationGain::EvaluateCounts(counts, 0), 0.0);
+}
+
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate(labels, 2);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter(bestGain,
+      values, labels, 2, 3, classProbabilities, aux);
+
+  // Make sure that a split was made.
+  BOOST_REQUIRE_GT(gain, bestGain);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  // The class probabilities, for this split, hold the splitting point, which
+  // should be between 4 and 5.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+}
+
+/**
+ * Check that the HistogramNumericSplit won't split if not enough points are
+ * given.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitMinSamplesTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate(labels, 2);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter(bestGain,
+      values, labels, 2, 8, classProbabilities, aux);
+
+  // Make sure that no split was made.
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit doesn't split a dimension that gives no
+ * gain.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitNoGainTest)
+{
+  arma::vec values(100);
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < 100; i += 2)
+  {
+    values[i] = i;
+    labels[i] = 0;
+    values[i + 1] = i;
+    labels[i + 1] = 1;
+  }
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate(labels, 2);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter(bestGain,
+      values, labels, 2, 10, classProbabilities, aux);
+
+  // Make sure there was no split.
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds a perfect split when there are
+ * many more points than bins, as long as the gap between the classes is wider
+ * than a bin.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitManyPointsTest)
+{
+  // The points of class 0 are in [0, 1), and the points of class 1 are in
+  // [1.05, 2); the bins are less than 0.01 wide.
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = (i % 2);
+    values[i] = (i % 2 == 0) ? math::Random() : math::Random(1.05, 2.0);
+  }
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate(labels, 2);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter(bestGain,
+      values, labels, 2, 10, classProbabilities, aux);
+
+  // The split should be perfect, and lie between the two classes.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GE(classProbabilities[0], 1.0);
+  BOOST_REQUIRE_LE(classProbabilities[0], 1.05);
+}
+
+/**
+ * Check that HistogramNumericSplit::Bin() gives each distinct value its own bin
+ * when there are few of them, and bins of about the same size otherwise.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitBinTest)
+{
+  typedef HistogramNumericSplit<GiniGain> SplitType;
+
+  arma::vec values("3 1 2 1 3 3 5");
+  arma::Row<unsigned char> bins;
+  arma::vec splitValues;
+  size_t numBins = SplitType::Bin(values, bins, splitValues);
+
+  BOOST_REQUIRE_EQUAL(numBins, 4);
+  BOOST_REQUIRE_EQUAL(bins.n_elem, values.n_elem);
+  const size_t expectedBins[] = { 2, 0, 1, 0, 2, 2, 3 };
+  for (size_t i = 0; i < values.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL((size_t) bins[i], expectedBins[i]);
+
+  BOOST_REQUIRE_EQUAL(splitValues.n_elem, 3);
+  BOOST_REQUIRE_CLOSE(splitValues[0], 1.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(splitValues[1], 2.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(splitValues[2], 4.0, 1e-5);
+
+  // Now use many more distinct values than bins.
+  values = arma::randu<arma::vec>(10000);
+  numBins = SplitType::Bin(values, bins, splitValues);
+
+  BOOST_REQUIRE_EQUAL(numBins, (size_t) SplitType::MaxBins);
+  BOOST_REQUIRE_EQUAL(splitValues.n_elem, numBins - 1);
+
+  arma::Col<size_t> binCounts(numBins, arma::fill::zeros);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    const size_t bin = bins[i];
+    ++binCounts[bin];
+
+    // Each value must be on the right side of the split values of its bin.
+    if (bin > 0)
+      BOOST_REQUIRE_GT(values[i], splitValues[bin - 1]);
+    if (bin < numBins - 1)
+      BOOST_REQUIRE_LE(values[i], splitValues[bin]);
+  }
+
+  for (size_t b = 0; b < numBins; ++b)
+  {
+    BOOST_REQUIRE_GE(binCounts[b], 39);
+    BOOST_REQUIRE_LE(binCounts[b], 40);
+  }
+}
+
+/**
+ * Check that HistogramNumericSplit::SplitHistogramIfBetter() finds a perfect
+ * split in a histogram, skipping bins that are empty.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitHistogramTest)
+{
+  // Two classes and five bins; bin 2 is empty.
+  arma::Mat<size_t> histogram("5 3 0 0 0; 0 0 0 4 6");
+  arma::vec splitValues("1.5 2.5 3.5 4.5");
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::EvaluateCounts(arma::Col<size_t>("8 10"),
+      18);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitHistogramIfBetter(
+      bestGain, histogram, splitValues, 3, classProbabilities, aux);
+
+  // The split should be perfect, and be placed right after bin 1.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_CLOSE(classProbabilities[0], 2.5, 1e-5);
+
+  // With a minimum leaf size of 10, no split is possible.
+  classProbabilities.clear();
+  const double noGain = HistogramNumericSplit<GiniGain>::SplitHistogramIfBetter(
+      bestGain, histogram, splitValues, 10, classProbabilities, aux);
+  BOOST_REQUIRE_EQUAL(noGain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -456,6 +703,86 @@ BOOST_AUTO_TEST_CASE(SimpleGeneralizationTest)
   BOOST_REQUIRE_GT(correct, 0.75);
 }
 
+/**
+ * Make sure that a decision tree with the histogram numeric split learns the
+ * exact thresholds of labels that are separable along the axes.  The tree is
+ * large enough that its children are built in parallel, with the histograms
+ * of the larger children derived from those of their parents.
+ */
+BOOST_AUTO_TEST_CASE(HistogramSeparableTest)
+{
+  // Dimensions 0 and 1 take 100 distinct values; dimension 2 is noise with
+  // more distinct values than bins.
+  arma::mat dataset(3, 20000);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    dataset(0, i) = math::RandInt(100);
+    dataset(1, i) = math::RandInt(100);
+    dataset(2, i) = math::Random();
+    labels[i] = ((dataset(0, i) >= 30) ? 1 : 0) +
+        ((dataset(1, i) >= 70) ? 2 : 0);
+  }
+
+  DecisionTree<GiniGain, HistogramNumericSplit> tree(dataset, labels, 4, 1);
+
+  // Every point of the grid should be classified correctly.
+  for (size_t x = 0; x < 100; ++x)
+  {
+    for (size_t y = 0; y < 100; ++y)
+    {
+      arma::vec point(3);
+      point[0] = x;
+      point[1] = y;
+      point[2] = 0.5;
+      const size_t label = ((x >= 30) ? 1 : 0) + ((y >= 70) ? 2 : 0);
+      BOOST_REQUIRE_EQUAL(tree.Classify(point), label);
+    }
+  }
+}
+
+/**
+ * Test that the decision tree generalizes reasonably when the histogram
+ * numeric split is used.
+ */
+BOOST_AUTO_TEST_CASE(HistogramGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Build decision tree.
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  // Load testing data.
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  // Get the predicted test labels.
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  // Figure out the accuracy.
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -598,4 +925,89 @@ BOOST_AUTO_TEST_CASE(DecisionStumpTest)
   BOOST_REQUIRE_EQUAL(stump.Child(1).NumChildren(), 0);
 }
 
+/**
+ * Make sure that two decision trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameStructure(const TreeType& tree, const TreeType& otherTree)
+{
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), otherTree.NumChildren());
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckSameStructure(tree.Child(i), otherTree.Child(i));
+}
+
+/**
+ * Make sure that two decision trees have the same structure and give the same
+ * predictions and probabilities for the given points.
+ */
+template<typename TreeType>
+void CheckSameTree(const TreeType& tree,
+                   const TreeType& otherTree,
+                   const arma::mat& data)
+{
+  CheckSameStructure(tree, otherTree);
+
+  arma::Row<size_t> predictions, otherPredictions;
+  arma::mat probabilities, otherProbabilities;
+  tree.Classify(data, predictions, probabilities);
+  otherTree.Classify(data, otherPredictions, otherProbabilities);
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], otherPredictions[i]);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(probabilities[i], otherProbabilities[i]);
+}
+
+/**
+ * Make sure that a tree that is large enough to be built in parallel is the
+ * same as a tree built with the serial split search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBuildTest)
+{
+  // Four numeric dimensions and one categorical dimension; the labels depend
+  // on both kinds of dimensions, with some noise so that the tree is deep.
+  arma::mat dataset(5, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    dataset(4, i) = (double) math::RandInt(4);
+    if (math::Random() < 0.1)
+      labels[i] = math::RandInt(4);
+    else
+      labels[i] = ((dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0) +
+          ((dataset(4, i) >= 2.0) ? 2 : 0);
+  }
+
+  data::DatasetInfo di(5);
+  di.Type(4) = data::Datatype::categorical;
+  di.MapString<double>("0", 4);
+  di.MapString<double>("1", 4);
+  di.MapString<double>("2", 4);
+  di.MapString<double>("3", 4);
+
+  typedef DecisionTree<GiniGain, HistogramNumericSplit> TreeType;
+  TreeType tree(dataset, di, labels, 4, 5);
+  TreeType numericTree(dataset, labels, 4, 5);
+
+  // Nodes that are built inside of a parallel region with more than one
+  // thread search their splits one dimension at a time, so these trees are
+  // built with the serial split search.
+  TreeType serialTree, serialNumericTree;
+  #pragma omp parallel
+  {
+    #pragma omp single
+    {
+      serialTree.Train(dataset, di, labels, 4, 5);
+      serialNumericTree.Train(dataset, labels, 4, 5);
+    }
+  }
+
+  // The trees should have learned something.
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE_GT(numericTree.NumChildren(), 0);
+
+  CheckSameTree(tree, serialTree, dataset);
+  CheckSameTree(numericTree, serialNumericTree, dataset);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -280,4 +280,59 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
 
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the parallel computation gives the same tree as the
+ * computation with one thread, for both the dual-tree and naive methods.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeBoruvkaTest)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  DualTreeBoruvka<> serialDtb(inputData);
+  arma::mat serialResults;
+  serialDtb.ComputeMST(serialResults);
+
+  // Use at least four threads, so that the search is really split.
+  omp_set_num_threads(std::max(prevNumThreads, (size_t) 4));
+  DualTreeBoruvka<> dtb(inputData);
+  arma::mat results;
+  dtb.ComputeMST(results);
+
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(inputData);
+  arma::mat coverResults;
+  ct.ComputeMST(coverResults);
+
+  DualTreeBoruvka<> naive(inputData, true);
+  arma::mat naiveResults;
+  naive.ComputeMST(naiveResults);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(results.n_cols, serialResults.n_cols);
+  BOOST_REQUIRE_EQUAL(coverResults.n_cols, serialResults.n_cols);
+  BOOST_REQUIRE_EQUAL(naiveResults.n_cols, serialResults.n_cols);
+  for (size_t i = 0; i < serialResults.n_cols; i++)
+  {
+    BOOST_REQUIRE_EQUAL(results(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(results(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(results(2, i), serialResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(coverResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(coverResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(coverResults(2, i), serialResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(naiveResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(naiveResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(naiveResults(2, i), serialResults(2, i), 1e-5);
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -410,6 +410,51 @@ BOOST_AUTO_TEST_CASE(DropConnectNetworkTest)
       (dataset, labels, dataset, labels, 2, 10, 50, 0.2);
 }
 
+/**
+ * Make sure that passing a batch of points through the network at once gives
+ * the same objective and gradient as the sum over the individual points.
+ */
+BOOST_AUTO_TEST_CASE(FFNBatchGradientTest)
+{
+  arma::mat input = arma::randu(10, 32);
+  arma::mat target = arma::zeros(1, 32);
+  for (size_t i = 0; i < target.n_elem; ++i)
+    target(i) = math::RandInt(1, 4);
+
+  FFN<NegativeLogLikelihood<> > model(input, target);
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  const double batchObjective = model.Evaluate(model.Parameters(), 4, 16,
+      true);
+  arma::mat batchGradient;
+  model.Gradient(model.Parameters(), 4, 16, batchGradient);
+
+  double objective = 0;
+  arma::mat gradient = arma::zeros(batchGradient.n_rows,
+      batchGradient.n_cols);
+  for (size_t i = 4; i < 20; ++i)
+  {
+    objective += model.Evaluate(model.Parameters(), i, true);
+
+    arma::mat pointGradient;
+    model.Gradient(model.Parameters(), i, pointGradient);
+    gradient += pointGradient;
+  }
+
+  BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (std::abs(gradient[i]) < 1e-8)
+      BOOST_REQUIRE_SMALL(batchGradient[i], 1e-8);
+    else
+      BOOST_REQUIRE_CLOSE(batchGradient[i], gradient[i], 1e-5);
+  }
+}
+
 /**
  * Test miscellaneous things of FFN,
  * e.g. copy/move constructor, assignment operator.
@@ -209,6 +209,65 @@ BOOST_AUTO_TEST_CASE(GMMTrainEMMultipleGaussians)
   }
 }
 
+/**
+ * Make sure that the EM algorithm gives the same model with any number of
+ * threads, for data that spans several blocks of the E-step.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainEMParallelTest)
+{
+  arma::mat data(3, 5000);
+  data.cols(0, 2999) = arma::randn<arma::mat>(3, 3000);
+  data.cols(3000, 4999) = 2 * arma::randn<arma::mat>(3, 2000) +
+      arma::vec("6 -4 3") * arma::ones<arma::rowvec>(2000);
+  const arma::vec probabilities = arma::randu<arma::vec>(5000);
+
+  std::vector<distribution::GaussianDistribution> initialDists;
+  initialDists.push_back(distribution::GaussianDistribution("1 0 0",
+      "2 0 0; 0 2 0; 0 0 2"));
+  initialDists.push_back(distribution::GaussianDistribution("4 -3 2",
+      "2 0 0; 0 2 0; 0 0 2"));
+  const arma::vec initialWeights("0.5 0.5");
+
+  for (size_t weighted = 0; weighted < 2; ++weighted)
+  {
+    EMFit<> em(50, 1e-10);
+    std::vector<distribution::GaussianDistribution> dists(initialDists);
+    std::vector<distribution::GaussianDistribution> serialDists(initialDists);
+    arma::vec weights(initialWeights);
+    arma::vec serialWeights(initialWeights);
+
+    if (weighted)
+      em.Estimate(data, probabilities, dists, weights, true);
+    else
+      em.Estimate(data, dists, weights, true);
+
+#ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    if (weighted)
+      em.Estimate(data, probabilities, serialDists, serialWeights, true);
+    else
+      em.Estimate(data, serialDists, serialWeights, true);
+#ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+#endif
+
+    CheckMatrices(weights, serialWeights, 1e-5);
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      CheckMatrices(dists[i].Mean(), serialDists[i].Mean(), 1e-5);
+      CheckMatrices(dists[i].Covariance(), serialDists[i].Covariance(), 1e-5);
+    }
+
+    // The model should also have found the two Gaussians.
+    const size_t second = (dists[0].Mean()[0] < dists[1].Mean()[0]) ? 1 : 0;
+    BOOST_REQUIRE_CLOSE(dists[second].Mean()[0], 6.0, 5.0);
+    BOOST_REQUIRE_CLOSE(dists[second].Mean()[1], -4.0, 5.0);
+    BOOST_REQUIRE_CLOSE(dists[second].Mean()[2], 3.0, 5.0);
+  }
+}
+
 /**
  * Train a single-gaussian mixture, but using the overload of Train() where
  * probabilities of the observation are given.
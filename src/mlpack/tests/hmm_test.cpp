@@ -214,6 +214,58 @@ BOOST_AUTO_TEST_CASE(SimpleBaumWelchDiscreteHMM)
   BOOST_REQUIRE_CLOSE(hmm.Initial()[0], 1.0, 1e-5);
 }
 
+/**
+ * Baum-Welch training on many sequences (which runs the E-step on several
+ * sequences at once) should give the same model as training with one thread.
+ */
+BOOST_AUTO_TEST_CASE(BaumWelchManySequencesTest)
+{
+  HMM<DiscreteDistribution> trueHmm(3, DiscreteDistribution(4));
+  trueHmm.Initial() = "0.5 0.3 0.2";
+  trueHmm.Transition() = arma::mat("0.7 0.2 0.1; 0.2 0.6 0.2; 0.1 0.2 0.7");
+  trueHmm.Emission()[0].Probabilities() = "0.6 0.2 0.1 0.1";
+  trueHmm.Emission()[1].Probabilities() = "0.1 0.6 0.2 0.1";
+  trueHmm.Emission()[2].Probabilities() = "0.1 0.1 0.2 0.6";
+
+  std::vector<arma::mat> observations(300);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHmm.Generate(20 + (i % 13), observations[i], states);
+  }
+
+  HMM<DiscreteDistribution> hmm(3, DiscreteDistribution(4));
+  hmm.Transition() = arma::mat("0.5 0.3 0.2; 0.3 0.4 0.3; 0.2 0.3 0.5");
+  hmm.Emission()[0].Probabilities() = "0.4 0.3 0.2 0.1";
+  hmm.Emission()[1].Probabilities() = "0.25 0.25 0.25 0.25";
+  hmm.Emission()[2].Probabilities() = "0.1 0.2 0.3 0.4";
+  HMM<DiscreteDistribution> serialHmm(hmm);
+
+  hmm.Train(observations);
+
+#ifdef HAS_OPENMP
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  serialHmm.Train(observations);
+  omp_set_num_threads(prevNumThreads);
+#else
+  serialHmm.Train(observations);
+#endif
+
+  for (size_t i = 0; i < hmm.Transition().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(hmm.Transition()[i], serialHmm.Transition()[i], 1e-3);
+  for (size_t i = 0; i < hmm.Initial().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(hmm.Initial()[i], serialHmm.Initial()[i], 1e-3);
+  for (size_t s = 0; s < 3; ++s)
+  {
+    for (size_t j = 0; j < 4; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(hmm.Emission()[s].Probabilities()[j],
+          serialHmm.Emission()[s].Probabilities()[j], 1e-3);
+    }
+  }
+}
+
 /**
  * Increasing complexity, but still simple; 4 emissions, 2 states; the state can
  * be determined directly by the emission.
@@ -596,6 +648,44 @@ BOOST_AUTO_TEST_CASE(GaussianHMMSimpleTest)
   }
 }
 
+/**
+ * Make sure that observations whose probability is too small to be represented
+ * as a double don't break the forward-backward algorithm or Viterbi decoding.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMUnderflowTest)
+{
+  // Both states emit the same distribution, so the log-likelihood of any
+  // sequence is the sum of the log-probabilities of its observations.
+  GaussianDistribution g("0.0", "1.0");
+  std::vector<GaussianDistribution> emission(2, g);
+  HMM<GaussianDistribution> hmm(arma::vec("0.3 0.7"),
+      arma::mat("0.9 0.2; 0.1 0.8"), emission);
+
+  // The probability of each of these observations underflows (exp(-800)).
+  arma::mat observations(1, 5000);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    observations[i] = (i % 2 == 0) ? 40.0 : -40.0;
+
+  arma::vec logProbabilities;
+  g.LogProbability(observations, logProbabilities);
+  const double expected = arma::accu(logProbabilities);
+
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(observations), expected, 1e-5);
+
+  arma::mat stateProb;
+  BOOST_REQUIRE_CLOSE(hmm.Estimate(observations, stateProb), expected, 1e-5);
+
+  // The emissions carry no information, so the state probabilities are those
+  // of the Markov chain, and each column must sum to one.
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(stateProb.col(i)), 1.0, 1e-5);
+
+  arma::Row<size_t> stateSeq;
+  const double logViterbi = hmm.Predict(observations, stateSeq);
+  BOOST_REQUIRE(std::isfinite(logViterbi));
+  BOOST_REQUIRE_LE(logViterbi, expected);
+}
+
 /**
  * Ensure that Gaussian HMMs can be trained properly, for the labeled training
  * case and also for the unlabeled training case.
@@ -19,7 +19,9 @@
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
+#include <mlpack/core/kernels/evaluate_block.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -609,4 +611,66 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Make sure that the kernel matrix computed by EvaluateBlock() is the same as
+ * the one computed with one kernel evaluation at a time, both for two
+ * different sets of points and for one set of points with itself.
+ */
+template<typename KernelType>
+void CheckEvaluateBlock(KernelType& kernel)
+{
+  arma::mat a(5, 40, arma::fill::randn);
+  arma::mat b(5, 30, arma::fill::randn);
+  // Make sure some points are the same.
+  b.col(3) = a.col(7);
+
+  arma::mat kernelMatrix;
+  EvaluateBlock(kernel, a, b, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      BOOST_REQUIRE_SMALL(kernelMatrix(i, j) -
+          kernel.Evaluate(a.col(i), b.col(j)), 1e-8);
+
+  EvaluateBlock(kernel, a, a, kernelMatrix);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, a.n_cols);
+  for (size_t j = 0; j < a.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      BOOST_REQUIRE_SMALL(kernelMatrix(i, j) -
+          kernel.Evaluate(a.col(i), a.col(j)), 1e-8);
+}
+
+/**
+ * Test that block evaluation gives the same results as single evaluations, for
+ * the kernels that implement EvaluateBlock() and for a kernel that doesn't.
+ */
+BOOST_AUTO_TEST_CASE(EvaluateBlockTest)
+{
+  BOOST_REQUIRE(HasEvaluateBlock<GaussianKernel>::value);
+  BOOST_REQUIRE(HasEvaluateBlock<LinearKernel>::value);
+  BOOST_REQUIRE(HasEvaluateBlock<CosineDistance>::value);
+  BOOST_REQUIRE(!HasEvaluateBlock<SphericalKernel>::value);
+
+  GaussianKernel gk(1.5);
+  CheckEvaluateBlock(gk);
+  LinearKernel lk;
+  CheckEvaluateBlock(lk);
+  PolynomialKernel pk(3.0, 1.0);
+  CheckEvaluateBlock(pk);
+  LaplacianKernel lpk(2.0);
+  CheckEvaluateBlock(lpk);
+  EpanechnikovKernel ek(3.0);
+  CheckEvaluateBlock(ek);
+  TriangularKernel tk(3.0);
+  CheckEvaluateBlock(tk);
+  HyperbolicTangentKernel hk(0.5, 1.0);
+  CheckEvaluateBlock(hk);
+  CosineDistance cd;
+  CheckEvaluateBlock(cd);
+  SphericalKernel sk(2.0);
+  CheckEvaluateBlock(sk);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -670,6 +670,63 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+/**
+ * Make sure that the blocked (and possibly parallel) Euclidean assignment step
+ * of the naive k-means iteration gives the same result as the brute-force
+ * computation, for a dataset spanning several blocks.
+ */
+BOOST_AUTO_TEST_CASE(NaiveKMeansBlockedIterateTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(7, 3500);
+  arma::mat centroids = arma::randu<arma::mat>(7, 12);
+
+  // Compute the new centroids by brute force.
+  arma::mat trueCentroids(centroids.n_rows, centroids.n_cols,
+      arma::fill::zeros);
+  arma::Col<size_t> trueCounts(centroids.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    double minDistance = DBL_MAX;
+    size_t closestCluster = centroids.n_cols;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = EuclideanDistance::Evaluate(dataset.col(i),
+          centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    trueCentroids.col(closestCluster) += dataset.col(i);
+    trueCounts[closestCluster]++;
+  }
+
+  EuclideanDistance metric;
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  naive.Iterate(centroids, newCentroids, counts);
+
+  BOOST_REQUIRE_EQUAL(naive.DistanceCalculations(),
+      dataset.n_cols * centroids.n_cols + centroids.n_cols);
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(counts[j], trueCounts[j]);
+    if (trueCounts[j] > 0)
+      trueCentroids.col(j) /= trueCounts[j];
+  }
+
+  for (size_t i = 0; i < newCentroids.n_elem; ++i)
+  {
+    if (std::abs(trueCentroids[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(newCentroids[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(newCentroids[i], trueCentroids[i], 1e-5);
+  }
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -12,6 +12,7 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/ns_server.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
@@ -721,6 +722,60 @@ BOOST_AUTO_TEST_CASE(DualTreeVsNaive2)
   }
 }
 
+/**
+ * Test the parallel dual-tree traverser with the naive method, both with a
+ * query set and in the monochromatic setting.
+ *
+ * Errors are produced if the results are not identical.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      KDTree, KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat>::ParallelDualTreeTraverser> ParallelKNN;
+
+  ParallelKNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  knn.Search(querySet, 10, neighborsTree, distancesTree);
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+
+  // The work done by the copies of the rules must be counted.
+  BOOST_REQUIRE_GT(knn.BaseCases(), 0);
+  BOOST_REQUIRE_GT(knn.Scores(), 0);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+
+  // The counts are accumulated over searches.
+  const size_t baseCases = knn.BaseCases();
+  const size_t scores = knn.Scores();
+
+  knn.Search(10, neighborsTree, distancesTree);
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  BOOST_REQUIRE_GT(knn.BaseCases(), baseCases);
+  BOOST_REQUIRE_GT(knn.Scores(), scores);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
 /**
  * Test the single-tree nearest-neighbors method with the naive method.  This
  * uses only a reference dataset.
@@ -1436,4 +1491,83 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   CheckMatrices(distances, distances2);
 }
 
+/**
+ * Make sure that batches of queries answered by ServeQueries() give the same
+ * results as regular searches, and that malformed batches are reported without
+ * stopping the server.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelServerTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(3, 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 4, baselineNeighbors, baselineDistances);
+
+  KNNModel model(KNNModel::TreeTypes::KD_TREE, false);
+  arma::mat referenceCopy(referenceData);
+  model.BuildModel(std::move(referenceCopy), 20, DUAL_TREE_MODE);
+
+  // Split the queries into two batches, with a malformed batch between them.
+  // Anything after "quit" must be ignored.
+  std::ostringstream input;
+  input.precision(17);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    input << queryData(0, i) << "," << queryData(1, i) << " " << queryData(2, i)
+        << "\n";
+    if (i == 29)
+      input << "\n0.5,0.5\n\n";
+  }
+  input << "\nquit\n1,2,3\n";
+
+  std::istringstream inputStream(input.str());
+  std::stringstream outputStream;
+  bool quit = false;
+  const size_t batches = ServeQueries(model, 4, inputStream, outputStream,
+      &quit);
+
+  BOOST_REQUIRE_EQUAL(batches, 2);
+  BOOST_REQUIRE_EQUAL(quit, true);
+
+  std::string line;
+  size_t point = 0;
+  size_t errors = 0;
+  while (std::getline(outputStream, line))
+  {
+    if (line.empty())
+      continue;
+
+    if (line.compare(0, 7, "error: ") == 0)
+    {
+      BOOST_REQUIRE_EQUAL(point, 30);
+      ++errors;
+      continue;
+    }
+
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream stream(line);
+    for (size_t j = 0; j < 4; ++j)
+    {
+      size_t neighbor;
+      stream >> neighbor;
+      BOOST_REQUIRE_EQUAL(neighbor, baselineNeighbors(j, point));
+    }
+    for (size_t j = 0; j < 4; ++j)
+    {
+      double distance;
+      stream >> distance;
+      BOOST_REQUIRE_CLOSE(distance, baselineDistances(j, point), 1e-5);
+    }
+    ++point;
+  }
+
+  BOOST_REQUIRE_EQUAL(point, queryData.n_cols);
+  BOOST_REQUIRE_EQUAL(errors, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -572,6 +572,39 @@ BOOST_AUTO_TEST_CASE(SaveArmaBinaryTest)
   remove("test_file.bin");
 }
 
+/**
+ * Make sure the Armadillo binary headers are generated like Armadillo does, and
+ * that Armadillo can load the files we save.
+ */
+BOOST_AUTO_TEST_CASE(ArmaBinaryHeaderTest)
+{
+  BOOST_REQUIRE_EQUAL(data::ArmaBinaryHeader<double>(), "ARMA_MAT_BIN_FN008");
+  BOOST_REQUIRE_EQUAL(data::ArmaBinaryHeader<float>(), "ARMA_MAT_BIN_FN004");
+  BOOST_REQUIRE_EQUAL(data::ArmaBinaryHeader<unsigned char>(),
+      "ARMA_MAT_BIN_IU001");
+  BOOST_REQUIRE_EQUAL(data::ArmaBinaryHeader<int>(), "ARMA_MAT_BIN_IS004");
+  BOOST_REQUIRE_EQUAL(data::ArmaBinaryHeader<uint64_t>(),
+      "ARMA_MAT_BIN_IU008");
+  BOOST_REQUIRE_EQUAL(data::ArmaBinaryHeader<std::complex<double>>(),
+      "ARMA_MAT_BIN_FC016");
+  BOOST_REQUIRE_EQUAL(data::ArmaBinaryHeader<bool>(), "");
+
+  arma::Mat<size_t> test = arma::randi<arma::Mat<size_t>>(5, 9,
+      arma::distr_param(0, 1000));
+  BOOST_REQUIRE(data::Save("test_file.bin", test, true, false) == true);
+
+  arma::Mat<size_t> armaTest;
+  BOOST_REQUIRE(armaTest.quiet_load("test_file.bin", arma::arma_binary));
+
+  BOOST_REQUIRE_EQUAL(armaTest.n_rows, test.n_rows);
+  BOOST_REQUIRE_EQUAL(armaTest.n_cols, test.n_cols);
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(armaTest[i], test[i]);
+
+  // Remove the file.
+  remove("test_file.bin");
+}
+
 /**
  * Make sure raw_binary is loaded correctly.
  */
@@ -599,6 +632,73 @@ BOOST_AUTO_TEST_CASE(LoadRawBinaryTest)
   remove("test_file.bin");
 }
 
+/**
+ * Make sure that a saved Armadillo binary file can be mapped into memory
+ * without transposing it.
+ */
+BOOST_AUTO_TEST_CASE(LoadMappedArmaBinaryTest)
+{
+  arma::mat test(7, 13, arma::fill::randu);
+
+  BOOST_REQUIRE(data::Save("test_file.bin", test, true, false) == true);
+
+  {
+    data::MappedMatrix<double> mapped;
+    BOOST_REQUIRE(data::Load("test_file.bin", mapped) == true);
+
+#ifndef _WIN32
+    BOOST_REQUIRE(mapped.IsMapped());
+#endif
+
+    BOOST_REQUIRE_EQUAL(mapped.Matrix().n_rows, 7);
+    BOOST_REQUIRE_EQUAL(mapped.Matrix().n_cols, 13);
+    for (size_t i = 0; i < test.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(mapped.Matrix()[i], test[i]);
+
+    // Changing the matrix must not change the file.
+    mapped.Matrix()[0] = -1.0;
+  }
+
+  // The file must still be readable by the regular loader.
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test_file.bin", loaded, true, false) == true);
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, 7);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, 13);
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(loaded[i], test[i]);
+
+  // Remove the file.
+  remove("test_file.bin");
+}
+
+/**
+ * Make sure that a raw binary file can be mapped into memory with the given
+ * number of rows.
+ */
+BOOST_AUTO_TEST_CASE(LoadMappedRawBinaryTest)
+{
+  arma::mat test(4, 6, arma::fill::randu);
+  BOOST_REQUIRE(test.quiet_save("test_file.bin", arma::raw_binary) == true);
+
+  data::MappedMatrix<double> mapped;
+  BOOST_REQUIRE(data::Load("test_file.bin", mapped, false, 4) == true);
+
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_rows, 4);
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_cols, 6);
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(mapped.Matrix()[i], test[i]);
+
+  // The file can't hold a matrix with 5 rows.
+  BOOST_REQUIRE(data::Load("test_file.bin", mapped, false, 5) == false);
+
+  mapped.Clear();
+  BOOST_REQUIRE(!mapped.IsMapped());
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_elem, 0);
+
+  // Remove the file.
+  remove("test_file.bin");
+}
+
 /**
  * Make sure load as PGM is successful.
  */
@@ -1993,4 +2093,61 @@ BOOST_AUTO_TEST_CASE(LoadCSVNoTransposeTXTTest)
 }
 
 
+/**
+ * Test that a CSV that is large enough to be split into several chunks is
+ * loaded correctly, both transposed and non-transposed, and that categorical
+ * values are mapped in the order in which they appear.
+ */
+BOOST_AUTO_TEST_CASE(LoadLargeCSVChunksTest)
+{
+  arma::mat data(4, 150000, arma::fill::randu);
+
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f.precision(17);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t j = 0; j < data.n_rows; ++j)
+      f << data(j, i) << ", ";
+    f << "c" << (i % 7) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv", dataset, info, true));
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 150000);
+  for (size_t d = 0; d < 4; ++d)
+    BOOST_REQUIRE(info.Type(d) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(4) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(4), 7);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 4; ++j)
+      BOOST_REQUIRE_CLOSE(dataset(j, i), data(j, i), 1e-10);
+    BOOST_REQUIRE_EQUAL(dataset(4, i), (double) (i % 7));
+  }
+
+  // Now load it without transposing; the last line is categorical.
+  arma::mat nontransposed;
+  DatasetInfo nontransposedInfo;
+  BOOST_REQUIRE(data::Load("test.csv", nontransposed, nontransposedInfo, true,
+      false));
+
+  BOOST_REQUIRE_EQUAL(nontransposed.n_rows, 150000);
+  BOOST_REQUIRE_EQUAL(nontransposed.n_cols, 5);
+  BOOST_REQUIRE(nontransposedInfo.Type(0) == Datatype::categorical);
+  for (size_t i = 0; i < nontransposed.n_rows; ++i)
+  {
+    // Every value on each line is different, so they are mapped in order.
+    for (size_t j = 0; j < 5; ++j)
+      BOOST_REQUIRE_EQUAL(nontransposed(i, j), (double) j);
+  }
+
+  remove("test.csv");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
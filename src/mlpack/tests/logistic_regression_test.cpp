@@ -410,6 +410,35 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationGradient)
   }
 }
 
+/**
+ * Make sure the sparse separable gradient matches the dense separable gradient
+ * when the point has no zero features.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSparseSeparableGradient)
+{
+  arma::mat data(10, 50, arma::fill::randu);
+  data += 0.1;
+  arma::Row<size_t> responses(50);
+  for (size_t i = 0; i < 50; ++i)
+    responses[i] = i % 2;
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.7);
+  arma::mat parameters(11, 1, arma::fill::randn);
+
+  arma::mat gradient;
+  arma::sp_mat sparseGradient;
+  for (size_t i = 0; i < 50; ++i)
+  {
+    lrf.Gradient(parameters, i, gradient);
+    lrf.Gradient(parameters, i, sparseGradient);
+
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, gradient.n_rows);
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, gradient.n_cols);
+    for (size_t j = 0; j < gradient.n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(sparseGradient(j, 0), gradient[j], 1e-5);
+  }
+}
+
 /**
  * Test separable Gradient() function when regularization is used.
  */
@@ -963,4 +992,74 @@ BOOST_AUTO_TEST_CASE(ClassifyProbabilitiesTest)
   }
 }
 
+/**
+ * Make sure that prediction and error computation on sparse data give the same
+ * results as on the same data stored densely.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionSparsePredictionTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(10, 800, 0.3);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = (denseDataset(0, i) + denseDataset(1, i) > 0.3) ? 1 : 0;
+
+  LogisticRegression<> lr(denseDataset, labels, 0.3);
+  LogisticRegression<arma::sp_mat> lrSparse(dataset.n_rows, 0.3);
+  lrSparse.Parameters() = lr.Parameters();
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  lr.Classify(denseDataset, predictions);
+  lrSparse.Classify(dataset, sparsePredictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, sparsePredictions.n_elem);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], sparsePredictions[i]);
+    BOOST_REQUIRE_EQUAL(lrSparse.Classify(dataset.col(i)), predictions[i]);
+  }
+
+  arma::mat probabilities, sparseProbabilities;
+  lr.Classify(denseDataset, probabilities);
+  lrSparse.Classify(dataset, sparseProbabilities);
+  BOOST_REQUIRE_EQUAL(sparseProbabilities.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(sparseProbabilities.n_cols, dataset.n_cols);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(probabilities[i], sparseProbabilities[i], 1e-5);
+
+  BOOST_REQUIRE_CLOSE(lr.ComputeError(denseDataset, labels),
+      lrSparse.ComputeError(dataset, labels), 1e-5);
+  BOOST_REQUIRE_CLOSE(lr.ComputeAccuracy(denseDataset, labels),
+      lrSparse.ComputeAccuracy(dataset, labels), 1e-5);
+}
+
+/**
+ * Train on a sparse dataset with many more dimensions than could be stored
+ * densely.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionHighDimensionalSparseTest)
+{
+  // Each point has two nonzero features out of 200000: one that determines
+  // its label, and one that is noise.
+  const size_t dimensions = 200000;
+  const size_t points = 2000;
+  arma::umat locations(2, 2 * points);
+  arma::vec values(2 * points, arma::fill::ones);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % 2;
+    locations(0, 2 * i) = labels[i];
+    locations(1, 2 * i) = i;
+    locations(0, 2 * i + 1) = math::RandInt(2, dimensions);
+    locations(1, 2 * i + 1) = i;
+  }
+  const arma::sp_mat dataset(locations, values, dimensions, points);
+
+  LogisticRegression<arma::sp_mat> lr(dataset, labels, 0.01);
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, dimensions + 1);
+  BOOST_REQUIRE_CLOSE(lr.ComputeAccuracy(dataset, labels), 100.0, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -640,6 +640,126 @@ BOOST_AUTO_TEST_CASE(LSHTrainTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+/**
+ * Test: with a second hash table of size 1, every point of every table must be
+ * in the single bucket, in the order it was inserted (table by table).  Enough
+ * points are used that the table is built from several blocks of points.
+ */
+BOOST_AUTO_TEST_CASE(BucketOrderTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 10000);
+  LSHSearch<> lsh(referenceData, 5, 3, 1.0, 1, 0);
+
+  BOOST_REQUIRE_EQUAL(lsh.BucketOffsets().n_elem, 2);
+  BOOST_REQUIRE_EQUAL(lsh.BucketOffsets()[0], 0);
+  BOOST_REQUIRE_EQUAL(lsh.BucketOffsets()[1], 30000);
+  BOOST_REQUIRE_EQUAL(lsh.BucketContents().n_elem, 30000);
+  for (size_t i = 0; i < lsh.BucketContents().n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(lsh.BucketContents()[i], i % 10000);
+}
+
+/**
+ * Test: without a bucket size limit, every point must be stored once for each
+ * table; with a limit, no bucket may hold more points than the limit.
+ */
+BOOST_AUTO_TEST_CASE(BucketSizeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 2000);
+
+  LSHSearch<> lsh(referenceData, 3, 4, 0.5, 7, 0);
+  BOOST_REQUIRE_EQUAL(lsh.BucketOffsets().n_elem, 8);
+  BOOST_REQUIRE_EQUAL(lsh.BucketContents().n_elem, 8000);
+
+  arma::Col<size_t> counts(2000, arma::fill::zeros);
+  for (size_t i = 0; i < lsh.BucketContents().n_elem; ++i)
+    ++counts[lsh.BucketContents()[i]];
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 4);
+
+  LSHSearch<> smallLsh(referenceData, 3, 4, 0.5, 7, 50);
+  BOOST_REQUIRE_EQUAL(smallLsh.BucketOffsets().n_elem, 8);
+  BOOST_REQUIRE_LE(smallLsh.BucketContents().n_elem, 7 * 50);
+  for (size_t h = 0; h < 7; ++h)
+  {
+    BOOST_REQUIRE_LE(smallLsh.BucketOffsets()[h],
+        smallLsh.BucketOffsets()[h + 1]);
+    BOOST_REQUIRE_LE(smallLsh.BucketOffsets()[h + 1] -
+        smallLsh.BucketOffsets()[h], 50);
+  }
+  BOOST_REQUIRE_EQUAL(smallLsh.BucketOffsets()[7],
+      smallLsh.BucketContents().n_elem);
+}
+
+/**
+ * Test: training on part of a dataset and inserting the rest must give the
+ * same buckets (up to the order of the points in each bucket) and the same
+ * search results as training on the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(InsertTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 100);
+  arma::cube projections = arma::randn<arma::cube>(5, 4, 6);
+
+  // The offsets and second hash weights are random, so use the same seed for
+  // both models.
+  math::RandomSeed(42);
+  LSHSearch<> lsh(referenceData, projections, 0.5, 997, 0);
+
+  // The model only keeps a reference to the points it is trained on.
+  arma::mat firstPoints = referenceData.cols(0, 1999);
+  math::RandomSeed(42);
+  LSHSearch<> insertLsh(firstPoints, projections, 0.5, 997, 0);
+  insertLsh.Insert(referenceData.cols(2000, 2499));
+  insertLsh.Insert(referenceData.cols(2500, 2999));
+  math::RandomSeed(std::time(NULL));
+
+  CheckMatrices(lsh.ReferenceSet(), insertLsh.ReferenceSet());
+  CheckMatrices(lsh.BucketOffsets(), insertLsh.BucketOffsets());
+  for (size_t h = 0; h < 997; ++h)
+  {
+    const size_t begin = lsh.BucketOffsets()[h];
+    const size_t end = lsh.BucketOffsets()[h + 1];
+    if (begin == end)
+      continue;
+
+    arma::Col<size_t> bucket = arma::sort(
+        lsh.BucketContents().subvec(begin, end - 1));
+    arma::Col<size_t> insertBucket = arma::sort(
+        insertLsh.BucketContents().subvec(begin, end - 1));
+    CheckMatrices(bucket, insertBucket);
+  }
+
+  arma::Mat<size_t> neighbors, insertNeighbors;
+  arma::mat distances, insertDistances;
+  lsh.Search(queryData, 3, neighbors, distances);
+  insertLsh.Search(queryData, 3, insertNeighbors, insertDistances);
+
+  CheckMatrices(neighbors, insertNeighbors);
+  CheckMatrices(distances, insertDistances);
+}
+
+/**
+ * Test: inserting into an untrained model or inserting points of the wrong
+ * dimensionality must throw an exception.
+ */
+BOOST_AUTO_TEST_CASE(InsertExceptionTest)
+{
+  LSHSearch<> lsh;
+  arma::mat dataset = arma::randu<arma::mat>(5, 50);
+  BOOST_REQUIRE_THROW(lsh.Insert(dataset), std::invalid_argument);
+
+  lsh.Train(dataset, 4, 3);
+  arma::mat newPoints = arma::randu<arma::mat>(6, 10);
+  BOOST_REQUIRE_THROW(lsh.Insert(newPoints), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(lsh.ReferenceSet().n_cols, 50);
+
+  newPoints = arma::randu<arma::mat>(5, 10);
+  lsh.Insert(newPoints);
+  BOOST_REQUIRE_EQUAL(lsh.ReferenceSet().n_cols, 60);
+  BOOST_REQUIRE_EQUAL(lsh.BucketContents().n_elem, 3 * 60);
+}
+
 /**
  * Test: this verifies ComputeRecall works correctly by providing two identical
  * vectors and requiring that Recall is equal to 1.
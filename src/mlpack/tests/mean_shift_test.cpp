@@ -145,4 +145,39 @@ BOOST_AUTO_TEST_CASE(GaussianClustering)
       BOOST_REQUIRE_NE(minIndices[i], minIndices[j]);
 }
 
+#ifdef HAS_OPENMP
+// Make sure that shifting the centroids in parallel gives the same results as
+// shifting them with one thread, when every point is used as a seed.
+BOOST_AUTO_TEST_CASE(ParallelMeanShiftTest)
+{
+  GaussianDistribution g1("0.0 0.0", arma::eye<arma::mat>(2, 2));
+  GaussianDistribution g2("6.0 6.0", arma::eye<arma::mat>(2, 2));
+
+  arma::mat dataset(2, 600);
+  for (size_t i = 0; i < 300; ++i)
+    dataset.col(i) = g1.Random();
+  for (size_t i = 300; i < 600; ++i)
+    dataset.col(i) = g2.Random();
+
+  MeanShift<true> meanShift(2.0);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  arma::Col<size_t> serialAssignments, assignments;
+  arma::mat serialCentroids, centroids;
+  omp_set_num_threads(1);
+  meanShift.Cluster(dataset, serialAssignments, serialCentroids, false);
+  omp_set_num_threads(std::max(prevNumThreads, (size_t) 4));
+  meanShift.Cluster(dataset, assignments, centroids, false);
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 2);
+  BOOST_REQUIRE_EQUAL(serialCentroids.n_cols, centroids.n_cols);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(centroids[i], serialCentroids[i], 1e-5);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], serialAssignments[i]);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -136,6 +136,64 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionTest)
   }
 }
 
+/**
+ * A wrapper around LogisticRegressionFunction that hides its batch Gradient(),
+ * so that mini-batch SGD computes the gradient one point at a time.
+ */
+class PointGradientFunction
+{
+ public:
+  PointGradientFunction(LogisticRegressionFunction<>& function) :
+      function(function) { }
+
+  size_t NumFunctions() const { return function.NumFunctions(); }
+
+  double Evaluate(const arma::mat& coordinates, const size_t i) const
+  {
+    return function.Evaluate(coordinates, i);
+  }
+
+  void Gradient(const arma::mat& coordinates,
+                const size_t i,
+                arma::mat& gradient) const
+  {
+    function.Gradient(coordinates, i, gradient);
+  }
+
+ private:
+  LogisticRegressionFunction<>& function;
+};
+
+/**
+ * Make sure that mini-batch SGD gives the same results whether the gradient of
+ * each batch is computed with one call or one point at a time, including for
+ * a smaller last batch.
+ */
+BOOST_AUTO_TEST_CASE(BatchGradientTest)
+{
+  arma::mat data(4, 1003, arma::fill::randu);
+  arma::Row<size_t> responses(1003);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    responses[i] = (arma::accu(data.col(i)) > 2.0) ? 1 : 0;
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+  PointGradientFunction pgf(lrf);
+
+  MiniBatchSGD<LogisticRegressionFunction<>> batchSGD(lrf, 50, 0.1, 500,
+      1e-10, false);
+  MiniBatchSGD<PointGradientFunction> pointSGD(pgf, 50, 0.1, 500, 1e-10,
+      false);
+
+  arma::mat batchCoordinates = lrf.GetInitialPoint();
+  arma::mat pointCoordinates = lrf.GetInitialPoint();
+  const double batchResult = batchSGD.Optimize(batchCoordinates);
+  const double pointResult = pointSGD.Optimize(pointCoordinates);
+
+  BOOST_REQUIRE_CLOSE(batchResult, pointResult, 1e-5);
+  for (size_t i = 0; i < batchCoordinates.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(batchCoordinates[i], pointCoordinates[i], 1e-5);
+}
+
 /**
  * Run mini-batch SGD on a simple test function and make sure the last batch
  * size is handled correctly.
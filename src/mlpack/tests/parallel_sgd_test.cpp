@@ -0,0 +1,235 @@
+/**
+ * @file parallel_sgd_test.cpp
+ * @author Ryan Curtin
+ *
+ * Test file for parallel SGD without locks (Hogwild!).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+using namespace mlpack::distribution;
+using namespace mlpack::svd;
+
+BOOST_AUTO_TEST_SUITE(ParallelSGDTest);
+
+/**
+ * A least squares function that only provides dense gradients:
+ * f_i(w) = (x_i^T w - y_i)^2.
+ */
+class LeastSquaresFunction
+{
+ public:
+  LeastSquaresFunction(const arma::mat& predictors,
+                       const arma::rowvec& responses) :
+      predictors(predictors), responses(responses) { }
+
+  size_t NumFunctions() const { return predictors.n_cols; }
+
+  double Evaluate(const arma::mat& coordinates, const size_t i) const
+  {
+    const double error = arma::dot(predictors.col(i), coordinates) -
+        responses[i];
+    return error * error;
+  }
+
+  void Gradient(const arma::mat& coordinates,
+                const size_t i,
+                arma::mat& gradient) const
+  {
+    const double error = arma::dot(predictors.col(i), coordinates) -
+        responses[i];
+    gradient = 2 * error * predictors.col(i);
+  }
+
+ private:
+  const arma::mat& predictors;
+  const arma::rowvec& responses;
+};
+
+/**
+ * Make sure the step size decay policies give the right step sizes.
+ */
+BOOST_AUTO_TEST_CASE(DecayPolicyTest)
+{
+  ConstantStep constant;
+  BOOST_REQUIRE_CLOSE(constant.StepSize(0.5, 0), 0.5, 1e-10);
+  BOOST_REQUIRE_CLOSE(constant.StepSize(0.5, 10), 0.5, 1e-10);
+
+  ExponentialDecay decay(0.5);
+  BOOST_REQUIRE_CLOSE(decay.StepSize(0.8, 0), 0.8, 1e-10);
+  BOOST_REQUIRE_CLOSE(decay.StepSize(0.8, 1), 0.4, 1e-10);
+  BOOST_REQUIRE_CLOSE(decay.StepSize(0.8, 3), 0.1, 1e-10);
+}
+
+/**
+ * Solve a least squares problem with a function that only has dense
+ * gradients.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSGDDenseGradientTest)
+{
+  arma::mat predictors(5, 2000, arma::fill::randu);
+  const arma::vec weights("1.0 -2.0 0.5 3.0 -1.5");
+  const arma::rowvec responses = weights.t() * predictors;
+
+  LeastSquaresFunction f(predictors, responses);
+  ParallelSGD<LeastSquaresFunction> s(f, 0.01, 200, 1e-12);
+
+  arma::mat coordinates = arma::zeros<arma::mat>(5, 1);
+  const double result = s.Optimize(coordinates);
+
+  BOOST_REQUIRE_SMALL(result, 1e-3);
+  for (size_t i = 0; i < 5; ++i)
+    BOOST_REQUIRE_SMALL(coordinates[i] - weights[i], 1e-2);
+}
+
+/**
+ * Make sure that the sparse gradient is only used for functions that should use
+ * it.
+ */
+BOOST_AUTO_TEST_CASE(SparseGradientTraitsTest)
+{
+  BOOST_REQUIRE(!SparseGradientTraits<LeastSquaresFunction>::UseSparseGradient);
+  BOOST_REQUIRE(
+      SparseGradientTraits<RegularizedSVDFunction>::UseSparseGradient);
+
+  // Logistic regression only uses its sparse gradient on sparse data, since it
+  // regularizes differently from the dense gradient.
+  BOOST_REQUIRE(HasSparseGradient<LogisticRegressionFunction<>>::value);
+  BOOST_REQUIRE(!SparseGradientTraits<
+      LogisticRegressionFunction<>>::UseSparseGradient);
+  BOOST_REQUIRE(SparseGradientTraits<
+      LogisticRegressionFunction<arma::sp_mat>>::UseSparseGradient);
+}
+
+/**
+ * Train logistic regression on a two-Gaussian dataset.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSGDLogisticRegressionTest)
+{
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = g2.Random();
+    responses[i] = 1;
+  }
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+  ParallelSGD<LogisticRegressionFunction<>, ExponentialDecay> psgd(lrf, 0.01,
+      50, 1e-5, true, ExponentialDecay(0.95));
+
+  LogisticRegression<> lr(data.n_rows, 0.5);
+  lr.Train(psgd);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+}
+
+/**
+ * With one thread and without shuffling, parallel SGD on dense logistic
+ * regression should take exactly the same steps as SGD.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSGDDenseLogisticRegressionMatchesSGDTest)
+{
+  arma::mat data(4, 300, arma::fill::randn);
+  // Make some features zero, where the sparse gradient would regularize
+  // differently.
+  data.row(2).subvec(0, 149).zeros();
+  arma::Row<size_t> responses(300);
+  for (size_t i = 0; i < 300; ++i)
+    responses[i] = (data(0, i) + data(1, i) > 0.0) ? 1 : 0;
+
+  LogisticRegressionFunction<> lrf(data, responses, 2.0);
+
+  // SGD checks its iteration count before each step, so it needs one more.
+  const size_t passes = 5;
+  StandardSGD<LogisticRegressionFunction<>> sgd(lrf, 0.05,
+      passes * data.n_cols + 1, 0.0, false);
+  ParallelSGD<LogisticRegressionFunction<>> psgd(lrf, 0.05, passes, 0.0,
+      false);
+
+  arma::mat sgdParameters(lrf.InitialPoint());
+  sgd.Optimize(sgdParameters);
+
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  arma::mat psgdParameters(lrf.InitialPoint());
+  psgd.Optimize(psgdParameters);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  BOOST_REQUIRE_EQUAL(psgdParameters.n_elem, sgdParameters.n_elem);
+  for (size_t i = 0; i < sgdParameters.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(psgdParameters[i], sgdParameters[i], 1e-5);
+}
+
+/**
+ * Optimize a regularized SVD, which provides sparse gradients.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSGDRegularizedSVDTest)
+{
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  RegularizedSVDFunction rSVDFunc(data, rank, 0.01);
+  ParallelSGD<RegularizedSVDFunction> optimizer(rSVDFunc, 0.005, 100, 1e-10);
+
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(optParameters);
+
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+  BOOST_REQUIRE_SMALL(relativeError, 1e-2);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,246 @@
+/**
+ * @file random_forest_test.cpp
+ * @author Ryan Curtin
+ *
+ * Tests for the RandomForest class and the RandomDimensionSelect policy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(RandomForestTest);
+
+/**
+ * Make sure RandomDimensionSelect selects the right number of distinct
+ * dimensions, in increasing order.
+ */
+BOOST_AUTO_TEST_CASE(RandomDimensionSelectTest)
+{
+  RandomDimensionSelect defaultSelect;
+  RandomDimensionSelect fixedSelect(4);
+
+  for (size_t trial = 0; trial < 20; ++trial)
+  {
+    std::vector<size_t> dimensions;
+
+    // The default is the (rounded) square root of the dimensionality.
+    defaultSelect.Select(30, dimensions);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 5);
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      BOOST_REQUIRE_LT(dimensions[i], 30);
+      if (i > 0)
+        BOOST_REQUIRE_LT(dimensions[i - 1], dimensions[i]);
+    }
+
+    fixedSelect.Select(10, dimensions);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 4);
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      BOOST_REQUIRE_LT(dimensions[i], 10);
+      if (i > 0)
+        BOOST_REQUIRE_LT(dimensions[i - 1], dimensions[i]);
+    }
+
+    // No more dimensions than there are can be selected.
+    fixedSelect.Select(3, dimensions);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 3);
+    for (size_t i = 0; i < 3; ++i)
+      BOOST_REQUIRE_EQUAL(dimensions[i], i);
+  }
+}
+
+/**
+ * Make sure that AllDimensionSelect selects every dimension.
+ */
+BOOST_AUTO_TEST_CASE(AllDimensionSelectTest)
+{
+  AllDimensionSelect select;
+  std::vector<size_t> dimensions;
+  select.Select(7, dimensions);
+
+  BOOST_REQUIRE_EQUAL(dimensions.size(), 7);
+  for (size_t i = 0; i < 7; ++i)
+    BOOST_REQUIRE_EQUAL(dimensions[i], i);
+}
+
+/**
+ * Test that the random forest generalizes reasonably.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  RandomForest<> rf(inputData, labels, 3, 20, 1);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 20);
+  BOOST_REQUIRE_EQUAL(rf.NumClasses(), 3);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  rf.Classify(testData, predictions, probabilities);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, testData.n_cols);
+
+  // Figure out the accuracy, and make sure the probabilities are consistent
+  // with the predictions.
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+    arma::uword maxIndex;
+    probabilities.col(i).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictions[i], (size_t) maxIndex);
+  }
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
+/**
+ * Make sure that classifying a batch of points gives the same results as
+ * classifying each point on its own.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestBatchClassifyTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  RandomForest<> rf(inputData, labels, 3, 10, 5);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  rf.Classify(inputData, predictions, probabilities);
+
+  for (size_t i = 0; i < inputData.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    rf.Classify(inputData.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(prediction, predictions[i]);
+    BOOST_REQUIRE_EQUAL(rf.Classify(inputData.col(i)), predictions[i]);
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_CLOSE(pointProbabilities[j], probabilities(j, i), 1e-5);
+  }
+}
+
+/**
+ * Make sure that training with the same random seed gives the same forest, no
+ * matter how many threads build the trees.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestDeterminismTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  math::RandomSeed(1);
+  RandomForest<> rf1(inputData, labels, 3, 10, 1);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(std::max(prevNumThreads, (size_t) 4));
+#endif
+  math::RandomSeed(1);
+  RandomForest<> rf2(inputData, labels, 3, 10, 1);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+  math::RandomSeed(std::time(NULL));
+
+  arma::Row<size_t> predictions1, predictions2;
+  arma::mat probabilities1, probabilities2;
+  rf1.Classify(inputData, predictions1, probabilities1);
+  rf2.Classify(inputData, predictions2, probabilities2);
+
+  for (size_t i = 0; i < predictions1.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions1[i], predictions2[i]);
+  for (size_t i = 0; i < probabilities1.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(probabilities1[i], probabilities2[i]);
+}
+
+/**
+ * Make sure that serialization of a random forest works.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestSerializationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  RandomForest<> rf(inputData, labels, 3, 5, 1);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  rf.Classify(inputData, predictions, probabilities);
+
+  RandomForest<> xmlForest, textForest, binaryForest;
+  SerializeObjectAll(rf, xmlForest, textForest, binaryForest);
+
+  BOOST_REQUIRE_EQUAL(xmlForest.NumTrees(), 5);
+  BOOST_REQUIRE_EQUAL(textForest.NumTrees(), 5);
+  BOOST_REQUIRE_EQUAL(binaryForest.NumTrees(), 5);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+  xmlForest.Classify(inputData, xmlPredictions, xmlProbabilities);
+  textForest.Classify(inputData, textPredictions, textProbabilities);
+  binaryForest.Classify(inputData, binaryPredictions, binaryProbabilities);
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], xmlPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], textPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], binaryPredictions[i]);
+  }
+
+  CheckMatrices(probabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -547,6 +547,75 @@ BOOST_AUTO_TEST_CASE(DualTreeVsNaive2)
   }
 }
 
+/**
+ * Test range search with the parallel dual-tree traverser against the naive
+ * method, and make sure that the work done by the copies of the rules is
+ * counted in the original rules.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+  const Range range(0.25, 0.5);
+
+  // Build the trees ourselves, since RangeSearch always uses the
+  // DualTreeTraverser.
+  typedef KDTree<EuclideanDistance, RangeSearchStat, arma::mat> TreeType;
+  vector<size_t> oldFromNewReferences, oldFromNewQueries;
+  TreeType referenceTree(dataset, oldFromNewReferences);
+  TreeType queryTree(querySet, oldFromNewQueries);
+
+  vector<vector<size_t>> neighbors(querySet.n_cols);
+  vector<vector<double>> distances(querySet.n_cols);
+  EuclideanDistance metric;
+
+  typedef RangeSearchRules<EuclideanDistance, TreeType> RuleType;
+  RuleType rules(referenceTree.Dataset(), queryTree.Dataset(), range,
+      neighbors, distances, metric);
+  TreeType::ParallelDualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, referenceTree);
+
+  BOOST_REQUIRE_GT(rules.BaseCases(), 0);
+  BOOST_REQUIRE_GT(rules.Scores(), 0);
+
+  // Map the results back to the original indices.
+  vector<vector<size_t>> neighborsTree(querySet.n_cols);
+  vector<vector<double>> distancesTree(querySet.n_cols);
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    const size_t query = oldFromNewQueries[i];
+    distancesTree[query] = distances[i];
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+      neighborsTree[query].push_back(oldFromNewReferences[neighbors[i][j]]);
+  }
+
+  vector<vector<pair<double, size_t>>> sortedTree;
+  SortResults(neighborsTree, distancesTree, sortedTree);
+
+  RangeSearch<> naive(dataset, true);
+  vector<vector<size_t>> neighborsNaive;
+  vector<vector<double>> distancesNaive;
+  naive.Search(querySet, range, neighborsNaive, distancesNaive);
+  vector<vector<pair<double, size_t>>> sortedNaive;
+  SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+  BOOST_REQUIRE_EQUAL(sortedTree.size(), sortedNaive.size());
+  for (size_t i = 0; i < sortedTree.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(sortedTree[i].size(), sortedNaive[i].size());
+
+    for (size_t j = 0; j < sortedTree[i].size(); j++)
+    {
+      BOOST_REQUIRE_EQUAL(sortedTree[i][j].second, sortedNaive[i][j].second);
+      BOOST_REQUIRE_CLOSE(sortedTree[i][j].first, sortedNaive[i][j].first,
+          1e-5);
+    }
+  }
+}
+
 /**
  * Test the single-tree range search method with the naive method.  This
  * uses only a reference dataset.
@@ -1696,4 +1765,102 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+// Make sure that the CSR results and the counts of the given RangeSearch object
+// match its regular results.
+template<typename RangeSearchType>
+void CheckCSRResults(RangeSearchType& rs,
+                     const arma::mat& querySet,
+                     const Range& range,
+                     const bool monochromatic)
+{
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  vector<size_t> offsets;
+  vector<size_t> flatNeighbors;
+  vector<double> flatDistances;
+  vector<size_t> counts;
+  if (monochromatic)
+  {
+    rs.Search(range, neighbors, distances);
+    rs.Search(range, offsets, flatNeighbors, flatDistances);
+    rs.Count(range, counts);
+  }
+  else
+  {
+    rs.Search(querySet, range, neighbors, distances);
+    rs.Search(querySet, range, offsets, flatNeighbors, flatDistances);
+    rs.Count(querySet, range, counts);
+  }
+
+  // Convert the CSR results to the regular format, so they can be compared.
+  BOOST_REQUIRE_EQUAL(offsets.size(), neighbors.size() + 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(offsets.back(), flatNeighbors.size());
+  BOOST_REQUIRE_EQUAL(flatDistances.size(), flatNeighbors.size());
+  BOOST_REQUIRE_EQUAL(counts.size(), neighbors.size());
+
+  vector<vector<size_t>> csrNeighbors(neighbors.size());
+  vector<vector<double>> csrDistances(neighbors.size());
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(counts[i], neighbors[i].size());
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+    {
+      csrNeighbors[i].push_back(flatNeighbors[j]);
+      csrDistances[i].push_back(flatDistances[j]);
+    }
+  }
+
+  vector<vector<pair<double, size_t>>> sortedOut;
+  vector<vector<pair<double, size_t>>> csrSortedOut;
+  SortResults(neighbors, distances, sortedOut);
+  SortResults(csrNeighbors, csrDistances, csrSortedOut);
+
+  for (size_t i = 0; i < sortedOut.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(csrSortedOut[i].size(), sortedOut[i].size());
+    for (size_t j = 0; j < sortedOut[i].size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(csrSortedOut[i][j].second, sortedOut[i][j].second);
+      BOOST_REQUIRE_CLOSE(csrSortedOut[i][j].first, sortedOut[i][j].first,
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Ensure that the CSR results and the counts are the same as the regular
+ * results, for every search mode, with kd-trees and cover trees.
+ */
+BOOST_AUTO_TEST_CASE(CSRAndCountTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+  const Range range(0.1, 0.3);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    const bool naive = (mode == 0);
+    const bool singleMode = (mode == 1);
+
+    RangeSearch<> kdrs(referenceSet, naive, singleMode);
+    CheckCSRResults(kdrs, querySet, range, false);
+    CheckCSRResults(kdrs, querySet, range, true);
+
+    RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> ctrs(
+        referenceSet, naive, singleMode);
+    CheckCSRResults(ctrs, querySet, range, false);
+    CheckCSRResults(ctrs, querySet, range, true);
+  }
+
+  // The whole set is in range of every point, so nodes are counted without
+  // calculating distances.
+  RangeSearch<> rs(referenceSet);
+  vector<size_t> counts;
+  rs.Count(Range(0.0, DBL_MAX), counts);
+  BOOST_REQUIRE_EQUAL(counts.size(), referenceSet.n_cols);
+  for (size_t i = 0; i < counts.size(); ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], referenceSet.n_cols - 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
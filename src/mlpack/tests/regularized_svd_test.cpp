@@ -194,6 +194,53 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionGradient)
   }
 }
 
+/**
+ * Make sure that the sparse gradients of the individual examples sum to the
+ * full gradient.
+ */
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionSparseGradient)
+{
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t maxRating = 5;
+  const size_t rank = 10;
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data.row(2) = floor(data.row(2) * maxRating + 0.5);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+  RegularizedSVDFunction rSVDFunc(data, rank, 0.5);
+
+  arma::mat gradient;
+  rSVDFunc.Gradient(parameters, gradient);
+
+  arma::mat sumGradient = arma::zeros<arma::mat>(rank, numUsers + numItems);
+  arma::sp_mat sparseGradient;
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    rSVDFunc.Gradient(parameters, i, sparseGradient);
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, rank);
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, numUsers + numItems);
+    sumGradient += sparseGradient;
+  }
+
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (std::abs(gradient[i]) <= 1e-6)
+      BOOST_REQUIRE_SMALL(sumGradient[i], 1e-6);
+    else
+      BOOST_REQUIRE_CLOSE(sumGradient[i], gradient[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimize)
 {
   // Define useful constants.
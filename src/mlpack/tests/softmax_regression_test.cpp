@@ -172,6 +172,63 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
   }
 }
 
+/**
+ * Make sure that the separable objective and gradients are consistent with the
+ * full objective and gradient, and that the batch gradient is the sum of the
+ * gradients of the individual points.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSeparableGradient)
+{
+  const size_t points = 200;
+  const size_t inputSize = 10;
+  const size_t numClasses = 4;
+
+  arma::mat data;
+  data.randu(inputSize, points);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction srf(data, labels, numClasses, 0.5,
+        (intercept == 1));
+    BOOST_REQUIRE_EQUAL(srf.NumFunctions(), points);
+
+    arma::mat parameters;
+    parameters.randu(numClasses, inputSize + intercept);
+
+    // The full objective is the mean of the separable objectives.
+    double objective = 0.0;
+    for (size_t i = 0; i < points; ++i)
+      objective += srf.Evaluate(parameters, i);
+    BOOST_REQUIRE_CLOSE(objective / points, srf.Evaluate(parameters), 1e-5);
+
+    // The same holds for the gradients.
+    arma::mat gradient, batchGradient;
+    srf.Gradient(parameters, gradient);
+    srf.Gradient(parameters, 0, points, batchGradient);
+    BOOST_REQUIRE_EQUAL(batchGradient.n_rows, gradient.n_rows);
+    BOOST_REQUIRE_EQUAL(batchGradient.n_cols, gradient.n_cols);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(batchGradient[i] / points, gradient[i], 1e-5);
+
+    // A batch in the middle of the data.
+    arma::mat sumGradient = arma::zeros<arma::mat>(parameters.n_rows,
+        parameters.n_cols);
+    arma::mat pointGradient;
+    for (size_t i = 50; i < 80; ++i)
+    {
+      srf.Gradient(parameters, i, pointGradient);
+      sumGradient += pointGradient;
+    }
+    srf.Gradient(parameters, 50, 30, batchGradient);
+    for (size_t i = 0; i < sumGradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(batchGradient[i], sumGradient[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTwoClasses)
 {
   const size_t points = 1000;
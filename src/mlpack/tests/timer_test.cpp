@@ -90,4 +90,92 @@ BOOST_AUTO_TEST_CASE(TwiceStartTimerTest)
   BOOST_REQUIRE_THROW(Timer::Start("test_timer"), std::runtime_error);
 }
 
+/**
+ * Timers started by handle should have the same value as timers started by
+ * name, and nested scopes should each accumulate their own time.
+ */
+BOOST_AUTO_TEST_CASE(ScopedHandleTimerTest)
+{
+  const size_t outer = Timer::Register("test_outer_timer");
+  const size_t inner = Timer::Register("test_inner_timer");
+  BOOST_REQUIRE_EQUAL(Timer::Register("test_outer_timer"), outer);
+  BOOST_REQUIRE_NE(outer, inner);
+
+  {
+    TimerScope outerScope(outer);
+    for (size_t i = 0; i < 2; ++i)
+    {
+      TimerScope innerScope(inner);
+      #ifdef _WIN32
+      Sleep(20);
+      #else
+      usleep(20000);
+      #endif
+    }
+  }
+
+  BOOST_REQUIRE_GE(Timer::Get("test_inner_timer").count(), 40000);
+  BOOST_REQUIRE_GE(Timer::Get("test_outer_timer").count(),
+      Timer::Get("test_inner_timer").count());
+
+  // The handle refers to the same timer as the name.
+  Timer::Start("test_inner_timer");
+  BOOST_REQUIRE_THROW(Timer::Start(inner), std::runtime_error);
+  Timer::Stop(inner);
+  BOOST_REQUIRE_THROW(Timer::Stop("test_inner_timer"), std::runtime_error);
+}
+
+/**
+ * Each thread should be able to run the same timer, and the value of the timer
+ * should be the sum over all threads.
+ */
+BOOST_AUTO_TEST_CASE(MultithreadedTimerTest)
+{
+  const size_t handle = Timer::Register("test_parallel_timer");
+
+  #pragma omp parallel for num_threads(4)
+  for (int i = 0; i < 4; ++i)
+  {
+    TimerScope scope(handle);
+    #ifdef _WIN32
+    Sleep(20);
+    #else
+    usleep(20000);
+    #endif
+  }
+
+  BOOST_REQUIRE_GE(Timer::Get("test_parallel_timer").count(), 80000);
+}
+
+/**
+ * Make sure that a trace can be exported when tracing is enabled, and that it
+ * holds the recorded timers.
+ */
+BOOST_AUTO_TEST_CASE(TimerTraceExportTest)
+{
+  Timer::EnableTracing();
+  const size_t outer = Timer::Register("test_trace_outer");
+  {
+    TimerScope outerScope(outer);
+    TimerScope innerScope(Timer::Register("test_trace_inner"));
+  }
+  Timer::EnableTracing(false);
+
+  BOOST_REQUIRE(Timer::ExportTrace("test_timer_trace.json"));
+
+  std::ifstream stream("test_timer_trace.json");
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  const std::string trace = contents.str();
+
+  BOOST_REQUIRE_NE(trace.find("\"traceEvents\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.find("\"name\":\"test_trace_outer\""),
+      std::string::npos);
+  BOOST_REQUIRE_NE(trace.find("\"name\":\"test_trace_inner\""),
+      std::string::npos);
+  BOOST_REQUIRE_NE(trace.find("\"depth\":1"), std::string::npos);
+
+  remove("test_timer_trace.json");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1359,6 +1359,72 @@ BOOST_AUTO_TEST_CASE(KdTreeTest)
   TreeType root(dataset);
 }
 
+/**
+ * Build a kd-tree on a dataset large enough that the upper levels are split in
+ * parallel, and make sure that the tree is valid and identical to a tree built
+ * with a single thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKdTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(3, 120000, arma::fill::randu);
+  std::vector<size_t> oldFromNew;
+  std::vector<size_t> newFromOld;
+
+  TreeType root(dataset, oldFromNew, newFromOld);
+  const arma::mat& treeset = root.Dataset();
+
+  BOOST_REQUIRE_EQUAL(root.Count(), dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(treeset(j, i), dataset(j, oldFromNew[i]));
+      BOOST_REQUIRE_EQUAL(treeset(j, newFromOld[i]), dataset(j, i));
+    }
+  }
+
+  BOOST_REQUIRE(CheckPointBounds(root));
+
+#ifdef HAS_OPENMP
+  // Now build the same tree with one thread only.
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialRoot(dataset, serialOldFromNew);
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE(oldFromNew == serialOldFromNew);
+
+  std::stack<TreeType*> nodes, serialNodes;
+  nodes.push(&root);
+  serialNodes.push(&serialRoot);
+  while (!nodes.empty())
+  {
+    TreeType* node = nodes.top();
+    TreeType* serialNode = serialNodes.top();
+    nodes.pop();
+    serialNodes.pop();
+
+    BOOST_REQUIRE_EQUAL(node->Begin(), serialNode->Begin());
+    BOOST_REQUIRE_EQUAL(node->Count(), serialNode->Count());
+    BOOST_REQUIRE_EQUAL(node->NumChildren(), serialNode->NumChildren());
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+    {
+      BOOST_REQUIRE_EQUAL(node->Bound()[d].Lo(), serialNode->Bound()[d].Lo());
+      BOOST_REQUIRE_EQUAL(node->Bound()[d].Hi(), serialNode->Bound()[d].Hi());
+    }
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+    {
+      nodes.push(&node->Child(i));
+      serialNodes.push(&serialNode->Child(i));
+    }
+  }
+#endif
+}
+
 BOOST_AUTO_TEST_CASE(MaxRPTreeTest)
 {
   typedef MaxRPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
@@ -1767,6 +1833,40 @@ BOOST_AUTO_TEST_CASE(ExhaustiveSparseKDTreeTest)
   TreeType root(dataset);
 }
 
+/**
+ * Build a sparse kd-tree on a dataset larger than the parallel build threshold
+ * and make sure that it is valid; sparse trees must be built serially.
+ */
+BOOST_AUTO_TEST_CASE(LargeSparseKDTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::SpMat<double>>
+      TreeType;
+
+  BOOST_REQUIRE(!SplitTraits<MidpointSplit<HRectBound<EuclideanDistance>,
+      arma::SpMat<double>>>::ThreadSafe);
+
+  arma::SpMat<double> dataset;
+  dataset.sprandu(4, 3000, 0.2);
+
+  std::vector<size_t> newToOld;
+  std::vector<size_t> oldToNew;
+  TreeType root(dataset, newToOld, oldToNew);
+  const arma::sp_mat& treeset = root.Dataset();
+
+  BOOST_REQUIRE_EQUAL(root.Count(), dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(treeset.n_nonzero, dataset.n_nonzero);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(treeset(j, i), dataset(j, newToOld[i]));
+      BOOST_REQUIRE_EQUAL(treeset(j, oldToNew[i]), dataset(j, i));
+    }
+  }
+
+  BOOST_REQUIRE(CheckPointBounds(root));
+}
+
 BOOST_AUTO_TEST_CASE(BinarySpaceTreeMoveConstructorTest)
 {
   arma::mat dataset(5, 1000);
@@ -2,7 +2,7 @@
  * @file union_find_test.cpp
  * @author Bill March (march@gatech.edu)
  *
- * Unit tests for the Union-Find data structure.
+ * Unit tests for the Union-Find data structures.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,88 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+BOOST_AUTO_TEST_CASE(TestConcurrentFind)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; i++)
+    BOOST_REQUIRE(testUnionFind.Find(i) == i);
+
+  BOOST_REQUIRE(testUnionFind.Union(0, 1));
+  BOOST_REQUIRE(testUnionFind.Union(1, 2));
+
+  BOOST_REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(0));
+
+  // The component is named after its smallest point.
+  BOOST_REQUIRE(testUnionFind.Find(2) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  BOOST_REQUIRE(testUnionFind.Union(0, 1));
+  BOOST_REQUIRE(testUnionFind.Union(2, 3));
+  BOOST_REQUIRE(testUnionFind.Union(0, 2));
+  BOOST_REQUIRE(testUnionFind.Union(5, 0));
+  BOOST_REQUIRE(testUnionFind.Union(0, 6));
+
+  // These are already in the same component.
+  BOOST_REQUIRE(!testUnionFind.Union(3, 1));
+  BOOST_REQUIRE(!testUnionFind.Union(6, 5));
+
+  BOOST_REQUIRE(testUnionFind.Find(0) == testUnionFind.Find(1));
+  BOOST_REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
+  BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
+  BOOST_REQUIRE(testUnionFind.Find(4) == 4);
+}
+
+/**
+ * Join random pairs of points from many threads at once, and make sure that
+ * the components are the same as those of the serial union-find, and that
+ * exactly one successful union happened for each merge.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentParallelUnion)
+{
+  static const size_t testSize = 5000;
+  static const size_t numPairs = 3000;
+
+  arma::Mat<size_t> pairs = arma::randi<arma::Mat<size_t>>(2, numPairs,
+      arma::distr_param(0, testSize - 1));
+
+  UnionFind serialUnionFind(testSize);
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < numPairs; ++i)
+    serialUnionFind.Union(pairs(0, i), pairs(1, i));
+
+  size_t unions = 0;
+  #pragma omp parallel for reduction(+:unions)
+  for (intmax_t i = 0; i < (intmax_t) numPairs; ++i)
+    if (testUnionFind.Union(pairs(0, i), pairs(1, i)))
+      ++unions;
+
+  // Every successful union removes one component.
+  size_t components = 0;
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    if (testUnionFind.Find(i) == i)
+      ++components;
+
+    for (size_t j = i + 1; j < testSize; j += 97)
+    {
+      BOOST_REQUIRE_EQUAL(serialUnionFind.Find(i) == serialUnionFind.Find(j),
+          testUnionFind.Find(i) == testUnionFind.Find(j));
+    }
+  }
+  BOOST_REQUIRE_EQUAL(components + unions, testSize);
+
+  // The root of each component is its smallest point.
+  for (size_t i = 0; i < testSize; ++i)
+    BOOST_REQUIRE_LE(testUnionFind.Find(i), i);
+}
+
 BOOST_AUTO_TEST_SUITE_END();